@@ -32,6 +32,50 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
     } \
   } while (FALSE)
 
+//
+// File images written by PutFileImage() while the cache is enabled
+//
+typedef struct _FILE_IMAGE_ENTRY {
+  struct _FILE_IMAGE_ENTRY  *Next;
+  CHAR8                     *FileName;
+  CHAR8                     *FileImage;
+  UINT32                    FileSize;
+} FILE_IMAGE_ENTRY;
+
+STATIC BOOLEAN           mFileImageCacheEnabled = FALSE;
+STATIC FILE_IMAGE_ENTRY  *mFileImageCache       = NULL;
+
+STATIC
+FILE_IMAGE_ENTRY *
+FindFileImage (
+  IN CHAR8    *FileName
+  )
+/*++
+
+Routine Description:
+
+  Look up a file image in the file image cache.
+
+Arguments:
+
+  FileName           The name of the file.
+
+Returns:
+
+  The cache entry, or NULL if the file is not cached.
+
+--*/
+{
+  FILE_IMAGE_ENTRY  *Entry;
+
+  for (Entry = mFileImageCache; Entry != NULL; Entry = Entry->Next) {
+    if (strcmp (Entry->FileName, FileName) == 0) {
+      return Entry;
+    }
+  }
+  return NULL;
+}
+
 VOID
 PeiZeroMem (
   IN VOID   *Buffer,
@@ -187,8 +231,9 @@ Returns:
 
 --*/
 {
-  FILE    *InputFile;
-  UINT32  FileSize;
+  FILE              *InputFile;
+  UINT32            FileSize;
+  FILE_IMAGE_ENTRY  *Entry;
 
   //
   // Verify input parameters.
@@ -197,6 +242,19 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
   //
+  // Use the image generated by a previous tool if it is cached.
+  //
+  Entry = FindFileImage (InputFileName);
+  if (Entry != NULL) {
+    *InputFileImage = malloc (Entry->FileSize + 1);
+    if (*InputFileImage == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    memcpy (*InputFileImage, Entry->FileImage, Entry->FileSize);
+    *BytesRead = Entry->FileSize;
+    return EFI_SUCCESS;
+  }
+  //
   // Open the file and copy contents into a memory buffer.
   //
   //
@@ -227,7 +285,7 @@ Returns:
   //
   // Allocate a buffer
   //
-  *InputFileImage = malloc (FileSize);
+  *InputFileImage = malloc (FileSize + 1);
   if (*InputFileImage == NULL) {
     fclose (InputFile);
     return EFI_OUT_OF_RESOURCES;
@@ -288,8 +346,10 @@ Returns:
 
 --*/
 {
-  FILE    *OutputFile;
-  UINT32  BytesWrote;
+  FILE              *OutputFile;
+  UINT32            BytesWrote;
+  FILE_IMAGE_ENTRY  *Entry;
+  CHAR8             *FileImage;
 
   //
   // Verify input parameters.
@@ -298,6 +358,36 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
   //
+  // Also keep the image in memory for the next tool if the cache is enabled.
+  //
+  if (mFileImageCacheEnabled) {
+    FileImage = malloc (BytesToWrite + 1);
+    if (FileImage == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    memcpy (FileImage, OutputFileImage, BytesToWrite);
+    Entry = FindFileImage (OutputFileName);
+    if (Entry == NULL) {
+      Entry = malloc (sizeof (FILE_IMAGE_ENTRY));
+      if (Entry == NULL) {
+        free (FileImage);
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Entry->FileName = strdup (OutputFileName);
+      if (Entry->FileName == NULL) {
+        free (Entry);
+        free (FileImage);
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Entry->Next     = mFileImageCache;
+      mFileImageCache = Entry;
+    } else {
+      free (Entry->FileImage);
+    }
+    Entry->FileImage = FileImage;
+    Entry->FileSize  = BytesToWrite;
+  }
+  //
   // Open the file and copy contents into a memory buffer.
   //
   //
@@ -326,6 +416,53 @@ Returns:
   return EFI_SUCCESS;
 }
 
+VOID
+SetFileImageCache (
+  IN BOOLEAN  Enable
+  )
+/*++
+
+Routine Description:
+
+  Enable or disable the file image cache used by GetFileImage() and
+  PutFileImage(). Disabling the cache does not free the cached images.
+
+Arguments:
+
+  Enable             TRUE to cache output file images.
+
+--*/
+{
+  mFileImageCacheEnabled = Enable;
+}
+
+VOID
+FreeFileImageCache (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Free all cached file images.
+
+Arguments:
+
+  None
+
+--*/
+{
+  FILE_IMAGE_ENTRY  *Entry;
+
+  while (mFileImageCache != NULL) {
+    Entry           = mFileImageCache;
+    mFileImageCache = Entry->Next;
+    free (Entry->FileName);
+    free (Entry->FileImage);
+    free (Entry);
+  }
+}
+
 UINT8
 CalculateChecksum8 (
   IN UINT8        *Buffer,
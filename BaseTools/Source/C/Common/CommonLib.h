@@ -121,6 +121,44 @@ Returns:
 
 **/
 
+VOID
+SetFileImageCache (
+  IN BOOLEAN  Enable
+  )
+;
+/*++
+
+Routine Description:
+
+  Enable or disable the file image cache. While it is enabled, PutFileImage()
+  also keeps a copy of each file it writes, and GetFileImage() returns the
+  cached copy instead of reading the file again. This lets tools run back to
+  back in one process without reading their intermediate files from disk.
+  Disabling the cache does not free the cached images.
+
+Arguments:
+
+  Enable             TRUE to cache output file images.
+
+**/
+
+VOID
+FreeFileImageCache (
+  VOID
+  )
+;
+/*++
+
+Routine Description:
+
+  Free all cached file images.
+
+Arguments:
+
+  None
+
+**/
+
 UINT8
 CalculateChecksum8 (
   IN UINT8        *Buffer,
@@ -31,11 +31,13 @@ typedef INT16             NODE;
 #define WNDBIT            13
 #define WNDSIZ            (1U << WNDBIT)
 #define MAXMATCH          256
-#define PERC_FLAG         0x8000U
 #define CODE_BIT          16
-#define NIL               0
-#define MAX_HASH_VAL      (3 * WNDSIZ + (WNDSIZ / 512 + 1) * UINT8_MAX)
-#define HASH(p, c)        ((p) + ((c) << (WNDBIT - 9)) + WNDSIZ * 2)
+#define NIL               (-1)
+#define HASH_BIT          15
+#define HASH_SIZE         (1U << HASH_BIT)
+#define HASH(p)           ((((UINT32)mText[p] | ((UINT32)mText[(p) + 1] << 8) | \
+                            ((UINT32)mText[(p) + 2] << 16)) * 2654435761U) >> (32 - HASH_BIT))
+#define MAX_CHAIN         256
 #define CRCPOLY           0xA001
 #define UPDATE_CRC(c)     mCrc = mCrcTable[(mCrc ^ (c)) & 0xFF] ^ (mCrc >> UINT8_BIT)
 
@@ -80,40 +82,20 @@ VOID
 InitSlide (
   );
 
-STATIC 
-NODE 
-Child (
-  IN NODE q, 
-  IN UINT8 c
-  );
-
-STATIC 
-VOID 
-MakeChild (
-  IN NODE q, 
-  IN UINT8 c, 
-  IN NODE r
-  );
-  
-STATIC 
-VOID 
-Split (
-  IN NODE Old
-  );
-
 STATIC 
 VOID 
 InsertNode (
   );
-  
+
 STATIC 
 VOID 
-DeleteNode (
+FindMatch (
   );
 
 STATIC 
 VOID 
 GetNextMatch (
+  IN BOOLEAN Search
   );
   
 STATIC 
@@ -239,7 +221,7 @@ MakeTree (
 
 STATIC UINT8  *mSrc, *mDst, *mSrcUpperLimit, *mDstUpperLimit;
 
-STATIC UINT8  *mLevel, *mText, *mChildCount, *mBuf, mCLen[NC], mPTLen[NPT], *mLen;
+STATIC UINT8  *mText, *mBuf, mCLen[NC], mPTLen[NPT], *mLen;
 STATIC INT16  mHeap[NC + 1];
 STATIC INT32  mRemainder, mMatchLen, mBitCount, mHeapSize, mN;
 STATIC UINT32 mBufSiz = 0, mOutputPos, mOutputMask, mSubBitBuf, mCrc;
@@ -249,7 +231,7 @@ STATIC UINT16 *mFreq, *mSortPtr, mLenCnt[17], mLeft[2 * NC - 1], mRight[2 * NC -
               mCrcTable[UINT8_MAX + 1], mCFreq[2 * NC - 1],mCCode[NC],
               mPFreq[2 * NP - 1], mPTCode[NPT], mTFreq[2 * NT - 1];
 
-STATIC NODE   mPos, mMatchPos, mAvail, *mPosition, *mParent, *mPrev, *mNext = NULL;
+STATIC NODE   mPos, mMatchPos, *mHead, *mPrev = NULL;
 
 
 //
@@ -293,12 +275,8 @@ Returns:
   mBufSiz = 0;
   mBuf = NULL;
   mText       = NULL;
-  mLevel      = NULL;
-  mChildCount = NULL;
-  mPosition   = NULL;
-  mParent     = NULL;
+  mHead       = NULL;
   mPrev       = NULL;
-  mNext       = NULL;
 
   
   mSrc = SrcBuffer;
@@ -415,14 +393,9 @@ Returns:
     mText[i] = 0;
   }
 
-  mLevel      = malloc ((WNDSIZ + UINT8_MAX + 1) * sizeof(*mLevel));
-  mChildCount = malloc ((WNDSIZ + UINT8_MAX + 1) * sizeof(*mChildCount));
-  mPosition   = malloc ((WNDSIZ + UINT8_MAX + 1) * sizeof(*mPosition));
-  mParent     = malloc (WNDSIZ * 2 * sizeof(*mParent));
-  mPrev       = malloc (WNDSIZ * 2 * sizeof(*mPrev));
-  mNext       = malloc ((MAX_HASH_VAL + 1) * sizeof(*mNext));
-  if (mLevel == NULL || mChildCount == NULL || mPosition == NULL ||
-    mParent == NULL || mPrev == NULL || mNext == NULL) {
+  mHead       = malloc (HASH_SIZE * sizeof(*mHead));
+  mPrev       = malloc (WNDSIZ * sizeof(*mPrev));
+  if (mHead == NULL || mPrev == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
   
@@ -456,30 +429,14 @@ Returns: (VOID)
     free (mText);
   }
   
-  if (mLevel) {
-    free (mLevel);
-  }
-  
-  if (mChildCount) {
-    free (mChildCount);
-  }
-  
-  if (mPosition) {
-    free (mPosition);
-  }
-  
-  if (mParent) {
-    free (mParent);
+  if (mHead) {
+    free (mHead);
   }
   
   if (mPrev) {
     free (mPrev);
   }
   
-  if (mNext) {
-    free (mNext);
-  }
-  
   if (mBuf) {
     free (mBuf);
   }  
@@ -503,131 +460,11 @@ Returns: (VOID)
 
 --*/
 {
-  NODE i;
-
-  for (i = WNDSIZ; i <= WNDSIZ + UINT8_MAX; i++) {
-    mLevel[i] = 1;
-    mPosition[i] = NIL;  /* sentinel */
-  }
-  for (i = WNDSIZ; i < WNDSIZ * 2; i++) {
-    mParent[i] = NIL;
-  }  
-  mAvail = 1;
-  for (i = 1; i < WNDSIZ - 1; i++) {
-    mNext[i] = (NODE)(i + 1);
-  }
-  
-  mNext[WNDSIZ - 1] = NIL;
-  for (i = WNDSIZ * 2; i <= MAX_HASH_VAL; i++) {
-    mNext[i] = NIL;
-  }  
-}
-
-
-STATIC 
-NODE 
-Child (
-  IN NODE q, 
-  IN UINT8 c
-  )
-/*++
-
-Routine Description:
+  UINT32 i;
 
-  Find child node given the parent node and the edge character
-  
-Arguments:
-
-  q       - the parent node
-  c       - the edge character
-  
-Returns:
-
-  The child node (NIL if not found)  
-  
---*/
-{
-  NODE r;
-  
-  r = mNext[HASH(q, c)];
-  mParent[NIL] = q;  /* sentinel */
-  while (mParent[r] != q) {
-    r = mNext[r];
+  for (i = 0; i < HASH_SIZE; i++) {
+    mHead[i] = NIL;
   }
-  
-  return r;
-}
-
-STATIC 
-VOID 
-MakeChild (
-  IN NODE q, 
-  IN UINT8 c, 
-  IN NODE r
-  )
-/*++
-
-Routine Description:
-
-  Create a new child for a given parent node.
-  
-Arguments:
-
-  q       - the parent node
-  c       - the edge character
-  r       - the child node
-  
-Returns: (VOID)
-
---*/
-{
-  NODE h, t;
-  
-  h = (NODE)HASH(q, c);
-  t = mNext[h];
-  mNext[h] = r;
-  mNext[r] = t;
-  mPrev[t] = r;
-  mPrev[r] = h;
-  mParent[r] = q;
-  mChildCount[q]++;
-}
-
-STATIC 
-VOID 
-Split (
-  NODE Old
-  )
-/*++
-
-Routine Description:
-
-  Split a node.
-  
-Arguments:
-
-  Old     - the node to split
-  
-Returns: (VOID)
-
---*/
-{
-  NODE New, t;
-
-  New = mAvail;
-  mAvail = mNext[New];
-  mChildCount[New] = 0;
-  t = mPrev[Old];
-  mPrev[New] = t;
-  mNext[t] = New;
-  t = mNext[Old];
-  mNext[New] = t;
-  mPrev[t] = New;
-  mParent[New] = mParent[Old];
-  mLevel[New] = (UINT8)mMatchLen;
-  mPosition[New] = mPos;
-  MakeChild(New, mText[mMatchPos + mMatchLen], Old);
-  MakeChild(New, mText[mPos + mMatchLen], mPos);
 }
 
 STATIC 
@@ -637,7 +474,10 @@ InsertNode ()
 
 Routine Description:
 
-  Insert string info for current position into the String Info Log
+  Insert string info for current position into the String Info Log.
+  Positions sharing the hash of their first three bytes are chained
+  newest first through mPrev, which is indexed modulo the window size
+  so entries that slide out of the window are overwritten in place.
   
 Arguments: (VOID)
 
@@ -645,115 +485,23 @@ Returns: (VOID)
 
 --*/
 {
-  NODE q, r, j, t;
-  UINT8 c, *t1, *t2;
+  UINT32 h;
 
-  if (mMatchLen >= 4) {
-    
-    //
-    // We have just got a long match, the target tree
-    // can be located by MatchPos + 1. Travese the tree
-    // from bottom up to get to a proper starting point.
-    // The usage of PERC_FLAG ensures proper node deletion
-    // in DeleteNode() later.
-    //
-    
-    mMatchLen--;
-    r = (INT16)((mMatchPos + 1) | WNDSIZ);
-    while ((q = mParent[r]) == NIL) {
-      r = mNext[r];
-    }
-    while (mLevel[q] >= mMatchLen) {
-      r = q;  q = mParent[q];
-    }
-    t = q;
-    while (mPosition[t] < 0) {
-      mPosition[t] = mPos;
-      t = mParent[t];
-    }
-    if (t < WNDSIZ) {
-      mPosition[t] = (NODE)(mPos | PERC_FLAG);
-    }    
-  } else {
-    
-    //
-    // Locate the target tree
-    //
-    
-    q = (INT16)(mText[mPos] + WNDSIZ);
-    c = mText[mPos + 1];
-    if ((r = Child(q, c)) == NIL) {
-      MakeChild(q, c, mPos);
-      mMatchLen = 1;
-      return;
-    }
-    mMatchLen = 2;
-  }
-  
-  //
-  // Traverse down the tree to find a match.
-  // Update Position value along the route.
-  // Node split or creation is involved.
-  //
-  
-  for ( ; ; ) {
-    if (r >= WNDSIZ) {
-      j = MAXMATCH;
-      mMatchPos = r;
-    } else {
-      j = mLevel[r];
-      mMatchPos = (NODE)(mPosition[r] & ~PERC_FLAG);
-    }
-    if (mMatchPos >= mPos) {
-      mMatchPos -= WNDSIZ;
-    }    
-    t1 = &mText[mPos + mMatchLen];
-    t2 = &mText[mMatchPos + mMatchLen];
-    while (mMatchLen < j) {
-      if (*t1 != *t2) {
-        Split(r);
-        return;
-      }
-      mMatchLen++;
-      t1++;
-      t2++;
-    }
-    if (mMatchLen >= MAXMATCH) {
-      break;
-    }
-    mPosition[r] = mPos;
-    q = r;
-    if ((r = Child(q, *t1)) == NIL) {
-      MakeChild(q, *t1, mPos);
-      return;
-    }
-    mMatchLen++;
-  }
-  t = mPrev[r];
-  mPrev[mPos] = t;
-  mNext[t] = mPos;
-  t = mNext[r];
-  mNext[mPos] = t;
-  mPrev[t] = mPos;
-  mParent[mPos] = q;
-  mParent[r] = NIL;
-  
-  //
-  // Special usage of 'next'
-  //
-  mNext[r] = mPos;
-  
+  h = HASH(mPos);
+  mPrev[mPos & (WNDSIZ - 1)] = mHead[h];
+  mHead[h] = mPos;
 }
 
 STATIC 
 VOID 
-DeleteNode ()
+FindMatch ()
 /*++
 
 Routine Description:
 
-  Delete outdated string info. (The Usage of PERC_FLAG
-  ensures a clean deletion)
+  Find the longest match for the current position by walking at most
+  MAX_CHAIN entries of its hash chain. Ties keep the nearest position
+  since it yields the shortest position code.
   
 Arguments: (VOID)
 
@@ -761,81 +509,54 @@ Returns: (VOID)
 
 --*/
 {
-  NODE q, r, s, t, u;
+  NODE  r;
+  INT32 Limit, Chain, Len;
+  UINT8 *t1, *t2;
 
-  if (mParent[mPos] == NIL) {
-    return;
-  }
-  
-  r = mPrev[mPos];
-  s = mNext[mPos];
-  mNext[r] = s;
-  mPrev[s] = r;
-  r = mParent[mPos];
-  mParent[mPos] = NIL;
-  if (r >= WNDSIZ || --mChildCount[r] > 1) {
-    return;
-  }
-  t = (NODE)(mPosition[r] & ~PERC_FLAG);
-  if (t >= mPos) {
-    t -= WNDSIZ;
-  }
-  s = t;
-  q = mParent[r];
-  while ((u = mPosition[q]) & PERC_FLAG) {
-    u &= ~PERC_FLAG;
-    if (u >= mPos) {
-      u -= WNDSIZ;
-    }
-    if (u > s) {
-      s = u;
-    }
-    mPosition[q] = (INT16)(s | WNDSIZ);
-    q = mParent[q];
-  }
-  if (q < WNDSIZ) {
-    if (u >= mPos) {
-      u -= WNDSIZ;
-    }
-    if (u > s) {
-      s = u;
+  mMatchLen = 0;
+  Limit = mPos - WNDSIZ;
+  r = mHead[HASH(mPos)];
+  for (Chain = MAX_CHAIN; r > Limit && Chain > 0; Chain--) {
+    t1 = &mText[mPos];
+    t2 = &mText[r];
+    if (t2[mMatchLen] == t1[mMatchLen] && t2[0] == t1[0] && t2[1] == t1[1]) {
+      for (Len = 2; Len < MAXMATCH && t1[Len] == t2[Len]; Len++) {
+      }
+      if (Len > mMatchLen) {
+        mMatchLen = Len;
+        mMatchPos = r;
+        if (Len >= MAXMATCH) {
+          break;
+        }
+      }
     }
-    mPosition[q] = (INT16)(s | WNDSIZ | PERC_FLAG);
+    r = mPrev[r & (WNDSIZ - 1)];
   }
-  s = Child(r, mText[t + mLevel[r]]);
-  t = mPrev[s];
-  u = mNext[s];
-  mNext[t] = u;
-  mPrev[u] = t;
-  t = mPrev[r];
-  mNext[t] = s;
-  mPrev[s] = t;
-  t = mNext[r];
-  mPrev[t] = s;
-  mNext[s] = t;
-  mParent[s] = mParent[r];
-  mParent[r] = NIL;
-  mNext[r] = mAvail;
-  mAvail = r;
 }
 
 STATIC 
 VOID 
-GetNextMatch ()
+GetNextMatch (
+  IN BOOLEAN Search
+  )
 /*++
 
 Routine Description:
 
   Advance the current position (read in new data if needed).
-  Delete outdated string info. Find a match string for current position.
+  Find a match string for current position and log it.
 
-Arguments: (VOID)
+Arguments:
+
+  Search  - FALSE to only log the position, used while skipping over
+            a string that has already been output as a pointer
 
 Returns: (VOID)
 
 --*/
 {
   INT32 n;
+  UINT32 i;
 
   mRemainder--;
   if (++mPos == WNDSIZ * 2) {
@@ -843,8 +564,20 @@ Returns: (VOID)
     n = FreadCrc(&mText[WNDSIZ + MAXMATCH], WNDSIZ);
     mRemainder += n;
     mPos = WNDSIZ;
+
+    //
+    // Rebase the logged positions along with the text
+    //
+    for (i = 0; i < HASH_SIZE; i++) {
+      mHead[i] = (NODE)(mHead[i] >= (NODE)WNDSIZ ? mHead[i] - WNDSIZ : NIL);
+    }
+    for (i = 0; i < WNDSIZ; i++) {
+      mPrev[i] = (NODE)(mPrev[i] >= (NODE)WNDSIZ ? mPrev[i] - WNDSIZ : NIL);
+    }
+  }
+  if (Search) {
+    FindMatch();
   }
-  DeleteNode();
   InsertNode();
 }
 
@@ -884,6 +617,7 @@ Returns:
   
   mMatchLen = 0;
   mPos = WNDSIZ;
+  FindMatch();
   InsertNode();
   if (mMatchLen > mRemainder) {
     mMatchLen = mRemainder;
@@ -891,7 +625,7 @@ Returns:
   while (mRemainder > 0) {
     LastMatchLen = mMatchLen;
     LastMatchPos = mMatchPos;
-    GetNextMatch();
+    GetNextMatch(TRUE);
     if (mMatchLen > mRemainder) {
       mMatchLen = mRemainder;
     }
@@ -912,9 +646,10 @@ Returns:
       
       Output(LastMatchLen + (UINT8_MAX + 1 - THRESHOLD),
              (mPos - LastMatchPos - 2) & (WNDSIZ - 1));
-      while (--LastMatchLen > 0) {
-        GetNextMatch();
+      while (--LastMatchLen > 1) {
+        GetNextMatch(FALSE);
       }
+      GetNextMatch(TRUE);
       if (mMatchLen > mRemainder) {
         mMatchLen = mRemainder;
       }
@@ -642,6 +642,36 @@ Returns:
   return mStatus;
 }
 
+VOID
+ResetUtilityStatus (
+  VOID
+  )
+/*++
+
+Routine Description:
+  Clear the worst-case status, the error and warning counts and the print
+  level. Used when several utilities run one after another in one process.
+
+Arguments:
+  None.
+
+Returns:
+  NA
+
+--*/
+{
+  mStatus                = STATUS_SUCCESS;
+  mPrintLogLevel         = INFO_LOG_LEVEL;
+  mSourceFileName        = NULL;
+  mSourceFileLineNum     = 0;
+  mErrorCount            = 0;
+  mWarningCount          = 0;
+  mMaxErrors             = 0;
+  mMaxWarnings           = 0;
+  mMaxWarningsPlusErrors = 0;
+  mPrintLimitsSet        = 0;
+}
+
 VOID
 SetPrintLevel (
   UINT64  LogLevel
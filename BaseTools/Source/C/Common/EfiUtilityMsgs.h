@@ -52,6 +52,15 @@ GetUtilityStatus (
   VOID
   );
 
+//
+// Clear the worst-case status, the error and warning counts and the print
+// level, so that another utility can run in the same process.
+//
+VOID
+ResetUtilityStatus (
+  VOID
+  );
+
 //
 // If someone prints an error message and didn't specify a source file name,
 // then we print the utility name instead. However they must tell us the
@@ -30,11 +30,16 @@ typedef INT32 NODE;
 #define WNDSIZ        (1U << WNDBIT)
 #define MAXMATCH      256
 #define BLKSIZ        (1U << 14)  // 16 * 1024U
-#define PERC_FLAG     0x80000000U
 #define CODE_BIT      16
-#define NIL           0
-#define MAX_HASH_VAL  (3 * WNDSIZ + (WNDSIZ / 512 + 1) * UINT8_MAX)
-#define HASH(p, c)    ((p) + ((c) << (WNDBIT - 9)) + WNDSIZ * 2)
+#define NIL           (-1)
+#define HASH_BIT      17
+#define HASH_SIZE     (1U << HASH_BIT)
+#define READ24(p)     ((UINT32) mText[p] | ((UINT32) mText[(p) + 1] << 8) | ((UINT32) mText[(p) + 2] << 16))
+#define READ32(p)     (READ24 (p) | ((UINT32) mText[(p) + 3] << 24))
+#define HASH(p)       ((READ24 (p) * 2654435761U) >> (32 - HASH_BIT))
+#define LONG_HASH(p)  (((READ32 (p) * 2654435761U) ^ (READ32 ((p) + 4) * 2246822519U)) >> (32 - HASH_BIT))
+#define MAX_CHAIN     64
+#define MAX_LONG_CHAIN 16
 #define CRCPOLY       0xA001
 #define UPDATE_CRC(c) mCrc = mCrcTable[(mCrc ^ (c)) & 0xFF] ^ (mCrc >> UINT8_BIT)
 
@@ -80,43 +85,37 @@ InitSlide (
   VOID
   );
 
-STATIC
-NODE
-Child (
-  IN NODE   NodeQ,
-  IN UINT8  CharC
-  );
-
 STATIC
 VOID
-MakeChild (
-  IN NODE  NodeQ,
-  IN UINT8 CharC,
-  IN NODE  NodeR
+InsertNode (
+  VOID
   );
 
 STATIC
 VOID
-Split (
-  IN NODE Old
+SearchChain (
+  IN NODE   NodeR,
+  IN NODE   *Prev,
+  IN INT32  Chain
   );
 
 STATIC
 VOID
-InsertNode (
+FindMatch (
   VOID
   );
 
 STATIC
 VOID
-DeleteNode (
-  VOID
+RebaseChain (
+  IN OUT NODE   *Table,
+  IN     UINT32 Size
   );
 
 STATIC
 VOID
 GetNextMatch (
-  VOID
+  IN BOOLEAN Search
   );
 
 STATIC
@@ -248,7 +247,7 @@ MakeTree (
 //
 STATIC UINT8  *mSrc, *mDst, *mSrcUpperLimit, *mDstUpperLimit;
 
-STATIC UINT8  *mLevel, *mText, *mChildCount, *mBuf, mCLen[NC], mPTLen[NPT], *mLen;
+STATIC UINT8  *mText, *mBuf, mCLen[NC], mPTLen[NPT], *mLen;
 STATIC INT16  mHeap[NC + 1];
 STATIC INT32  mRemainder, mMatchLen, mBitCount, mHeapSize, mN;
 STATIC UINT32 mBufSiz = 0, mOutputPos, mOutputMask, mSubBitBuf, mCrc;
@@ -257,7 +256,7 @@ STATIC UINT32 mCompSize, mOrigSize;
 STATIC UINT16 *mFreq, *mSortPtr, mLenCnt[17], mLeft[2 * NC - 1], mRight[2 * NC - 1], mCrcTable[UINT8_MAX + 1],
   mCFreq[2 * NC - 1], mCCode[NC], mPFreq[2 * NP - 1], mPTCode[NPT], mTFreq[2 * NT - 1];
 
-STATIC NODE   mPos, mMatchPos, mAvail, *mPosition, *mParent, *mPrev, *mNext = NULL;
+STATIC NODE   mPos, mMatchPos, *mHead, *mPrev, *mLongHead, *mLongPrev = NULL;
 
 //
 // functions
@@ -304,12 +303,10 @@ Returns:
   mBufSiz         = 0;
   mBuf            = NULL;
   mText           = NULL;
-  mLevel          = NULL;
-  mChildCount     = NULL;
-  mPosition       = NULL;
-  mParent         = NULL;
+  mHead           = NULL;
   mPrev           = NULL;
-  mNext           = NULL;
+  mLongHead       = NULL;
+  mLongPrev       = NULL;
 
   mSrc            = SrcBuffer;
   mSrcUpperLimit  = mSrc + SrcSize;
@@ -424,14 +421,11 @@ Returns:
     mText[Index] = 0;
   }
 
-  mLevel      = malloc ((WNDSIZ + UINT8_MAX + 1) * sizeof (*mLevel));
-  mChildCount = malloc ((WNDSIZ + UINT8_MAX + 1) * sizeof (*mChildCount));
-  mPosition   = malloc ((WNDSIZ + UINT8_MAX + 1) * sizeof (*mPosition));
-  mParent     = malloc (WNDSIZ * 2 * sizeof (*mParent));
-  mPrev       = malloc (WNDSIZ * 2 * sizeof (*mPrev));
-  mNext       = malloc ((MAX_HASH_VAL + 1) * sizeof (*mNext));
-  if (mLevel == NULL || mChildCount == NULL || mPosition == NULL ||
-    mParent == NULL || mPrev == NULL || mNext == NULL) {
+  mHead       = malloc (HASH_SIZE * sizeof (*mHead));
+  mPrev       = malloc (WNDSIZ * sizeof (*mPrev));
+  mLongHead   = malloc (HASH_SIZE * sizeof (*mLongHead));
+  mLongPrev   = malloc (WNDSIZ * sizeof (*mLongPrev));
+  if (mHead == NULL || mPrev == NULL || mLongHead == NULL || mLongPrev == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -471,28 +465,20 @@ Returns: (VOID)
     free (mText);
   }
 
-  if (mLevel != NULL) {
-    free (mLevel);
-  }
-
-  if (mChildCount != NULL) {
-    free (mChildCount);
-  }
-
-  if (mPosition != NULL) {
-    free (mPosition);
-  }
-
-  if (mParent != NULL) {
-    free (mParent);
+  if (mHead != NULL) {
+    free (mHead);
   }
 
   if (mPrev != NULL) {
     free (mPrev);
   }
 
-  if (mNext != NULL) {
-    free (mNext);
+  if (mLongHead != NULL) {
+    free (mLongHead);
+  }
+
+  if (mLongPrev != NULL) {
+    free (mLongPrev);
   }
 
   if (mBuf != NULL) {
@@ -519,149 +505,107 @@ Returns: (VOID)
 
 --*/
 {
-  NODE  Index;
-
-  for (Index = WNDSIZ; Index <= WNDSIZ + UINT8_MAX; Index++) {
-    mLevel[Index]     = 1;
-    mPosition[Index]  = NIL;  /* sentinel */
-  }
-
-  for (Index = WNDSIZ; Index < WNDSIZ * 2; Index++) {
-    mParent[Index] = NIL;
-  }
-
-  mAvail = 1;
-  for (Index = 1; Index < WNDSIZ - 1; Index++) {
-    mNext[Index] = (NODE) (Index + 1);
-  }
+  UINT32  Index;
 
-  mNext[WNDSIZ - 1] = NIL;
-  for (Index = WNDSIZ * 2; Index <= MAX_HASH_VAL; Index++) {
-    mNext[Index] = NIL;
+  for (Index = 0; Index < HASH_SIZE; Index++) {
+    mHead[Index]      = NIL;
+    mLongHead[Index]  = NIL;
   }
 }
 
 STATIC
-NODE
-Child (
-  IN NODE  NodeQ,
-  IN UINT8 CharC
+VOID
+InsertNode (
+  VOID
   )
 /*++
 
 Routine Description:
 
-  Find child node given the parent node and the edge character
+  Insert string info for current position into the String Info Log.
+  Positions are chained newest first by the hash of their first three
+  bytes and, to find long repeats quickly in a big window, by the hash
+  of their first eight bytes. The chains are indexed modulo the window
+  size so entries that slide out of the window are overwritten in place.
   
-Arguments:
+Arguments: (VOID)
 
-  NodeQ       - the parent node
-  CharC       - the edge character
-  
-Returns:
+Returns: (VOID)
 
-  The child node (NIL if not found)  
-  
 --*/
 {
-  NODE  NodeR;
+  UINT32  Hash;
 
-  NodeR = mNext[HASH (NodeQ, CharC)];
-  //
-  // sentinel
-  //
-  mParent[NIL] = NodeQ;
-  while (mParent[NodeR] != NodeQ) {
-    NodeR = mNext[NodeR];
-  }
+  Hash                            = HASH (mPos);
+  mPrev[mPos & (WNDSIZ - 1)]      = mHead[Hash];
+  mHead[Hash]                     = mPos;
 
-  return NodeR;
+  Hash                            = LONG_HASH (mPos);
+  mLongPrev[mPos & (WNDSIZ - 1)]  = mLongHead[Hash];
+  mLongHead[Hash]                 = mPos;
 }
 
 STATIC
 VOID
-MakeChild (
-  IN NODE  Parent,
-  IN UINT8 CharC,
-  IN NODE  Child
+SearchChain (
+  IN NODE   NodeR,
+  IN NODE   *Prev,
+  IN INT32  Chain
   )
 /*++
 
 Routine Description:
 
-  Create a new child for a given parent node.
+  Walk at most Chain entries of a hash chain and update the longest
+  match for the current position. Ties keep the earlier, nearer
+  position since it yields the shortest position code.
   
 Arguments:
 
-  Parent       - the parent node
-  CharC   - the edge character
-  Child       - the child node
-  
+  NodeR       - the newest position in the chain
+  Prev        - the chain links
+  Chain       - the maximum number of positions to compare
+
 Returns: (VOID)
 
 --*/
 {
-  NODE  Node1;
-  NODE  Node2;
-
-  Node1           = (NODE) HASH (Parent, CharC);
-  Node2           = mNext[Node1];
-  mNext[Node1]    = Child;
-  mNext[Child]    = Node2;
-  mPrev[Node2]    = Child;
-  mPrev[Child]    = Node1;
-  mParent[Child]  = Parent;
-  mChildCount[Parent]++;
-}
-
-STATIC
-VOID
-Split (
-  NODE Old
-  )
-/*++
-
-Routine Description:
+  INT32 Limit;
+  INT32 Len;
+  UINT8 *t1;
+  UINT8 *t2;
 
-  Split a node.
-  
-Arguments:
+  Limit = mPos - WNDSIZ;
+  t1    = &mText[mPos];
+  while (NodeR > Limit && Chain-- > 0) {
+    t2 = &mText[NodeR];
+    if (t2[mMatchLen] == t1[mMatchLen] && t2[0] == t1[0] && t2[1] == t1[1]) {
+      for (Len = 2; Len < MAXMATCH && t1[Len] == t2[Len]; Len++) {
+      }
 
-  Old     - the node to split
-  
-Returns: (VOID)
+      if (Len > mMatchLen) {
+        mMatchLen = Len;
+        mMatchPos = NodeR;
+        if (Len >= MAXMATCH) {
+          return;
+        }
+      }
+    }
 
---*/
-{
-  NODE  New;
-  NODE  TempNode;
-
-  New               = mAvail;
-  mAvail            = mNext[New];
-  mChildCount[New]  = 0;
-  TempNode          = mPrev[Old];
-  mPrev[New]        = TempNode;
-  mNext[TempNode]   = New;
-  TempNode          = mNext[Old];
-  mNext[New]        = TempNode;
-  mPrev[TempNode]   = New;
-  mParent[New]      = mParent[Old];
-  mLevel[New]       = (UINT8) mMatchLen;
-  mPosition[New]    = mPos;
-  MakeChild (New, mText[mMatchPos + mMatchLen], Old);
-  MakeChild (New, mText[mPos + mMatchLen], mPos);
+    NodeR = Prev[NodeR & (WNDSIZ - 1)];
+  }
 }
 
 STATIC
 VOID
-InsertNode (
+FindMatch (
   VOID
   )
 /*++
 
 Routine Description:
 
-  Insert string info for current position into the String Info Log
+  Find a match string for current position.
   
 Arguments: (VOID)
 
@@ -669,229 +613,58 @@ Returns: (VOID)
 
 --*/
 {
-  NODE  NodeQ;
-  NODE  NodeR;
-  NODE  Index2;
-  NODE  NodeT;
-  UINT8 CharC;
-  UINT8 *t1;
-  UINT8 *t2;
-
-  if (mMatchLen >= 4) {
-    //
-    // We have just got a long match, the target tree
-    // can be located by MatchPos + 1. Travese the tree
-    // from bottom up to get to a proper starting point.
-    // The usage of PERC_FLAG ensures proper node deletion
-    // in DeleteNode() later.
-    //
-    mMatchLen--;
-    NodeR = (NODE) ((mMatchPos + 1) | WNDSIZ);
-    NodeQ = mParent[NodeR];
-    while (NodeQ == NIL) {
-      NodeR = mNext[NodeR];
-      NodeQ = mParent[NodeR];
-    }
-
-    while (mLevel[NodeQ] >= mMatchLen) {
-      NodeR = NodeQ;
-      NodeQ = mParent[NodeQ];
-    }
-
-    NodeT = NodeQ;
-    while (mPosition[NodeT] < 0) {
-      mPosition[NodeT]  = mPos;
-      NodeT             = mParent[NodeT];
-    }
-
-    if (NodeT < WNDSIZ) {
-      mPosition[NodeT] = (NODE) (mPos | (UINT32) PERC_FLAG);
-    }
-  } else {
-    //
-    // Locate the target tree
-    //
-    NodeQ = (NODE) (mText[mPos] + WNDSIZ);
-    CharC = mText[mPos + 1];
-    NodeR = Child (NodeQ, CharC);
-    if (NodeR == NIL) {
-      MakeChild (NodeQ, CharC, mPos);
-      mMatchLen = 1;
-      return ;
-    }
-
-    mMatchLen = 2;
-  }
-  //
-  // Traverse down the tree to find a match.
-  // Update Position value along the route.
-  // Node split or creation is involved.
-  //
-  for (;;) {
-    if (NodeR >= WNDSIZ) {
-      Index2    = MAXMATCH;
-      mMatchPos = NodeR;
-    } else {
-      Index2    = mLevel[NodeR];
-      mMatchPos = (NODE) (mPosition[NodeR] & (UINT32)~PERC_FLAG);
-    }
-
-    if (mMatchPos >= mPos) {
-      mMatchPos -= WNDSIZ;
-    }
-
-    t1  = &mText[mPos + mMatchLen];
-    t2  = &mText[mMatchPos + mMatchLen];
-    while (mMatchLen < Index2) {
-      if (*t1 != *t2) {
-        Split (NodeR);
-        return ;
-      }
-
-      mMatchLen++;
-      t1++;
-      t2++;
-    }
-
-    if (mMatchLen >= MAXMATCH) {
-      break;
-    }
-
-    mPosition[NodeR]  = mPos;
-    NodeQ             = NodeR;
-    NodeR             = Child (NodeQ, *t1);
-    if (NodeR == NIL) {
-      MakeChild (NodeQ, *t1, mPos);
-      return ;
-    }
-
-    mMatchLen++;
+  mMatchLen = 0;
+  SearchChain (mHead[HASH (mPos)], mPrev, MAX_CHAIN);
+  if (mMatchLen < MAXMATCH) {
+    SearchChain (mLongHead[LONG_HASH (mPos)], mLongPrev, MAX_LONG_CHAIN);
   }
-
-  NodeT           = mPrev[NodeR];
-  mPrev[mPos]     = NodeT;
-  mNext[NodeT]    = mPos;
-  NodeT           = mNext[NodeR];
-  mNext[mPos]     = NodeT;
-  mPrev[NodeT]    = mPos;
-  mParent[mPos]   = NodeQ;
-  mParent[NodeR]  = NIL;
-
-  //
-  // Special usage of 'next'
-  //
-  mNext[NodeR] = mPos;
-
 }
 
 STATIC
 VOID
-DeleteNode (
-  VOID
+RebaseChain (
+  IN OUT NODE   *Table,
+  IN     UINT32 Size
   )
 /*++
 
 Routine Description:
 
-  Delete outdated string info. (The Usage of PERC_FLAG
-  ensures a clean deletion)
+  Move the positions logged in a hash table or chain down by WNDSIZ
+  after the text has been slid, dropping those that fall off.
   
-Arguments: (VOID)
+Arguments:
+
+  Table       - the hash table or chain links
+  Size        - the number of entries in Table
 
 Returns: (VOID)
 
 --*/
 {
-  NODE  NodeQ;
-  NODE  NodeR;
-  NODE  NodeS;
-  NODE  NodeT;
-  NODE  NodeU;
-
-  if (mParent[mPos] == NIL) {
-    return ;
-  }
-
-  NodeR         = mPrev[mPos];
-  NodeS         = mNext[mPos];
-  mNext[NodeR]  = NodeS;
-  mPrev[NodeS]  = NodeR;
-  NodeR         = mParent[mPos];
-  mParent[mPos] = NIL;
-  if (NodeR >= WNDSIZ) {
-    return ;
-  }
-
-  mChildCount[NodeR]--;
-  if (mChildCount[NodeR] > 1) {
-    return ;
-  }
-
-  NodeT = (NODE) (mPosition[NodeR] & (UINT32)~PERC_FLAG);
-  if (NodeT >= mPos) {
-    NodeT -= WNDSIZ;
-  }
-
-  NodeS = NodeT;
-  NodeQ = mParent[NodeR];
-  NodeU = mPosition[NodeQ];
-  while (NodeU & (UINT32) PERC_FLAG) {
-    NodeU &= (UINT32)~PERC_FLAG;
-    if (NodeU >= mPos) {
-      NodeU -= WNDSIZ;
-    }
-
-    if (NodeU > NodeS) {
-      NodeS = NodeU;
-    }
-
-    mPosition[NodeQ]  = (NODE) (NodeS | WNDSIZ);
-    NodeQ             = mParent[NodeQ];
-    NodeU             = mPosition[NodeQ];
-  }
-
-  if (NodeQ < WNDSIZ) {
-    if (NodeU >= mPos) {
-      NodeU -= WNDSIZ;
-    }
-
-    if (NodeU > NodeS) {
-      NodeS = NodeU;
-    }
+  UINT32  Index;
 
-    mPosition[NodeQ] = (NODE) (NodeS | WNDSIZ | (UINT32) PERC_FLAG);
+  for (Index = 0; Index < Size; Index++) {
+    Table[Index] = Table[Index] >= (NODE) WNDSIZ ? Table[Index] - WNDSIZ : NIL;
   }
-
-  NodeS           = Child (NodeR, mText[NodeT + mLevel[NodeR]]);
-  NodeT           = mPrev[NodeS];
-  NodeU           = mNext[NodeS];
-  mNext[NodeT]    = NodeU;
-  mPrev[NodeU]    = NodeT;
-  NodeT           = mPrev[NodeR];
-  mNext[NodeT]    = NodeS;
-  mPrev[NodeS]    = NodeT;
-  NodeT           = mNext[NodeR];
-  mPrev[NodeT]    = NodeS;
-  mNext[NodeS]    = NodeT;
-  mParent[NodeS]  = mParent[NodeR];
-  mParent[NodeR]  = NIL;
-  mNext[NodeR]    = mAvail;
-  mAvail          = NodeR;
 }
 
 STATIC
 VOID
 GetNextMatch (
-  VOID
+  IN BOOLEAN Search
   )
 /*++
 
 Routine Description:
 
   Advance the current position (read in new data if needed).
-  Delete outdated string info. Find a match string for current position.
+  Find a match string for current position and log it.
 
-Arguments: (VOID)
+Arguments:
+
+  Search  - FALSE to only log the position, used while skipping over
+            a string that has already been output as a pointer
 
 Returns: (VOID)
 
@@ -906,9 +679,16 @@ Returns: (VOID)
     Number = FreadCrc (&mText[WNDSIZ + MAXMATCH], WNDSIZ);
     mRemainder += Number;
     mPos = WNDSIZ;
+    RebaseChain (mHead, HASH_SIZE);
+    RebaseChain (mPrev, WNDSIZ);
+    RebaseChain (mLongHead, HASH_SIZE);
+    RebaseChain (mLongPrev, WNDSIZ);
+  }
+
+  if (Search) {
+    FindMatch ();
   }
 
-  DeleteNode ();
   InsertNode ();
 }
 
@@ -950,6 +730,7 @@ Returns:
 
   mMatchLen   = 0;
   mPos        = WNDSIZ;
+  FindMatch ();
   InsertNode ();
   if (mMatchLen > mRemainder) {
     mMatchLen = mRemainder;
@@ -958,7 +739,7 @@ Returns:
   while (mRemainder > 0) {
     LastMatchLen  = mMatchLen;
     LastMatchPos  = mMatchPos;
-    GetNextMatch ();
+    GetNextMatch (TRUE);
     if (mMatchLen > mRemainder) {
       mMatchLen = mRemainder;
     }
@@ -986,11 +767,13 @@ Returns:
         (mPos - LastMatchPos - 2) & (WNDSIZ - 1)
         );
       LastMatchLen--;
-      while (LastMatchLen > 0) {
-        GetNextMatch ();
+      while (LastMatchLen > 1) {
+        GetNextMatch (FALSE);
         LastMatchLen--;
       }
 
+      GetNextMatch (TRUE);
+
       if (mMatchLen > mRemainder) {
         mMatchLen = mRemainder;
       }
@@ -297,7 +297,7 @@ Returns:
   UINT32                              Offset;
   UINT32                              FileSize;
   UINT32                              Index;
-  FILE                                *InFile;
+  CHAR8                               *FileImage;
   EFI_FREEFORM_SUBTYPE_GUID_SECTION   *SectHeader;
   EFI_COMMON_SECTION_HEADER2          TempSectHeader;
   EFI_TE_IMAGE_HEADER                 TeHeader;
@@ -325,17 +325,13 @@ Returns:
     }
     
     // 
-    // Open file and read contents
+    // Read file contents
     //
-    InFile = fopen (LongFilePath (InputFileName[Index]), "rb");
-    if (InFile == NULL) {
+    if (GetFileImage (InputFileName[Index], &FileImage, &FileSize) != EFI_SUCCESS) {
       Error (NULL, 0, 0001, "Error opening file", InputFileName[Index]);
       return EFI_ABORTED;
     }
 
-    fseek (InFile, 0, SEEK_END);
-    FileSize = ftell (InFile);
-    fseek (InFile, 0, SEEK_SET);
     DebugMsg (NULL, 0, 9, "Input section files", 
               "the input section name is %s and the size is %u bytes", InputFileName[Index], (unsigned) FileSize); 
 
@@ -348,24 +344,29 @@ Returns:
     } else {
       HeaderSize = sizeof (EFI_COMMON_SECTION_HEADER);
     }
-    fread (&TempSectHeader, 1, HeaderSize, InFile);
+    memset (&TempSectHeader, 0, sizeof (TempSectHeader));
+    memcpy (&TempSectHeader, FileImage, MIN (HeaderSize, FileSize));
     if (TempSectHeader.Type == EFI_SECTION_TE) {
       (*PESectionNum) ++;
-      fread (&TeHeader, 1, sizeof (TeHeader), InFile);
+      memset (&TeHeader, 0, sizeof (TeHeader));
+      if (FileSize > HeaderSize) {
+        memcpy (&TeHeader, FileImage + HeaderSize, MIN (sizeof (TeHeader), FileSize - HeaderSize));
+      }
       if (TeHeader.Signature == EFI_TE_IMAGE_HEADER_SIGNATURE) {
         TeOffset = TeHeader.StrippedSize - sizeof (TeHeader);
       }
     } else if (TempSectHeader.Type == EFI_SECTION_PE32) {
       (*PESectionNum) ++;
     } else if (TempSectHeader.Type == EFI_SECTION_GUID_DEFINED) {
-      fseek (InFile, 0, SEEK_SET);
       if (FileSize >= MAX_SECTION_SIZE) {
-        fread (&GuidSectHeader2, 1, sizeof (GuidSectHeader2), InFile);
+        memset (&GuidSectHeader2, 0, sizeof (GuidSectHeader2));
+        memcpy (&GuidSectHeader2, FileImage, MIN (sizeof (GuidSectHeader2), FileSize));
         if ((GuidSectHeader2.Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0) {
           HeaderSize = GuidSectHeader2.DataOffset;
         }
       } else {
-        fread (&GuidSectHeader, 1, sizeof (GuidSectHeader), InFile);
+        memset (&GuidSectHeader, 0, sizeof (GuidSectHeader));
+        memcpy (&GuidSectHeader, FileImage, MIN (sizeof (GuidSectHeader), FileSize));
         if ((GuidSectHeader.Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0) {
           HeaderSize = GuidSectHeader.DataOffset;
         }
@@ -379,8 +380,6 @@ Returns:
       (*PESectionNum) ++;
     }
 
-    fseek (InFile, 0, SEEK_SET);
-
     //
     // Revert TeOffset to the converse value relative to Alignment
     // This is to assure the original PeImage Header at Alignment.
@@ -443,14 +442,10 @@ Returns:
     // Buffer must be enough to contain the file content.
     //
     if ((FileSize > 0) && (FileBuffer != NULL) && ((Size + FileSize) <= *BufferLength)) {
-      if (fread (FileBuffer + Size, (size_t) FileSize, 1, InFile) != 1) {
-        Error (NULL, 0, 0004, "Error reading file", InputFileName[Index]);
-        fclose (InFile);
-        return EFI_ABORTED;
-      }
+      memcpy (FileBuffer + Size, FileImage, (size_t) FileSize);
     }
 
-    fclose (InFile);
+    free (FileImage);
     Size += FileSize;
   }
 
@@ -468,6 +463,7 @@ Returns:
   }
 }
 
+STATIC
 EFI_STATUS
 FfsRebaseImageRead (
     IN      VOID    *FileHandle,
@@ -519,34 +515,22 @@ GetAlignmentFromFile(char *InFile, UINT32 *Alignment)
     return the alignment
     --*/
 {
-  FILE                           *InFileHandle;
   UINT8                          *PeFileBuffer;
-  UINTN                          PeFileSize;
+  UINT32                         PeFileSize;
   UINT32                         CurSecHdrSize;
   PE_COFF_LOADER_IMAGE_CONTEXT   ImageContext;
   EFI_COMMON_SECTION_HEADER      *CommonHeader;
   EFI_STATUS                     Status;
 
-  InFileHandle        = NULL;
   PeFileBuffer        = NULL;
   *Alignment          = 0;
 
   memset (&ImageContext, 0, sizeof (ImageContext));
 
-  InFileHandle = fopen(LongFilePath(InFile), "rb");
-  if (InFileHandle == NULL){
+  if (GetFileImage (InFile, (CHAR8 **) &PeFileBuffer, &PeFileSize) != EFI_SUCCESS) {
     Error (NULL, 0, 0001, "Error opening file", InFile);
     return EFI_ABORTED;
   }
-  PeFileSize = _filelength (fileno(InFileHandle));
-  PeFileBuffer = (UINT8 *) malloc (PeFileSize);
-  if (PeFileBuffer == NULL) {
-    fclose (InFileHandle);
-    Error(NULL, 0, 4001, "Resource", "memory cannot be allocated  of %s", InFileHandle);
-    return EFI_OUT_OF_RESOURCES;
-  }
-  fread (PeFileBuffer, sizeof (UINT8), PeFileSize, InFileHandle);
-  fclose (InFileHandle);
   CommonHeader = (EFI_COMMON_SECTION_HEADER *) PeFileBuffer;
   CurSecHdrSize = GetSectionHeaderLength(CommonHeader);
   ImageContext.Handle = (VOID *) ((UINTN)PeFileBuffer + CurSecHdrSize);
@@ -600,7 +584,7 @@ Returns:
   UINT32                  FileSize;
   UINT32                  MaxAlignment;
   EFI_FFS_FILE_HEADER2    FfsFileHeader;
-  FILE                    *FfsFile;
+  UINT8                   *FfsImage;
   UINT32                  Index;
   UINT64                  LogLevel;
   UINT8                   PeSectionNum;
@@ -628,7 +612,7 @@ Returns:
   FileBuffer     = NULL;
   FileSize       = 0;
   MaxAlignment   = 1;
-  FfsFile        = NULL;
+  FfsImage       = NULL;
   Status         = EFI_SUCCESS;
   PeSectionNum   = 0;
 
@@ -1069,24 +1053,23 @@ Returns:
   // Open output file to write ffs data.
   //
   if (OutputFileName != NULL) {
-    remove(OutputFileName);
-    FfsFile = fopen (LongFilePath (OutputFileName), "wb");
-    if (FfsFile == NULL) {
-      Error (NULL, 0, 0001, "Error opening file", OutputFileName);
+    FfsImage = (UINT8 *) malloc (FileSize);
+    if (FfsImage == NULL) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
       goto Finish;
     }
     //
-    // write header
-    //
-    fwrite (&FfsFileHeader, 1, HeaderSize, FfsFile);
-    //
-    // write data
+    // copy header and data
     //
+    memcpy (FfsImage, &FfsFileHeader, HeaderSize);
     if (FileBuffer != NULL) {
-      fwrite (FileBuffer, 1, FileSize - HeaderSize, FfsFile);
+      memcpy (FfsImage + HeaderSize, FileBuffer, FileSize - HeaderSize);
     }
 
-    fclose (FfsFile);
+    if (PutFileImage (OutputFileName, (CHAR8 *) FfsImage, FileSize) != EFI_SUCCESS) {
+      Error (NULL, 0, 0001, "Error opening file", OutputFileName);
+      goto Finish;
+    }
   }
 
 Finish:
@@ -1099,6 +1082,9 @@ Finish:
   if (FileBuffer != NULL) {
     free (FileBuffer);
   }
+  if (FfsImage != NULL) {
+    free (FfsImage);
+  }
   //
   // If any errors were reported via the standard error reporting
   // routines, then the status has been saved. Get the value and
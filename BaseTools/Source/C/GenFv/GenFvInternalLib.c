@@ -1188,10 +1188,9 @@ Returns:
 
 --*/
 {
-  FILE                  *NewFile;
   UINTN                 FileSize;
+  UINT32                FileImageSize;
   UINT8                 *FileBuffer;
-  UINTN                 NumBytesRead;
   UINT32                CurrentFileAlignment;
   EFI_STATUS            Status;
   UINTN                 Index1;
@@ -1206,45 +1205,15 @@ Returns:
   }
 
   //
-  // Read the file to add
+  // Read the file to add into a buffer. The image may come from the file
+  // image cache when the FFS file was generated in the same process.
   //
-  NewFile = fopen (LongFilePath (FvInfo->FvFiles[Index]), "rb");
-
-  if (NewFile == NULL) {
-    Error (NULL, 0, 0001, "Error opening file", FvInfo->FvFiles[Index]);
-    return EFI_ABORTED;
-  }
-
-  //
-  // Get the file size
-  //
-  FileSize = _filelength (fileno (NewFile));
-
-  //
-  // Read the file into a buffer
-  //
-  FileBuffer = malloc (FileSize);
-  if (FileBuffer == NULL) {
-    fclose (NewFile);
-    Error (NULL, 0, 4001, "Resouce", "memory cannot be allocated!");
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  NumBytesRead = fread (FileBuffer, sizeof (UINT8), FileSize, NewFile);
-
-  //
-  // Done with the file, from this point on we will just use the buffer read.
-  //
-  fclose (NewFile);
-  
-  //
-  // Verify read successful
-  //
-  if (NumBytesRead != sizeof (UINT8) * FileSize) {
-    free  (FileBuffer);
+  Status = GetFileImage (FvInfo->FvFiles[Index], (CHAR8 **) &FileBuffer, &FileImageSize);
+  if (EFI_ERROR (Status)) {
     Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
-    return EFI_ABORTED;
+    return Status;
   }
+  FileSize = FileImageSize;
   
   //
   // For None PI Ffs file, directly add them into FvImage.
@@ -2499,6 +2468,15 @@ Returns:
   FvReportName   = NULL;
   FvReportFile   = NULL;
 
+  //
+  // Reset the state left by a previous image generated in the same process
+  //
+  mArm                 = FALSE;
+  VtfFileFlag          = FALSE;
+  mIsLargeFfs          = FALSE;
+  MaxFfsAlignment      = 0;
+  mFvBaseAddressNumber = 0;
+
   if (InfFileImage != NULL) {
     //
     // Initialize file structures
@@ -3078,7 +3056,8 @@ Returns:
   UINTN               CurrentOffset;
   UINTN               Index;
   FILE                *fpin;
-  UINTN               FfsFileSize;
+  UINT8               *FfsFileImage;
+  UINT32              FfsFileSize;
   UINTN               FvExtendHeaderSize;
   UINT32              FfsAlignment;
   UINT32              FfsHeaderSize;
@@ -3138,18 +3117,12 @@ Returns:
   //
   for (Index = 0; FvInfoPtr->FvFiles[Index][0] != 0; Index++) {
     //
-    // Open FFS file
+    // Read FFS file
     //
-    fpin = NULL;
-    fpin = fopen (LongFilePath (FvInfoPtr->FvFiles[Index]), "rb");
-    if (fpin == NULL) {
+    if (GetFileImage (FvInfoPtr->FvFiles[Index], (CHAR8 **) &FfsFileImage, &FfsFileSize) != EFI_SUCCESS) {
       Error (NULL, 0, 0001, "Error opening file", FvInfoPtr->FvFiles[Index]);
       return EFI_ABORTED;
     }
-    //
-    // Get the file size
-    //
-    FfsFileSize = _filelength (fileno (fpin));
     if (FfsFileSize >= MAX_FFS_SIZE) {
       FfsHeaderSize = sizeof(EFI_FFS_FILE_HEADER2);
       mIsLargeFfs = TRUE;
@@ -3159,11 +3132,9 @@ Returns:
     //
     // Read Ffs File header
     //
-    fread (&FfsHeader, sizeof (UINT8), sizeof (EFI_FFS_FILE_HEADER), fpin);
-    //
-    // close file
-    //
-    fclose (fpin);
+    memset (&FfsHeader, 0, sizeof (EFI_FFS_FILE_HEADER));
+    memcpy (&FfsHeader, FfsFileImage, MIN (sizeof (EFI_FFS_FILE_HEADER), FfsFileSize));
+    free (FfsFileImage);
     
     if (FvInfoPtr->IsPiFvImage) {
         //
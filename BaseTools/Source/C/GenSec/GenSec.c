@@ -263,7 +263,7 @@ Returns:
 --*/
 {
   UINT32                    InputFileLength;
-  FILE                      *InFile;
+  CHAR8                     *InputFileImage;
   UINT8                     *Buffer;
   UINT32                    TotalLength;
   UINT32                    HeaderLength;
@@ -278,22 +278,15 @@ Returns:
     return STATUS_ERROR;
   }
   //
-  // Open the input file
+  // Read the input file
   //
-  InFile = fopen (LongFilePath (InputFileName[0]), "rb");
-  if (InFile == NULL) {
+  if (GetFileImage (InputFileName[0], &InputFileImage, &InputFileLength) != EFI_SUCCESS) {
     Error (NULL, 0, 0001, "Error opening file", InputFileName[0]);
     return STATUS_ERROR;
   }
 
   Status  = STATUS_ERROR;
   Buffer  = NULL;
-  //
-  // Seek to the end of the input file so we can determine its size
-  //
-  fseek (InFile, 0, SEEK_END);
-  InputFileLength = ftell (InFile);
-  fseek (InFile, 0, SEEK_SET);
   DebugMsg (NULL, 0, 9, "Input file", "File name is %s and File size is %u bytes", InputFileName[0], (unsigned) InputFileLength);
   TotalLength     = sizeof (EFI_COMMON_SECTION_HEADER) + InputFileLength;
   //
@@ -329,14 +322,9 @@ Returns:
   }
   
   //
-  // read data from the input file.
+  // copy data from the input file.
   //
-  if (InputFileLength != 0) {
-    if (fread (Buffer + HeaderLength, (size_t) InputFileLength, 1, InFile) != 1) {
-      Error (NULL, 0, 0004, "Error reading file", InputFileName[0]);
-      goto Done;
-    }
-  }
+  memcpy (Buffer + HeaderLength, InputFileImage, (size_t) InputFileLength);
 
   //
   // Set OutFileBuffer 
@@ -345,7 +333,7 @@ Returns:
   Status = STATUS_SUCCESS;
 
 Done:
-  fclose (InFile);
+  free (InputFileImage);
 
   return Status;
 }
@@ -430,7 +418,7 @@ Returns:
   UINT32                     Offset;
   UINT32                     FileSize;
   UINT32                     Index;
-  FILE                       *InFile;
+  CHAR8                      *FileImage;
   EFI_COMMON_SECTION_HEADER  *SectHeader;
   EFI_COMMON_SECTION_HEADER2 TempSectHeader;
   EFI_TE_IMAGE_HEADER        TeHeader;
@@ -468,17 +456,13 @@ Returns:
     }
     
     // 
-    // Open file and read contents
+    // Read file contents
     //
-    InFile = fopen (LongFilePath (InputFileName[Index]), "rb");
-    if (InFile == NULL) {
+    if (GetFileImage (InputFileName[Index], &FileImage, &FileSize) != EFI_SUCCESS) {
       Error (NULL, 0, 0001, "Error opening file", InputFileName[Index]);
       return EFI_ABORTED;
     }
 
-    fseek (InFile, 0, SEEK_END);
-    FileSize = ftell (InFile);
-    fseek (InFile, 0, SEEK_SET);
     DebugMsg (NULL, 0, 9, "Input files", "the input file name is %s and the size is %u bytes", InputFileName[Index], (unsigned) FileSize); 
     //
     // Adjust section buffer when section alignment is required.
@@ -497,29 +481,32 @@ Returns:
       } else {
         HeaderSize = sizeof (EFI_COMMON_SECTION_HEADER);
       }
-      fread (&TempSectHeader, 1, HeaderSize, InFile);
+      memset (&TempSectHeader, 0, sizeof (TempSectHeader));
+      memcpy (&TempSectHeader, FileImage, MIN (HeaderSize, FileSize));
       if (TempSectHeader.Type == EFI_SECTION_TE) {
-        fread (&TeHeader, 1, sizeof (TeHeader), InFile);
+        memset (&TeHeader, 0, sizeof (TeHeader));
+        if (FileSize > HeaderSize) {
+          memcpy (&TeHeader, FileImage + HeaderSize, MIN (sizeof (TeHeader), FileSize - HeaderSize));
+        }
         if (TeHeader.Signature == EFI_TE_IMAGE_HEADER_SIGNATURE) {
           TeOffset = TeHeader.StrippedSize - sizeof (TeHeader);
         }
       } else if (TempSectHeader.Type == EFI_SECTION_GUID_DEFINED) {
-        fseek (InFile, 0, SEEK_SET);
         if (FileSize >= MAX_SECTION_SIZE) {
-          fread (&GuidSectHeader2, 1, sizeof (GuidSectHeader2), InFile);
+          memset (&GuidSectHeader2, 0, sizeof (GuidSectHeader2));
+          memcpy (&GuidSectHeader2, FileImage, MIN (sizeof (GuidSectHeader2), FileSize));
           if ((GuidSectHeader2.Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0) {
             HeaderSize = GuidSectHeader2.DataOffset;
           }
         } else {
-          fread (&GuidSectHeader, 1, sizeof (GuidSectHeader), InFile);
+          memset (&GuidSectHeader, 0, sizeof (GuidSectHeader));
+          memcpy (&GuidSectHeader, FileImage, MIN (sizeof (GuidSectHeader), FileSize));
           if ((GuidSectHeader.Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0) {
             HeaderSize = GuidSectHeader.DataOffset;
           }
         }
       } 
 
-      fseek (InFile, 0, SEEK_SET);
-
       //
       // Revert TeOffset to the converse value relative to Alignment
       // This is to assure the original PeImage Header at Alignment.
@@ -558,14 +545,10 @@ Returns:
     // Buffer must be enough to contain the file content.
     //
     if ((FileSize > 0) && (FileBuffer != NULL) && ((Size + FileSize) <= *BufferLength)) {
-      if (fread (FileBuffer + Size, (size_t) FileSize, 1, InFile) != 1) {
-        Error (NULL, 0, 0004, "Error reading file", InputFileName[Index]);
-        fclose (InFile);
-        return EFI_ABORTED;
-      }
+      memcpy (FileBuffer + Size, FileImage, (size_t) FileSize);
     }
 
-    fclose (InFile);
+    free (FileImage);
     Size += FileSize;
   }
   
@@ -1010,7 +993,6 @@ Returns:
 {
   UINT32                    Index;
   UINT32                    InputFileNum;
-  FILE                      *OutFile;
   CHAR8                     **InputFileName;
   CHAR8                     *OutputFileName;
   CHAR8                     *SectionName;
@@ -1032,12 +1014,10 @@ Returns:
   UINT32                    InputFileAlignNum;
   EFI_COMMON_SECTION_HEADER *SectionHeader;
   CHAR8                     *DummyFileName;
-  FILE                      *DummyFile;
-  UINTN                     DummyFileSize;
+  UINT32                    DummyFileSize;
   UINT8                     *DummyFileBuffer;
-  FILE                      *InFile;
   UINT8                     *InFileBuffer;
-  UINTN                     InFileSize;
+  UINT32                    InFileSize;
 
   InputFileAlign        = NULL;
   InputFileAlignNum     = 0;
@@ -1046,7 +1026,6 @@ Returns:
   SectionName           = NULL;
   CompressionName       = NULL;
   StringBuffer          = "";
-  OutFile               = NULL;
   VersionNumber         = 0;
   InputFileNum          = 0;
   SectType              = EFI_SECTION_ALL;
@@ -1061,9 +1040,7 @@ Returns:
   UiSect                = NULL;
   DummyFileSize         = 0;
   DummyFileName         = NULL;
-  DummyFile             = NULL;
   DummyFileBuffer       = NULL;
-  InFile                = NULL;
   InFileSize            = 0;
   InFileBuffer          = NULL;
   
@@ -1321,53 +1298,25 @@ Returns:
 
   if (DummyFileName != NULL) {
       //
-      // Open file and read contents
+      // Read file contents
       //
-      DummyFile = fopen (LongFilePath (DummyFileName), "rb");
-      if (DummyFile == NULL) {
+      if (GetFileImage (DummyFileName, (CHAR8 **) &DummyFileBuffer, &DummyFileSize) != EFI_SUCCESS) {
         Error (NULL, 0, 0001, "Error opening file", DummyFileName);
         goto Finish;
       }
-
-      fseek (DummyFile, 0, SEEK_END);
-      DummyFileSize = ftell (DummyFile);
-      fseek (DummyFile, 0, SEEK_SET);
-      DummyFileBuffer = (UINT8 *) malloc (DummyFileSize);
-      if (DummyFileBuffer == NULL) {
-        fclose(DummyFile);
-        Error (NULL, 0, 4001, "Resource", "memory cannot be allcoated");
-        goto Finish;
-      }
-
-      fread(DummyFileBuffer, 1, DummyFileSize, DummyFile);
-      fclose(DummyFile);
       DebugMsg (NULL, 0, 9, "Dummy files", "the dummy file name is %s and the size is %u bytes", DummyFileName, (unsigned) DummyFileSize);
 
       if (InputFileName == NULL) {
         Error (NULL, 0, 4001, "Resource", "memory cannot be allcoated");
         goto Finish;
       }
-      InFile = fopen(LongFilePath(InputFileName[0]), "rb");
-      if (InFile == NULL) {
+      if (GetFileImage (InputFileName[0], (CHAR8 **) &InFileBuffer, &InFileSize) != EFI_SUCCESS) {
         Error (NULL, 0, 0001, "Error opening file", InputFileName[0]);
         goto Finish;
       }
-
-      fseek (InFile, 0, SEEK_END);
-      InFileSize = ftell (InFile);
-      fseek (InFile, 0, SEEK_SET);
-      InFileBuffer = (UINT8 *) malloc (InFileSize);
-      if (InFileBuffer == NULL) {
-        fclose(InFile);
-        Error (NULL, 0, 4001, "Resource", "memory cannot be allcoated");
-        goto Finish;
-      }
-
-      fread(InFileBuffer, 1, InFileSize, InFile);
-      fclose(InFile);
       DebugMsg (NULL, 0, 9, "Input files", "the input file name is %s and the size is %u bytes", InputFileName[0], (unsigned) InFileSize);
       if (InFileSize > DummyFileSize){
-        if (stricmp((CHAR8 *)DummyFileBuffer, (CHAR8 *)(InFileBuffer + (InFileSize - DummyFileSize))) == 0){
+        if (memcmp (DummyFileBuffer, InFileBuffer + (InFileSize - DummyFileSize), DummyFileSize) == 0){
           SectGuidHeaderLength = InFileSize - DummyFileSize;
         }
       }
@@ -1376,6 +1325,7 @@ Returns:
       }
       if (DummyFileBuffer != NULL) {
         free (DummyFileBuffer);
+        DummyFileBuffer = NULL;
       }
       if (InFileBuffer != NULL) {
         free (InFileBuffer);
@@ -1662,14 +1612,11 @@ Returns:
   //
   // Write the output file
   //
-  OutFile = fopen (LongFilePath (OutputFileName), "wb");
-  if (OutFile == NULL) {
+  if (PutFileImage (OutputFileName, (CHAR8 *) OutFileBuffer, InputLength) != EFI_SUCCESS) {
     Error (NULL, 0, 0001, "Error opening file for writing", OutputFileName);
     goto Finish;
   }
 
-  fwrite (OutFileBuffer, InputLength, 1, OutFile);
-
 Finish:
   if (InputFileName != NULL) {
     free (InputFileName);
@@ -1683,10 +1630,6 @@ Finish:
     free (OutFileBuffer);
   }
 
-  if (OutFile != NULL) {
-    fclose (OutFile);
-  }
-
   if (DummyFileBuffer != NULL) {
     free (DummyFileBuffer);
   }
@@ -32,6 +32,16 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Chunked stream layout, see MdeModulePkg/Include/Guid/LzmaDecompress.h:
+//   UINT32 Signature, ChunkSize, ChunkCount, UncompressedSize
+//   UINT32 CompressedSize[ChunkCount]
+//   ChunkCount independent LZMA streams, each with its own LZMA header
+//
+#define LZMA_CHUNKED_SIGNATURE          0x48435A4C  // "LZCH"
+#define LZMA_CHUNKED_HEADER_SIZE        16
+#define LZMA_CHUNKED_DEFAULT_CHUNK_SIZE (1 << 20)
+
 typedef enum {
   NoConverter, 
   X86Converter,
@@ -45,6 +55,7 @@ const char *kDataErrorMessage = "Data error";
 
 static Bool mQuietMode = False;
 static CONVERTER_TYPE mConType = NoConverter;
+static UInt32 mChunkSize = 0;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -61,6 +72,8 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --chunked: split the data into independently compressed chunks\n"
+             "  --chunk-size Size: uncompressed size of each chunk, implies --chunked\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -177,6 +190,177 @@ Done:
   return res;
 }
 
+static void SetUi32(Byte *p, UInt32 v)
+{
+  p[0] = (Byte)v;
+  p[1] = (Byte)(v >> 8);
+  p[2] = (Byte)(v >> 16);
+  p[3] = (Byte)(v >> 24);
+}
+
+static UInt32 GetUi32(const Byte *p)
+{
+  return (UInt32)p[0] | ((UInt32)p[1] << 8) | ((UInt32)p[2] << 16) | ((UInt32)p[3] << 24);
+}
+
+static SRes EncodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t outPos;
+  UInt32 chunkCount;
+  UInt32 index;
+  CLzmaEncProps props;
+
+  if (inSize == 0) {
+    return SZ_ERROR_INPUT_EOF;
+  }
+  if (fileSize > 0xFFFFFFFF) {
+    return SZ_ERROR_PARAM;
+  }
+
+  LzmaEncProps_Init(&props);
+  //
+  // A chunk never refers to data outside of itself, so a larger dictionary
+  // buys nothing.
+  //
+  props.dictSize = mChunkSize;
+  LzmaEncProps_Normalize(&props);
+
+  chunkCount = (UInt32)((inSize + mChunkSize - 1) / mChunkSize);
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  // we allocate 105% of original size + 64KB per chunk for output buffer
+  outSize = LZMA_CHUNKED_HEADER_SIZE + (size_t)chunkCount * (4 + LZMA_HEADER_SIZE + (1 << 16)) +
+            inSize / 20 * 21;
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  SetUi32(outBuffer, LZMA_CHUNKED_SIGNATURE);
+  SetUi32(outBuffer + 4, mChunkSize);
+  SetUi32(outBuffer + 8, chunkCount);
+  SetUi32(outBuffer + 12, (UInt32)inSize);
+  outPos = LZMA_CHUNKED_HEADER_SIZE + (size_t)chunkCount * 4;
+
+  for (index = 0; index < chunkCount; index++) {
+    size_t chunkOffset = (size_t)index * mChunkSize;
+    size_t chunkSize = inSize - chunkOffset < mChunkSize ? inSize - chunkOffset : mChunkSize;
+    size_t outSizeProcessed = outSize - outPos - LZMA_HEADER_SIZE;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    int i;
+
+    for (i = 0; i < 8; i++)
+      outBuffer[outPos + LZMA_PROPS_SIZE + i] = (Byte)((UInt64)chunkSize >> (8 * i));
+
+    res = LzmaEncode(outBuffer + outPos + LZMA_HEADER_SIZE, &outSizeProcessed,
+        inBuffer + chunkOffset, chunkSize,
+        &props, outBuffer + outPos, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+
+    SetUi32(outBuffer + LZMA_CHUNKED_HEADER_SIZE + index * 4, (UInt32)(LZMA_HEADER_SIZE + outSizeProcessed));
+    outPos += LZMA_HEADER_SIZE + outSizeProcessed;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outPos) != outPos)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t inPos;
+  UInt32 chunkSize;
+  UInt32 chunkCount;
+  UInt32 index;
+  ELzmaStatus status;
+
+  if (inSize < LZMA_CHUNKED_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkSize = GetUi32(inBuffer + 4);
+  chunkCount = GetUi32(inBuffer + 8);
+  outSize = GetUi32(inBuffer + 12);
+  if (GetUi32(inBuffer) != LZMA_CHUNKED_SIGNATURE || chunkSize == 0 ||
+      chunkCount != (outSize + (UInt64)chunkSize - 1) / chunkSize ||
+      (inSize - LZMA_CHUNKED_HEADER_SIZE) / 4 < chunkCount) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  if (outSize == 0) {
+    res = SZ_OK;
+    goto Done;
+  }
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  inPos = LZMA_CHUNKED_HEADER_SIZE + (size_t)chunkCount * 4;
+  for (index = 0; index < chunkCount; index++) {
+    size_t chunkOffset = (size_t)index * chunkSize;
+    size_t destSize = outSize - chunkOffset < chunkSize ? outSize - chunkOffset : chunkSize;
+    size_t srcSize = GetUi32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + index * 4);
+    size_t srcSizePure;
+
+    if (srcSize < LZMA_HEADER_SIZE || srcSize > inSize - inPos) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+    srcSizePure = srcSize - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + chunkOffset, &destSize, inBuffer + inPos + LZMA_HEADER_SIZE, &srcSizePure,
+        inBuffer + inPos, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+    inPos += srcSize;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
 {
   SRes res;
@@ -271,6 +455,18 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunked") == 0) {
+      if (mChunkSize == 0) {
+        mChunkSize = LZMA_CHUNKED_DEFAULT_CHUNK_SIZE;
+      }
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      mChunkSize = (UInt32) strtoul(args[++param], NULL, 0);
+      if (mChunkSize == 0) {
+        return PrintUserError(rs);
+      }
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -319,6 +515,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mChunkSize != 0 && mConType != NoConverter) {
+    return PrintError(rs, "--chunked can not be combined with a converter");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -341,14 +541,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.s, &inStream.s, fileSize);
+    if (mChunkSize != 0) {
+      res = EncodeChunked(&outStream.s, &inStream.s, fileSize);
+    } else {
+      res = Encode(&outStream.s, &inStream.s, fileSize);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.s, &inStream.s, fileSize);
+    if (mChunkSize != 0) {
+      res = DecodeChunked(&outStream.s, &inStream.s, fileSize);
+    } else {
+      res = Decode(&outStream.s, &inStream.s, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
@@ -0,0 +1,414 @@
+/** @file
+Python Firmware Volume Tools
+
+Runs GenSec, GenFfs and GenFv inside the calling process. The files written
+by the tools are kept in the file image cache of CommonLib, so the section
+and FFS files are not read back from disk by the tools that consume them.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials are licensed and made available 
+under the terms and conditions of the BSD License which accompanies this 
+distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Python.h>
+#include <pythread.h>
+#include <stdio.h>
+#ifdef _WIN32
+#include <io.h>
+#define dup     _dup
+#define dup2    _dup2
+#define fileno  _fileno
+#define close   _close
+#else
+#include <unistd.h>
+#endif
+#include <Common/UefiBaseTypes.h>
+#include "CommonLib.h"
+#include "EfiUtilityMsgs.h"
+
+typedef
+int
+(*TOOL_MAIN) (
+  int   argc,
+  char  *argv[]
+  );
+
+typedef struct {
+  CHAR8      *Name;
+  TOOL_MAIN  Main;
+} TOOL_ENTRY;
+
+int GenSecMain (int argc, char *argv[]);
+int GenFfsMain (int argc, char *argv[]);
+int GenFvMain (int argc, char *argv[]);
+
+STATIC TOOL_ENTRY mToolTable[] = {
+  {"GenSec", GenSecMain},
+  {"GenFfs", GenFfsMain},
+  {"GenFv",  GenFvMain},
+  {NULL,     NULL}
+};
+
+//
+// The tools keep their state in globals, so only one batch may run at a time.
+//
+STATIC PyThread_type_lock mBatchLock = NULL;
+
+/**
+  Find the entry point of a tool from the first command line argument, which
+  may be a path and may carry an .exe extension.
+
+  @param  Command   The tool name or path.
+
+  @return The tool entry point, or NULL if the tool is not built in.
+**/
+STATIC
+TOOL_MAIN
+FindTool (
+  CHAR8    *Command
+  )
+{
+  CHAR8       *Name;
+  CHAR8       *Separator;
+  UINTN       Length;
+  TOOL_ENTRY  *Entry;
+
+  Name = Command;
+  for (Separator = Command; *Separator != '\0'; Separator++) {
+    if (*Separator == '/' || *Separator == '\\') {
+      Name = Separator + 1;
+    }
+  }
+  Length = strlen (Name);
+  if (Length > 4 && strcasecmp (Name + Length - 4, ".exe") == 0) {
+    Length -= 4;
+  }
+
+  for (Entry = mToolTable; Entry->Name != NULL; Entry++) {
+    if (strlen (Entry->Name) == Length && strncmp (Entry->Name, Name, Length) == 0) {
+      return Entry->Main;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Free the argument vectors built by RunBatch().
+
+  @param  ArgvList  The argument vectors.
+  @param  Count     The number of argument vectors.
+**/
+STATIC
+VOID
+FreeArgvList (
+  CHAR8      ***ArgvList,
+  Py_ssize_t Count
+  )
+{
+  Py_ssize_t  Index;
+  CHAR8       **Argv;
+
+  for (Index = 0; Index < Count; Index++) {
+    if (ArgvList[Index] != NULL) {
+      for (Argv = ArgvList[Index]; *Argv != NULL; Argv++) {
+        free (*Argv);
+      }
+      free (ArgvList[Index]);
+    }
+  }
+  free (ArgvList);
+}
+
+/**
+  Redirect the stdout and stderr of the process to temporary files, so that
+  the messages printed by the tools can be handed back to the caller.
+
+  @param  OutFile   Returns the temporary file that receives stdout.
+  @param  ErrFile   Returns the temporary file that receives stderr.
+  @param  SavedFd   Returns the duplicated original stdout and stderr.
+
+  @retval TRUE      The output is redirected.
+  @retval FALSE     The output could not be redirected and is left alone.
+**/
+STATIC
+BOOLEAN
+StartCapture (
+  FILE  **OutFile,
+  FILE  **ErrFile,
+  int   SavedFd[2]
+  )
+{
+  fflush (stdout);
+  fflush (stderr);
+  *OutFile   = tmpfile ();
+  *ErrFile   = tmpfile ();
+  SavedFd[0] = dup (fileno (stdout));
+  SavedFd[1] = dup (fileno (stderr));
+  if (*OutFile == NULL || *ErrFile == NULL || SavedFd[0] < 0 || SavedFd[1] < 0 ||
+      dup2 (fileno (*OutFile), fileno (stdout)) < 0) {
+    goto Failed;
+  }
+  if (dup2 (fileno (*ErrFile), fileno (stderr)) < 0) {
+    dup2 (SavedFd[0], fileno (stdout));
+    goto Failed;
+  }
+  return TRUE;
+
+Failed:
+  if (SavedFd[0] >= 0) {
+    close (SavedFd[0]);
+  }
+  if (SavedFd[1] >= 0) {
+    close (SavedFd[1]);
+  }
+  if (*OutFile != NULL) {
+    fclose (*OutFile);
+    *OutFile = NULL;
+  }
+  if (*ErrFile != NULL) {
+    fclose (*ErrFile);
+    *ErrFile = NULL;
+  }
+  return FALSE;
+}
+
+/**
+  Restore the stdout and stderr saved by StartCapture().
+
+  @param  SavedFd   The duplicated original stdout and stderr.
+**/
+STATIC
+VOID
+StopCapture (
+  int   SavedFd[2]
+  )
+{
+  fflush (stdout);
+  fflush (stderr);
+  dup2 (SavedFd[0], fileno (stdout));
+  dup2 (SavedFd[1], fileno (stderr));
+  close (SavedFd[0]);
+  close (SavedFd[1]);
+}
+
+/**
+  Read back and close a temporary file filled by StartCapture().
+
+  @param  File      The temporary file, or NULL if nothing was captured.
+
+  @return A new Python string with the file contents, or NULL on error.
+**/
+STATIC
+PyObject*
+ReadCapture (
+  FILE  *File
+  )
+{
+  PyObject  *String;
+  long      Size;
+
+  if (File == NULL) {
+    return PyString_FromString ("");
+  }
+  String = NULL;
+  Size   = -1;
+  if (fseek (File, 0, SEEK_END) == 0) {
+    Size = ftell (File);
+  }
+  if (Size >= 0 && fseek (File, 0, SEEK_SET) == 0) {
+    String = PyString_FromStringAndSize (NULL, Size);
+    if (String != NULL &&
+        fread (PyString_AS_STRING (String), 1, (size_t) Size, File) != (size_t) Size) {
+      Py_DECREF (String);
+      String = NULL;
+    }
+  }
+  fclose (File);
+  if (String == NULL && !PyErr_Occurred ()) {
+    PyErr_SetString (PyExc_IOError, "Failed to read the tool output");
+  }
+  return String;
+}
+
+/*
+ RunBatch(CommandList)
+
+ CommandList is a list of command lines, each a list of strings starting with
+ the tool name. The commands run in order and the batch stops at the first
+ failure. Returns a tuple of the list of exit codes of the commands that ran
+ and the stdout and stderr text they printed. Files written by the commands
+ are also kept in memory for later commands, in this or a later batch, until
+ FreeFiles() is called.
+*/
+STATIC
+PyObject*
+RunBatch (
+  PyObject    *Self,
+  PyObject    *Args
+  )
+{
+  PyObject    *CommandList;
+  PyObject    *Command;
+  PyObject    *Item;
+  PyObject    *ReturnValue;
+  PyObject    *CodeList;
+  PyObject    *OutString;
+  PyObject    *ErrString;
+  Py_ssize_t  CommandNum;
+  Py_ssize_t  ArgNum;
+  Py_ssize_t  Index;
+  Py_ssize_t  ArgIndex;
+  Py_ssize_t  RunNum;
+  CHAR8       ***ArgvList;
+  TOOL_MAIN   *MainList;
+  int         *ExitCode;
+  FILE        *OutFile;
+  FILE        *ErrFile;
+  int         SavedFd[2];
+  BOOLEAN     Captured;
+
+  if (PyArg_ParseTuple (Args, "O!", &PyList_Type, &CommandList) == 0) {
+    return NULL;
+  }
+
+  //
+  // Convert the command lines while the interpreter lock is held.
+  //
+  CommandNum  = PyList_GET_SIZE (CommandList);
+  ArgvList    = calloc (CommandNum + 1, sizeof (CHAR8 **));
+  MainList    = calloc (CommandNum + 1, sizeof (TOOL_MAIN));
+  ExitCode    = calloc (CommandNum + 1, sizeof (int));
+  ReturnValue = NULL;
+  if (ArgvList == NULL || MainList == NULL || ExitCode == NULL) {
+    PyErr_NoMemory ();
+    goto Done;
+  }
+
+  for (Index = 0; Index < CommandNum; Index++) {
+    Command = PyList_GET_ITEM (CommandList, Index);
+    if (!PyList_Check (Command) || PyList_GET_SIZE (Command) == 0) {
+      PyErr_SetString (PyExc_TypeError, "Each command must be a non-empty list of strings");
+      goto Done;
+    }
+    ArgNum = PyList_GET_SIZE (Command);
+    ArgvList[Index] = calloc (ArgNum + 1, sizeof (CHAR8 *));
+    if (ArgvList[Index] == NULL) {
+      PyErr_NoMemory ();
+      goto Done;
+    }
+    for (ArgIndex = 0; ArgIndex < ArgNum; ArgIndex++) {
+      Item = PyList_GET_ITEM (Command, ArgIndex);
+      if (!PyString_Check (Item)) {
+        PyErr_SetString (PyExc_TypeError, "Each command must be a non-empty list of strings");
+        goto Done;
+      }
+      ArgvList[Index][ArgIndex] = strdup (PyString_AS_STRING (Item));
+      if (ArgvList[Index][ArgIndex] == NULL) {
+        PyErr_NoMemory ();
+        goto Done;
+      }
+    }
+    MainList[Index] = FindTool (ArgvList[Index][0]);
+    if (MainList[Index] == NULL) {
+      PyErr_Format (PyExc_ValueError, "%s is not supported by PyFvTools", ArgvList[Index][0]);
+      goto Done;
+    }
+  }
+
+  //
+  // Wait for the batch lock without the interpreter lock. The tools then run
+  // with the interpreter lock held: stdout and stderr are redirected for the
+  // whole process, and other Python threads must not print into the output
+  // captured for this batch.
+  //
+  RunNum = 0;
+  Py_BEGIN_ALLOW_THREADS
+  PyThread_acquire_lock (mBatchLock, WAIT_LOCK);
+  Py_END_ALLOW_THREADS
+  Captured = StartCapture (&OutFile, &ErrFile, SavedFd);
+  SetFileImageCache (TRUE);
+  for (Index = 0; Index < CommandNum; Index++) {
+    for (ArgNum = 0; ArgvList[Index][ArgNum] != NULL; ArgNum++);
+    ResetUtilityStatus ();
+    ExitCode[Index] = MainList[Index] ((int) ArgNum, ArgvList[Index]);
+    RunNum++;
+    if (ExitCode[Index] != 0) {
+      break;
+    }
+  }
+  ResetUtilityStatus ();
+  SetFileImageCache (FALSE);
+  if (Captured) {
+    StopCapture (SavedFd);
+  }
+  PyThread_release_lock (mBatchLock);
+
+  OutString = ReadCapture (OutFile);
+  ErrString = ReadCapture (ErrFile);
+  CodeList  = PyList_New (RunNum);
+  if (CodeList != NULL) {
+    for (Index = 0; Index < RunNum; Index++) {
+      PyList_SET_ITEM (CodeList, Index, PyInt_FromLong (ExitCode[Index]));
+    }
+  }
+  if (OutString != NULL && ErrString != NULL && CodeList != NULL) {
+    ReturnValue = Py_BuildValue ("(OOO)", CodeList, OutString, ErrString);
+  }
+  Py_XDECREF (CodeList);
+  Py_XDECREF (OutString);
+  Py_XDECREF (ErrString);
+
+Done:
+  if (ArgvList != NULL) {
+    FreeArgvList (ArgvList, CommandNum);
+  }
+  free (MainList);
+  free (ExitCode);
+  return ReturnValue;
+}
+
+/*
+ FreeFiles()
+
+ Free the files kept in memory by the previous batches.
+*/
+STATIC
+PyObject*
+FreeFiles (
+  PyObject    *Self,
+  PyObject    *Args
+  )
+{
+  Py_BEGIN_ALLOW_THREADS
+  PyThread_acquire_lock (mBatchLock, WAIT_LOCK);
+  FreeFileImageCache ();
+  PyThread_release_lock (mBatchLock);
+  Py_END_ALLOW_THREADS
+
+  Py_INCREF (Py_None);
+  return Py_None;
+}
+
+STATIC CHAR8 RunBatchDocs[] = "RunBatch(): Run a list of GenSec/GenFfs/GenFv command lines in process, returning (ExitCodes, Stdout, Stderr)\n";
+STATIC CHAR8 FreeFilesDocs[] = "FreeFiles(): Free the files kept in memory by RunBatch()\n";
+
+STATIC PyMethodDef PyFvTools_Funcs[] = {
+  {"RunBatch", (PyCFunction)RunBatch, METH_VARARGS, RunBatchDocs},
+  {"FreeFiles", (PyCFunction)FreeFiles, METH_NOARGS, FreeFilesDocs},
+  {NULL, NULL, 0, NULL}
+};
+
+PyMODINIT_FUNC
+initPyFvTools(VOID) {
+  mBatchLock = PyThread_allocate_lock ();
+  if (mBatchLock == NULL) {
+    return;
+  }
+  Py_InitModule3("PyFvTools", PyFvTools_Funcs, "Firmware Volume Tools Module Implemented C Language");
+}
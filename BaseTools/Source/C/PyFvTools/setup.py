@@ -0,0 +1,75 @@
+## @file
+# package and install PyFvTools extension
+#
+#  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+#
+#  This program and the accompanying materials
+#  are licensed and made available under the terms and conditions of the BSD License
+#  which accompanies this distribution.  The full text of the license may be found at
+#  http://opensource.org/licenses/bsd-license.php
+#
+#  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+#
+
+##
+# Import Modules
+#
+from distutils.core import setup, Extension
+import os
+import struct
+
+if 'BASE_TOOLS_PATH' not in os.environ:
+    raise "Please define BASE_TOOLS_PATH to the root of base tools tree"
+
+BaseToolsDir = os.environ['BASE_TOOLS_PATH']
+CommonDir = os.path.join(BaseToolsDir, 'Source', 'C', 'Common')
+if struct.calcsize('P') == 8:
+    HostArch = 'X64'
+else:
+    HostArch = 'Ia32'
+
+Libraries = []
+if os.name == 'posix':
+    Libraries.append('uuid')
+
+setup(
+    name="PyFvTools",
+    version="0.01",
+    ext_modules=[
+        Extension(
+            'PyFvTools',
+            sources=[
+                os.path.join(CommonDir, 'BasePeCoff.c'),
+                os.path.join(CommonDir, 'BinderFuncs.c'),
+                os.path.join(CommonDir, 'CommonLib.c'),
+                os.path.join(CommonDir, 'Crc32.c'),
+                os.path.join(CommonDir, 'Decompress.c'),
+                os.path.join(CommonDir, 'EfiCompress.c'),
+                os.path.join(CommonDir, 'EfiUtilityMsgs.c'),
+                os.path.join(CommonDir, 'FirmwareVolumeBuffer.c'),
+                os.path.join(CommonDir, 'FvLib.c'),
+                os.path.join(CommonDir, 'MemoryFile.c'),
+                os.path.join(CommonDir, 'MyAlloc.c'),
+                os.path.join(CommonDir, 'OsPath.c'),
+                os.path.join(CommonDir, 'ParseGuidedSectionTools.c'),
+                os.path.join(CommonDir, 'ParseInf.c'),
+                os.path.join(CommonDir, 'PeCoffLoaderEx.c'),
+                os.path.join(CommonDir, 'SimpleFileParsing.c'),
+                os.path.join(CommonDir, 'StringFuncs.c'),
+                os.path.join(CommonDir, 'TianoCompress.c'),
+                os.path.join(BaseToolsDir, 'Source', 'C', 'GenFv', 'GenFvInternalLib.c'),
+                'GenSecLib.c',
+                'GenFfsLib.c',
+                'GenFvLib.c',
+                'PyFvTools.c'
+                ],
+            include_dirs=[
+                os.path.join(BaseToolsDir, 'Source', 'C', 'Include'),
+                os.path.join(BaseToolsDir, 'Source', 'C', 'Include', HostArch),
+                CommonDir
+                ],
+            libraries=Libraries,
+            )
+        ],
+  )
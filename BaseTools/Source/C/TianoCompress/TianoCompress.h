@@ -120,43 +120,37 @@ InitSlide (
   VOID
   );
 
-STATIC
-NODE
-Child (
-  IN NODE   NodeQ,
-  IN UINT8  CharC
-  );
-
 STATIC
 VOID
-MakeChild (
-  IN NODE  NodeQ,
-  IN UINT8 CharC,
-  IN NODE  NodeR
+InsertNode (
+  VOID
   );
 
 STATIC
 VOID
-Split (
-  IN NODE Old
+SearchChain (
+  IN NODE   NodeR,
+  IN NODE   *Prev,
+  IN INT32  Chain
   );
 
 STATIC
 VOID
-InsertNode (
+FindMatch (
   VOID
   );
 
 STATIC
 VOID
-DeleteNode (
-  VOID
+RebaseChain (
+  IN OUT NODE   *Table,
+  IN     UINT32 Size
   );
 
 STATIC
 VOID
 GetNextMatch (
-  VOID
+  IN BOOLEAN Search
   );
 
 STATIC
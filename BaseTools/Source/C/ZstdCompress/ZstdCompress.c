@@ -0,0 +1,314 @@
+/** @file
+  Zstandard Compress/Decompress tool (ZstdCompress)
+
+  Based on the Zstandard library v1.5.7.
+  Zstandard was released on the website https://github.com/facebook/zstd.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zstd.h"
+#include "CommonLib.h"
+
+//
+// Level 19 is the highest level that does not need the "ultra" window sizes.
+// The firmware decompresses the whole frame in one call into the final
+// buffer, so the window size does not change the memory it needs.
+//
+#define ZSTD_DEFAULT_LEVEL  19
+
+const char *kCantReadMessage = "Can not read input file";
+const char *kCantWriteMessage = "Can not write output file";
+const char *kCantAllocateMessage = "Can not allocate memory";
+const char *kDataErrorMessage = "Data error";
+
+static int mQuietMode = 0;
+static int mLevel = ZSTD_DEFAULT_LEVEL;
+
+#define UTILITY_NAME "ZstdCompress"
+#define UTILITY_MAJOR_VERSION 0
+#define UTILITY_MINOR_VERSION 1
+#define INTEL_COPYRIGHT \
+  "Copyright (c) 2017, Intel Corporation. All rights reserved."
+void PrintHelp(char *buffer)
+{
+  strcat(buffer,
+      "\n" UTILITY_NAME " - " INTEL_COPYRIGHT "\n"
+      "Based on Zstandard library " ZSTD_VERSION_STRING "\n"
+      "\nUsage:  ZstdCompress -e|-d [options] <inputFile>\n"
+             "  -e: encode file\n"
+             "  -d: decode file\n"
+             "  -o FileName, --output FileName: specify the output filename\n"
+             "  -l Level, --level Level: compression level (1-22, default 19)\n"
+             "  -v, --verbose: increase output messages\n"
+             "  -q, --quiet: reduce output messages\n"
+             "  --debug [0-9]: set debug level\n"
+             "  --version: display the program version and exit\n"
+             "  -h, --help: display this help text\n"
+             );
+}
+
+int PrintError(char *buffer, const char *message)
+{
+  strcat(buffer, "\nError: ");
+  strcat(buffer, message);
+  strcat(buffer, "\n");
+  return 1;
+}
+
+int PrintUserError(char *buffer)
+{
+  return PrintError(buffer, "Incorrect command");
+}
+
+void PrintVersion(char *buffer)
+{
+  sprintf (buffer, "%s Version %d.%d %s ", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
+}
+
+static const char *ReadFile(const char *fileName, void **buffer, size_t *size)
+{
+  FILE *file;
+  long length;
+
+  *buffer = NULL;
+  *size = 0;
+
+  file = fopen(fileName, "rb");
+  if (file == NULL)
+    return "Can not open input file";
+
+  if (fseek(file, 0, SEEK_END) != 0 || (length = ftell(file)) < 0 ||
+      fseek(file, 0, SEEK_SET) != 0) {
+    fclose(file);
+    return kCantReadMessage;
+  }
+
+  //
+  // Allocate one extra byte so that an empty file still gets a buffer.
+  //
+  *buffer = malloc((size_t)length + 1);
+  if (*buffer == NULL) {
+    fclose(file);
+    return kCantAllocateMessage;
+  }
+
+  if (fread(*buffer, 1, (size_t)length, file) != (size_t)length) {
+    fclose(file);
+    return kCantReadMessage;
+  }
+
+  fclose(file);
+  *size = (size_t)length;
+  return NULL;
+}
+
+static const char *WriteFile(const char *fileName, const void *buffer, size_t size)
+{
+  FILE *file;
+
+  file = fopen(fileName, "wb");
+  if (file == NULL)
+    return "Can not open output file";
+
+  if (fwrite(buffer, 1, size, file) != size) {
+    fclose(file);
+    return kCantWriteMessage;
+  }
+
+  if (fclose(file) != 0)
+    return kCantWriteMessage;
+
+  return NULL;
+}
+
+static const char *Encode(const void *inBuffer, size_t inSize, void **outBuffer, size_t *outSize)
+{
+  ZSTD_CCtx *cctx;
+  size_t bound;
+  size_t res;
+
+  bound = ZSTD_compressBound(inSize);
+  *outBuffer = malloc(bound);
+  if (*outBuffer == NULL)
+    return kCantAllocateMessage;
+
+  cctx = ZSTD_createCCtx();
+  if (cctx == NULL)
+    return kCantAllocateMessage;
+
+  //
+  // The decompressor takes the output size from the frame header, so the
+  // content size must always be written. The checksum is left out, like the
+  // other section compression formats.
+  //
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, mLevel);
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_contentSizeFlag, 1);
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 0);
+  ZSTD_CCtx_setPledgedSrcSize(cctx, inSize);
+
+  res = ZSTD_compress2(cctx, *outBuffer, bound, inBuffer, inSize);
+  ZSTD_freeCCtx(cctx);
+  if (ZSTD_isError(res))
+    return ZSTD_getErrorName(res);
+
+  *outSize = res;
+  return NULL;
+}
+
+static const char *Decode(const void *inBuffer, size_t inSize, void **outBuffer, size_t *outSize)
+{
+  unsigned long long contentSize;
+  size_t res;
+
+  contentSize = ZSTD_getFrameContentSize(inBuffer, inSize);
+  if (contentSize == ZSTD_CONTENTSIZE_ERROR ||
+      contentSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+      contentSize != (size_t)contentSize)
+    return kDataErrorMessage;
+
+  *outBuffer = malloc((size_t)contentSize + 1);
+  if (*outBuffer == NULL)
+    return kCantAllocateMessage;
+
+  res = ZSTD_decompress(*outBuffer, (size_t)contentSize, inBuffer, inSize);
+  if (ZSTD_isError(res) || res != contentSize)
+    return kDataErrorMessage;
+
+  *outSize = res;
+  return NULL;
+}
+
+int main2(int numArgs, const char *args[], char *rs)
+{
+  int encodeMode = 0;
+  int modeWasSet = 0;
+  const char *inputFile = NULL;
+  const char *outputFile = "file.tmp";
+  const char *error;
+  int param;
+  void *inBuffer;
+  void *outBuffer;
+  size_t inSize;
+  size_t outSize;
+
+  if (numArgs == 1)
+  {
+    PrintHelp(rs);
+    return 0;
+  }
+
+  for (param = 1; param < numArgs; param++) {
+    if (strcmp(args[param], "-e") == 0 || strcmp(args[param], "-d") == 0) {
+      encodeMode = (args[param][1] == 'e');
+      modeWasSet = 1;
+    } else if (strcmp(args[param], "-l") == 0 ||
+               strcmp(args[param], "--level") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      mLevel = atoi(args[++param]);
+      if (mLevel < 1 || mLevel > ZSTD_maxCLevel()) {
+        return PrintUserError(rs);
+      }
+    } else if (strcmp(args[param], "-o") == 0 ||
+               strcmp(args[param], "--output") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      outputFile = args[++param];
+    } else if (strcmp(args[param], "--debug") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      //
+      // For now we silently ignore this parameter to achieve command line
+      // parameter compatibility with other build tools.
+      //
+      param++;
+    } else if (
+                strcmp(args[param], "-h") == 0 ||
+                strcmp(args[param], "--help") == 0
+              ) {
+      PrintHelp(rs);
+      return 0;
+    } else if (
+                strcmp(args[param], "-v") == 0 ||
+                strcmp(args[param], "--verbose") == 0
+              ) {
+      //
+      // For now we silently ignore this parameter to achieve command line
+      // parameter compatibility with other build tools.
+      //
+    } else if (
+                strcmp(args[param], "-q") == 0 ||
+                strcmp(args[param], "--quiet") == 0
+              ) {
+      mQuietMode = 1;
+    } else if (strcmp(args[param], "--version") == 0) {
+      PrintVersion(rs);
+      return 0;
+    } else if (inputFile == NULL) {
+      inputFile = args[param];
+    } else {
+      return PrintUserError(rs);
+    }
+  }
+
+  if ((inputFile == NULL) || !modeWasSet) {
+    return PrintUserError(rs);
+  }
+
+  outBuffer = NULL;
+  outSize = 0;
+  error = ReadFile(inputFile, &inBuffer, &inSize);
+  if (error == NULL) {
+    if (encodeMode) {
+      if (!mQuietMode) {
+        printf("Encoding\n");
+      }
+      error = Encode(inBuffer, inSize, &outBuffer, &outSize);
+    } else {
+      if (!mQuietMode) {
+        printf("Decoding\n");
+      }
+      error = Decode(inBuffer, inSize, &outBuffer, &outSize);
+    }
+  }
+
+  if (error == NULL) {
+    error = WriteFile(outputFile, outBuffer, outSize);
+  }
+
+  free(outBuffer);
+  free(inBuffer);
+
+  if (error != NULL) {
+    return PrintError(rs, error);
+  }
+  return 0;
+}
+
+int main(int numArgs, const char *args[])
+{
+  char rs[2000] = { 0 };
+  int res = main2(numArgs, args, rs);
+  if (strlen(rs) > 0) {
+    puts(rs);
+  }
+  return res;
+}
@@ -44,6 +44,10 @@ from Common.MultipleWorkspace import MultipleWorkspace as mws
 import InfSectionParser
 import datetime
 import hashlib
+import multiprocessing
+import sys
+import threading
+import traceback
 from GenVar import VariableMgr,var_info
 
 ## Regular expression for splitting Dependency Expression string into tokens
@@ -669,14 +673,6 @@ class WorkspaceAutoGen(AutoGen):
             Pa.CollectFixedAtBuildPcds()
             self.AutoGenObjectList.append(Pa)
 
-            #
-            # Generate Package level hash value
-            #
-            GlobalData.gPackageHash[Arch] = {}
-            if GlobalData.gUseHashCache:
-                for Pkg in Pkgs:
-                    self._GenPkgLevelHash(Pkg)
-
         #
         # Check PCDs token value conflict in each DEC file.
         #
@@ -727,25 +723,18 @@ class WorkspaceAutoGen(AutoGen):
         AllWorkSpaceMetaFiles = self._GetMetaFiles(Target, Toolchain, Arch)
 
         #
-        # Retrieve latest modified time of all metafiles
+        # Retrieve latest modified time of all metafiles, and the digest of their
+        # content which tells whether a newer metafile is really changed
         #
         SrcTimeStamp = 0
-        for f in AllWorkSpaceMetaFiles:
+        m = hashlib.md5()
+        for f in sorted(AllWorkSpaceMetaFiles):
             if os.stat(f)[8] > SrcTimeStamp:
                 SrcTimeStamp = os.stat(f)[8]
+            m.update(f)
+            m.update(str(GetFileDigest(f)))
         self._SrcTimeStamp = SrcTimeStamp
-
-        if GlobalData.gUseHashCache:
-            m = hashlib.md5()
-            for files in AllWorkSpaceMetaFiles:
-                if files.endswith('.dec'):
-                    continue
-                f = open(files, 'r')
-                Content = f.read()
-                f.close()
-                m.update(Content)
-            SaveFileOnChange(os.path.join(self.BuildDir, 'AutoGen.hash'), m.hexdigest(), True)
-            GlobalData.gPlatformHash = m.hexdigest()
+        self._SrcDigest = m.hexdigest()
 
         #
         # Write metafile list to build directory
@@ -760,30 +749,6 @@ class WorkspaceAutoGen(AutoGen):
                 print >> file, f
         return True
 
-    def _GenPkgLevelHash(self, Pkg):
-        PkgDir = os.path.join(self.BuildDir, Pkg.Arch, Pkg.PackageName)
-        CreateDirectory(PkgDir)
-        HashFile = os.path.join(PkgDir, Pkg.PackageName + '.hash')
-        m = hashlib.md5()
-        # Get .dec file's hash value
-        f = open(Pkg.MetaFile.Path, 'r')
-        Content = f.read()
-        f.close()
-        m.update(Content)
-        # Get include files hash value
-        if Pkg.Includes:
-            for inc in Pkg.Includes:
-                for Root, Dirs, Files in os.walk(str(inc)):
-                    for File in Files:
-                        File_Path = os.path.join(Root, File)
-                        f = open(File_Path, 'r')
-                        Content = f.read()
-                        f.close()
-                        m.update(Content)
-        SaveFileOnChange(HashFile, m.hexdigest(), True)
-        if Pkg.PackageName not in GlobalData.gPackageHash[Pkg.Arch]:
-            GlobalData.gPackageHash[Pkg.Arch][Pkg.PackageName] = m.hexdigest()
-
     def _GetMetaFiles(self, Target, Toolchain, Arch):
         AllWorkSpaceMetaFiles = set()
         #
@@ -1320,6 +1285,28 @@ class PlatformAutoGen(AutoGen):
         # don't do this twice
         self.IsCodeFileCreated = True
 
+    ## Create autogen code and makefile of modules with multiple processes
+    #
+    #  The modules are marked as done afterwards, so the following calls to
+    #  CreateCodeFile() and CreateMakeFile() will only generate the files of
+    #  the platform.
+    #
+    #   @param      CreateModuleCodeFile    Flag indicating if creating module's
+    #                                       autogen code file or not
+    #   @param      CreateModuleMakeFile    Flag indicating if creating module's
+    #                                       makefile or not
+    #   @param      FfsCommand              The GenFfs commands of the modules
+    #   @param      ProcessNumber           The maximum number of processes
+    #
+    def CreateModuleFiles(self, CreateModuleCodeFile, CreateModuleMakeFile, FfsCommand={}, ProcessNumber=1):
+        WorkList = []
+        for Ma in self.ModuleAutoGenList:
+            GenFfsList = []
+            if (Ma.MetaFile.File, self.Arch) in FfsCommand:
+                GenFfsList = FfsCommand[Ma.MetaFile.File, self.Arch]
+            WorkList.append((Ma, CreateModuleCodeFile, CreateModuleMakeFile, GenFfsList))
+        CreateModuleFiles(WorkList, ProcessNumber)
+
     ## Generate Fds Command
     def _GenFdsCommand(self):
         return self.Workspace.GenFdsCommand
@@ -1986,7 +1973,8 @@ class PlatformAutoGen(AutoGen):
                                 ExtraData="[%s]" % self.MetaFile)
             self._ToolDefinitions = {}
             DllPathList = set()
-            for Def in ToolDefinition:
+            # sorted, so that the order of tools doesn't depend on how the dictionary was built
+            for Def in sorted(ToolDefinition):
                 Target, Tag, Arch, Tool, Attr = Def.split("_")
                 if Target != self.BuildTarget or Tag != self.ToolChain or Arch != self.Arch:
                     continue
@@ -2853,6 +2841,151 @@ class PlatformAutoGen(AutoGen):
     LibraryAutoGenList  = property(_GetLibraryAutoGenList)
     GenFdsCommand       = property(_GenFdsCommand)
 
+## ModuleAutoGen objects whose files are generated by the worker processes
+#
+#  It's set before the worker processes are forked, so that they inherit all the
+#  parsed platform and module information and only the index of a module needs
+#  to be sent to them.
+#
+gModuleWorkList = []
+
+## Seconds to wait for the worker processes before the build is failed
+#
+#  A worker which is killed loses its module and the pool would wait forever.
+#
+gModuleFilesTimeout = 3600
+
+## The error of the initialization of a worker process, reported for every module
+#
+#  An exception raised by the initializer would make the pool start workers again
+#  and again, so it's reported by the modules instead.
+#
+gModuleWorkerError = None
+
+## Initialize a worker process
+#
+#   @param      DbPath      The path of the database file shared by the parent
+#
+def _InitModuleFilesWorker(DbPath):
+    global gModuleWorkerError
+    try:
+        gModuleWorkList[0][0].BuildDatabase.WorkspaceDb.Reconnect(DbPath)
+    except:
+        gModuleWorkerError = traceback.format_exc()
+
+## Generate the autogen code and makefile of one module in a worker process
+#
+#   @param      Index       The index of the module in gModuleWorkList
+#
+#   @retval     tuple       (Index, DepexGenerated, ErrorCode, ErrorInfo)
+#
+def _CreateModuleFilesWorker(Index):
+    if gModuleWorkerError:
+        return Index, False, CODE_ERROR, gModuleWorkerError
+    Ma, CreateCodeFile, CreateMakeFile, GenFfsList = gModuleWorkList[Index]
+    try:
+        if CreateCodeFile:
+            Ma.CreateCodeFile(False)
+        if CreateMakeFile:
+            Ma.CreateMakeFile(False, GenFfsList)
+    except FatalError, X:
+        return Index, False, X.args[0], None
+    except:
+        return Index, False, CODE_ERROR, traceback.format_exc()
+    return Index, Ma.DepexGenerated, 0, None
+
+## Generate the autogen code and makefile of modules with multiple processes
+#
+#  Once the platform has been processed, the files of a module only depend on
+#  the module itself, so the modules and libraries are handed out to a pool of
+#  forked processes. The generated files are the same as the ones generated by
+#  a single process. Nothing is done if there's only one process to use or the
+#  system can't fork, and the files are then generated in the usual way.
+#
+#   @param      WorkList        List of (ModuleAutoGen, CreateCodeFile,
+#                               CreateMakeFile, GenFfsList)
+#   @param      ProcessNumber   The maximum number of processes
+#
+def CreateModuleFiles(WorkList, ProcessNumber):
+    global gModuleWorkList
+
+    if ProcessNumber < 2 or os.name != 'posix':
+        return
+
+    #
+    # Each library is generated only once, no matter how many modules use it.
+    # Binary modules and the modules which are up to date are left to the
+    # caller because there's little to do for them.
+    #
+    PendingList = []
+    PendingSet = set()
+    for Ma, CreateCodeFile, CreateMakeFile, GenFfsList in WorkList:
+        ModuleList = [(La, []) for La in Ma.LibraryAutoGenList] + [(Ma, GenFfsList)]
+        for Module, FfsList in ModuleList:
+            if Module in PendingSet or Module.IsBinaryModule or Module.CanSkip():
+                continue
+            CreateCode = CreateCodeFile and not Module.IsCodeFileCreated
+            CreateMake = CreateMakeFile and not Module.IsMakeFileCreated
+            if not CreateCode and not CreateMake:
+                continue
+            PendingSet.add(Module)
+            PendingList.append((Module, CreateCode, CreateMake, FfsList))
+    if len(PendingList) < 2:
+        return
+
+    #
+    # fork() copies only the calling thread. A lock held by another thread at
+    # that time, stdout's for example, would stay locked in the workers.
+    #
+    if threading.active_count() > 1:
+        EdkLogger.verbose("Other threads are running, module files are generated in one process")
+        return
+
+    # workers open their own connection to the database
+    WorkspaceDb = PendingList[0][0].BuildDatabase.WorkspaceDb
+    DbPath = WorkspaceDb.BeginShare()
+    if DbPath == None:
+        WorkspaceDb.EndShare()
+        return
+    sys.stdout.flush()
+    sys.stderr.flush()
+
+    gModuleWorkList = PendingList
+    try:
+        Pool = multiprocessing.Pool(min(ProcessNumber, len(PendingList)), _InitModuleFilesWorker, (DbPath,))
+        try:
+            ResultList = Pool.map_async(_CreateModuleFilesWorker, range(len(PendingList)), 1).get(gModuleFilesTimeout)
+        except multiprocessing.TimeoutError:
+            Pool.terminate()
+            EdkLogger.error("autogen", IO_TIMEOUT, "Module files were not generated in %d seconds" % gModuleFilesTimeout)
+        except:
+            Pool.terminate()
+            raise
+        finally:
+            Pool.close()
+            Pool.join()
+    finally:
+        gModuleWorkList = []
+        WorkspaceDb.EndShare()
+
+    for Index, DepexGenerated, ErrorCode, ErrorInfo in ResultList:
+        if not ErrorCode:
+            continue
+        if ErrorInfo:
+            EdkLogger.error("autogen", ErrorCode, "Failed to generate files of module",
+                            File=str(PendingList[Index][0].MetaFile), ExtraData=ErrorInfo)
+        # the worker has reported the error
+        raise FatalError(ErrorCode)
+
+    for Index, DepexGenerated, ErrorCode, ErrorInfo in ResultList:
+        Ma, CreateCode, CreateMake, GenFfsList = PendingList[Index]
+        if CreateCode:
+            Ma.IsCodeFileCreated = True
+            Ma.DepexGenerated = DepexGenerated
+        if CreateMake:
+            Ma.GenFfsList = GenFfsList
+            Ma.IsMakeFileCreated = True
+
 ## ModuleAutoGen class
 #
 # This class encapsules the AutoGen behaviors for the build tools. In addition to
@@ -2968,6 +3101,8 @@ class ModuleAutoGen(AutoGen):
         self._BuildRules              = None
 
         self._TimeStampPath           = None
+        self._CanSkip                 = None
+        self._ModuleHash              = None
 
         self.AutoGenDepSet = set()
 
@@ -4366,13 +4501,31 @@ class ModuleAutoGen(AutoGen):
         if GlobalData.gBinCacheDest:
             self.CopyModuleToCache()
 
+    ## Return the binary cache directory of the module for the given cache root
+    #
+    def _GetModuleCacheDir(self, CacheRoot):
+        return path.join(CacheRoot, self.Arch, self.SourceDir, self.MetaFile.BaseName, self.ModuleHash)
+
+    ## Copy the binaries of the module to the binary cache
+    #
+    #   Only a module whose build directory holds the hash of its current inputs
+    #   is copied. The hash file is copied last, so that an entry without it is
+    #   never taken as complete.
+    #
     def CopyModuleToCache(self):
-        FileDir = path.join(GlobalData.gBinCacheDest, self.Arch, self.SourceDir, self.MetaFile.BaseName)
+        if self.IsBinaryModule or not self.ModuleHash:
+            return
+        HashFile = self._GetModuleHashFile()
+        if not os.path.exists(HashFile):
+            return
+        with open(HashFile, 'r') as f:
+            if f.read() != self.ModuleHash:
+                return
+        FileDir = self._GetModuleCacheDir(GlobalData.gBinCacheDest)
+        if os.path.exists(path.join(FileDir, self.Name + '.hash')):
+            return
         CreateDirectory (FileDir)
-        HashFile = path.join(self.BuildDir, self.Name + '.hash')
         ModuleFile = path.join(self.OutputDir, self.Name + '.inf')
-        if os.path.exists(HashFile):
-            shutil.copy2(HashFile, FileDir)
         if os.path.exists(ModuleFile):
             shutil.copy2(ModuleFile, FileDir)
         if not self.OutputFile:
@@ -4385,29 +4538,30 @@ class ModuleAutoGen(AutoGen):
                     File = os.path.join(self.OutputDir, File)
                 if os.path.exists(File):
                     shutil.copy2(File, FileDir)
+        shutil.copy2(HashFile, FileDir)
 
+    ## Restore the binaries of the module from the binary cache
+    #
+    #   @retval     True        The binaries with the same module hash were restored
+    #   @retval     False       The binary cache has no entry for the module hash
+    #
     def AttemptModuleCacheCopy(self):
-        if self.IsBinaryModule:
+        if self.IsBinaryModule or not self.ModuleHash:
             return False
-        FileDir = path.join(GlobalData.gBinCacheSource, self.Arch, self.SourceDir, self.MetaFile.BaseName)
+        FileDir = self._GetModuleCacheDir(GlobalData.gBinCacheSource)
         HashFile = path.join(FileDir, self.Name + '.hash')
-        if os.path.exists(HashFile):
-            f = open(HashFile, 'r')
-            CacheHash = f.read()
-            f.close()
-            if GlobalData.gModuleHash[self.Arch][self.Name]:
-                if CacheHash == GlobalData.gModuleHash[self.Arch][self.Name]:
-                    for root, dir, files in os.walk(FileDir):
-                        for f in files:
-                            if self.Name + '.hash' in f:
-                                shutil.copy2(HashFile, self.BuildDir)
-                            else:
-                                File = path.join(root, f)
-                                shutil.copy2(File, self.OutputDir)
-                    if self.Name == "PcdPeim" or self.Name == "PcdDxe":
-                        CreatePcdDatabaseCode(self, TemplateString(), TemplateString())
-                    return True
-        return False
+        if not os.path.exists(HashFile):
+            return False
+        with open(HashFile, 'r') as f:
+            if f.read() != self.ModuleHash:
+                return False
+        CreateDirectory(self.OutputDir)
+        for File in os.listdir(FileDir):
+            if File == self.Name + '.hash':
+                continue
+            shutil.copy2(path.join(FileDir, File), self.OutputDir)
+        shutil.copy2(HashFile, self.BuildDir)
+        return True
 
     ## Create makefile for the module and its dependent libraries
     #
@@ -4427,6 +4581,7 @@ class ModuleAutoGen(AutoGen):
                 LibraryAutoGen.CreateMakeFile()
 
         if self.CanSkip():
+            self.IsMakeFileCreated = True
             return
 
         if len(self.CustomMakefile) == 0:
@@ -4471,6 +4626,7 @@ class ModuleAutoGen(AutoGen):
                 LibraryAutoGen.CreateCodeFile()
 
         if self.CanSkip():
+            self.IsCodeFileCreated = True
             return
 
         AutoGenList = []
@@ -4538,74 +4694,155 @@ class ModuleAutoGen(AutoGen):
                         self._ApplyBuildRule(Lib.Target, TAB_UNKNOWN_FILE)
         return self._LibraryAutoGenList
 
-    def GenModuleHash(self):
-        if self.Arch not in GlobalData.gModuleHash:
-            GlobalData.gModuleHash[self.Arch] = {}
-        m = hashlib.md5()
-        # Add Platform level hash
-        m.update(GlobalData.gPlatformHash)
-        # Add Package level hash
-        if self.DependentPackageList:
-            for Pkg in self.DependentPackageList:
-                if Pkg.PackageName in GlobalData.gPackageHash[self.Arch]:
-                    m.update(GlobalData.gPackageHash[self.Arch][Pkg.PackageName])
-
-        # Add Library hash
-        if self.LibraryAutoGenList:
+    ## Return the hash of everything the module binaries are built from
+    #
+    #   The hash covers the tool chain, the build options and build rules, the
+    #   content of every file the AutoGen dependency scan found (INF, sources,
+    #   included headers and library INFs), the generated AutoGen files (which
+    #   carry the PCD values, GUIDs and depex of this platform) and the hashes
+    #   of all library instances. File locations are not part of the hash, so
+    #   the same module built for another platform with identical inputs gets
+    #   the same value.
+    #
+    #   @retval     string      The md5 hex digest of the module
+    #   @retval     None        The AutoGen files of the module are not available
+    #
+    def _GetModuleHash(self):
+        if self._ModuleHash == None:
+            if not os.path.exists(self.GetTimeStampPath()):
+                return None
+            m = hashlib.md5()
+            m.update('%s|%s|%s\n' % (self.BuildTarget, self.ToolChain, self.Arch))
+            for Tool in sorted(self.BuildOption):
+                for Attr in sorted(self.BuildOption[Tool]):
+                    m.update('%s_%s=%s\n' % (Tool, Attr, self.BuildOption[Tool][Attr]))
+            m.update(GetFileDigest(os.path.join(GlobalData.gConfDirectory, gDefaultBuildRuleFile)) or '')
+
+            SourceList = []
+            with open(self.GetTimeStampPath(), 'r') as f:
+                for Line in f:
+                    Line = Line.rstrip('\n')
+                    if not Line or Line.startswith('#'):
+                        continue
+                    Source, Sep, Digest = Line.rpartition('|')
+                    if not Sep or not Digest:
+                        return None
+                    SourceList.append((os.path.basename(Source), Digest))
+            for Source, Digest in sorted(SourceList):
+                m.update('%s|%s\n' % (Source, Digest))
+
+            AutoGenFileList = [
+                os.path.join(self.DebugDir, gAutoGenCodeFileName),
+                os.path.join(self.DebugDir, gAutoGenHeaderFileName),
+                os.path.join(self.DebugDir, gAutoGenStringFileName % {"module_name" : self.Name}),
+                os.path.join(self.DebugDir, gAutoGenImageDefFileName % {"module_name" : self.Name}),
+                os.path.join(self.OutputDir, gAutoGenStringFormFileName % {"module_name" : self.Name}),
+                os.path.join(self.OutputDir, gAutoGenIdfFileName % {"module_name" : self.Name}),
+                os.path.join(self.OutputDir, gAutoGenDepexFileName % {"module_name" : self.Name})
+                ]
+            for File in AutoGenFileList:
+                Digest = GetFileDigest(File)
+                if Digest:
+                    m.update('%s|%s\n' % (os.path.basename(File), Digest))
+
             for Lib in self.LibraryAutoGenList:
-                if Lib.Name not in GlobalData.gModuleHash[self.Arch]:
-                    Lib.GenModuleHash()
-                m.update(GlobalData.gModuleHash[self.Arch][Lib.Name])
-
-        # Add Module self
-        f = open(str(self.MetaFile), 'r')
-        Content = f.read()
-        f.close()
-        m.update(Content)
-        # Add Module's source files
-        if self.SourceFileList:
-            for File in self.SourceFileList:
-                f = open(str(File), 'r')
-                Content = f.read()
-                f.close()
-                m.update(Content)
-
-        ModuleHashFile = path.join(self.BuildDir, self.Name + ".hash")
-        if self.Name not in GlobalData.gModuleHash[self.Arch]:
-            GlobalData.gModuleHash[self.Arch][self.Name] = m.hexdigest()
-        if GlobalData.gBinCacheSource:
-            CacheValid = self.AttemptModuleCacheCopy()
-            if CacheValid:
-                return False
-        return SaveFileOnChange(ModuleHashFile, m.hexdigest(), True)
+                LibHash = Lib.ModuleHash
+                if LibHash == None:
+                    return None
+                m.update('%s|%s\n' % (Lib.MetaFile.BaseName, LibHash))
+            self._ModuleHash = m.hexdigest()
+        return self._ModuleHash
 
-    ## Decide whether we can skip the ModuleAutoGen process
+    def _GetModuleHashFile(self):
+        return path.join(self.BuildDir, self.Name + '.hash')
+
+    ## Save the module hash after the module has been built successfully
+    #
+    def SaveModuleHash(self):
+        if not GlobalData.gUseHashCache or self.IsBinaryModule:
+            return
+        if self.ModuleHash:
+            SaveFileOnChange(self._GetModuleHashFile(), self.ModuleHash, False)
+
+    ## Decide whether the module build can be skipped by its hash
+    #
+    #   The module is skipped if its binaries can be restored from the binary
+    #   cache, or if the last successful build in the build directory was made
+    #   from the same inputs. It must be called after the AutoGen files of the
+    #   module have been created.
+    #
     def CanSkipbyHash(self):
-        if GlobalData.gUseHashCache:
-            return not self.GenModuleHash()
+        if not GlobalData.gUseHashCache or self.IsBinaryModule:
+            return False
+        if not self.ModuleHash:
+            return False
+        if GlobalData.gBinCacheSource and self.AttemptModuleCacheCopy():
+            return True
+        HashFile = self._GetModuleHashFile()
+        if os.path.exists(HashFile):
+            with open(HashFile, 'r') as f:
+                BuiltHash = f.read()
+            if BuiltHash == self.ModuleHash and os.path.exists(path.join(self.OutputDir, self.Name + '.inf')):
+                return True
+            #
+            # The binaries no longer match the module, don't let them be cached
+            # if this build fails
+            #
+            os.remove(HashFile)
+        return False
 
     ## Decide whether we can skip the ModuleAutoGen process
-    #  If any source file is newer than the module than we cannot skip
+    #  If any source file is newer than the module and its content is different
+    #  from the one the module was generated from, then we cannot skip
     #
     def CanSkip(self):
+        if self._CanSkip == None:
+            self._CanSkip = self._CheckTimeStamp()
+        return self._CanSkip
+
+    def _CheckTimeStamp(self):
         if not os.path.exists(self.GetTimeStampPath()):
             return False
         #last creation time of the module
         DstTimeStamp = os.stat(self.GetTimeStampPath())[8]
 
+        PlatformDigest = None
+        SourceList = []
+        with open(self.GetTimeStampPath(),'r') as f:
+            for Line in f:
+                Line = Line.rstrip('\n')
+                if Line.startswith('#'):
+                    PlatformDigest = Line[1:]
+                    continue
+                # old time stamp file has no digest
+                Source, Sep, Digest = Line.rpartition('|')
+                if not Sep:
+                    Source, Digest = Line, ''
+                SourceList.append((Source, Digest))
+
+        Touched = False
         SrcTimeStamp = self.Workspace._SrcTimeStamp
         if SrcTimeStamp > DstTimeStamp:
-            return False
+            if PlatformDigest != self.Workspace._SrcDigest:
+                return False
+            Touched = True
 
-        with open(self.GetTimeStampPath(),'r') as f:
-            for source in f:
-                source = source.rstrip('\n')
-                if not os.path.exists(source):
-                    return False
-                if source not in ModuleAutoGen.TimeDict :
-                    ModuleAutoGen.TimeDict[source] = os.stat(source)[8]
-                if ModuleAutoGen.TimeDict[source] > DstTimeStamp:
+        for source, Digest in SourceList:
+            if not os.path.exists(source):
+                return False
+            if source not in ModuleAutoGen.TimeDict :
+                ModuleAutoGen.TimeDict[source] = os.stat(source)[8]
+            if ModuleAutoGen.TimeDict[source] > DstTimeStamp:
+                if not Digest or GetFileDigest(source) != Digest:
                     return False
+                Touched = True
+
+        #
+        # Everything newer than the time stamp file has the same content as last
+        # time, so refresh the time stamp to avoid checking the content again
+        #
+        if Touched:
+            os.utime(self.GetTimeStampPath(), None)
         return True
 
     def GetTimeStampPath(self):
@@ -4630,10 +4867,12 @@ class ModuleAutoGen(AutoGen):
         if os.path.exists (self.GetTimeStampPath()):
             os.remove (self.GetTimeStampPath())
         with open(self.GetTimeStampPath(), 'w+') as file:
-            for f in FileSet:
-                print >> file, f
+            print >> file, '#' + self.Workspace._SrcDigest
+            for f in sorted(FileSet):
+                print >> file, '%s|%s' % (f, GetFileDigest(f) or '')
 
     Module          = property(_GetModule)
+    ModuleHash      = property(_GetModuleHash)
     Name            = property(_GetBaseName)
     Guid            = property(_GetGuid)
     Version         = property(_GetVersion)
@@ -98,7 +98,4 @@ gConditionalPcds = []
 gUseHashCache = None
 gBinCacheDest = None
 gBinCacheSource = None
-gPlatformHash = None
-gPackageHash = {}
-gModuleHash = {}
 gEnableGenfdsMultiThread = False
@@ -23,6 +23,7 @@ import time
 import re
 import cPickle
 import array
+import hashlib
 import shutil
 from struct import pack
 from UserDict import IterableUserDict
@@ -45,6 +46,9 @@ gPlaceholderPattern = re.compile("\$\{([^$()\s]+)\}", re.MULTILINE | re.UNICODE)
 ## Dictionary used to store file time stamp for quick re-access
 gFileTimeStampCache = {}    # {file path : file time stamp}
 
+## Dictionary used to store file content digest for quick re-access
+gFileDigestCache = {}       # {file path : (file time stamp, file digest)}
+
 ## Dictionary used to store dependencies of files
 gDependencyDatabase = {}    # arch : {file path : [dependent files list]}
 
@@ -476,6 +480,34 @@ def IsChanged(File):
 
     return FileChanged
 
+## Get the digest of the content of given file
+#
+#  The digest is cached together with the time stamp of the file so that each
+#  file is read at most once per build, no matter how many modules refer to it.
+#
+#   @param      File    The path of file
+#
+#   @retval     string  The md5 digest of the file content in hex form
+#   @retval     None    If the given file doesn't exist or can't be read
+#
+def GetFileDigest(File):
+    try:
+        TimeStamp = os.stat(File)[8]
+    except OSError:
+        return None
+
+    if File in gFileDigestCache and gFileDigestCache[File][0] == TimeStamp:
+        return gFileDigestCache[File][1]
+
+    try:
+        with open(File, 'rb') as Fd:
+            Digest = hashlib.md5(Fd.read()).hexdigest()
+    except IOError:
+        return None
+
+    gFileDigestCache[File] = (TimeStamp, Digest)
+    return Digest
+
 ## Store content in file
 #
 #  This method is used to save file only when its content is changed. This is
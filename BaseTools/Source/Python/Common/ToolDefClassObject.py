@@ -16,6 +16,7 @@
 #
 import Common.LongFilePathOs as os
 import re
+import cPickle
 import EdkLogger
 
 from Dictionary import *
@@ -23,6 +24,7 @@ from BuildToolError import *
 from TargetTxtClassObject import *
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from Common.Misc import PathClass
+from Common.Misc import GetFileDigest
 from Common.String import NormPath
 import Common.GlobalData as GlobalData
 from Common import GlobalData
@@ -35,6 +37,8 @@ gMacroRefPattern = re.compile('(DEF\([^\(\)]+\))')
 gEnvRefPattern = re.compile('(ENV\([^\(\)]+\))')
 gMacroDefPattern = re.compile("DEFINE\s+([^\s]+)")
 gDefaultToolsDefFile = "tools_def.txt"
+gToolsDefCacheFile = "ToolsDef.cache"
+gToolsDefCacheVersion = 1
 
 ## ToolDefClassObject
 #
@@ -50,6 +54,8 @@ class ToolDefClassObject(object):
     def __init__(self, FileName=None):
         self.ToolsDefTxtDictionary = {}
         self.MacroDictionary = {}
+        self._FileDigestList = []
+        self._EnvReference = {}
         for Env in os.environ:
             self.MacroDictionary["ENV(%s)" % Env] = os.environ[Env]
 
@@ -67,6 +73,12 @@ class ToolDefClassObject(object):
         PackagesPath = os.getenv("PACKAGES_PATH")
         mws.setWs(GlobalData.gWorkspace, PackagesPath)
 
+        CacheKey = (gToolsDefCacheVersion, FileName, GlobalData.gWorkspace, PackagesPath)
+        if self._LoadCache(CacheKey):
+            return
+
+        self._FileDigestList = []
+        self._EnvReference = {}
         self.ToolsDefTxtDatabase = {
             TAB_TOD_DEFINES_TARGET          :   [],
             TAB_TOD_DEFINES_TOOL_CHAIN_TAG  :   [],
@@ -102,6 +114,74 @@ class ToolDefClassObject(object):
                 elif List[Index] not in self.ToolsDefTxtDatabase[KeyList[Index]]:
                     del self.ToolsDefTxtDictionary[Key]
 
+        self._SaveCache(CacheKey)
+
+    ## Get the path of the parsed tools_def.txt cache
+    #
+    # @retval string  The cache file path in Conf/.cache, or None if the Conf
+    #                 directory is not known
+    #
+    def _GetCachePath(self):
+        if not GlobalData.gConfDirectory:
+            return None
+        return os.path.join(GlobalData.gConfDirectory, '.cache', gToolsDefCacheFile)
+
+    ## Load the parsed result of tools_def.txt from the cache of last build
+    #
+    # The cache is only used if the content of tools_def.txt and all files it
+    # includes, and the value of all environment variables it refers to, are
+    # the same as when the cache was saved.
+    #
+    # @param CacheKey:  The file name and workspace settings of this parse
+    #
+    # @retval True      The cache was valid and loaded
+    # @retval False     tools_def.txt needs to be parsed
+    #
+    def _LoadCache(self, CacheKey):
+        CachePath = self._GetCachePath()
+        if not CachePath or not os.path.isfile(CachePath):
+            return False
+        try:
+            with open(CachePath, 'rb') as Fd:
+                Cache = cPickle.load(Fd)
+            Key, FileDigestList, EnvReference, Macros, Dictionary, Database = Cache
+        except Exception, Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
+            return False
+
+        if Key != CacheKey:
+            return False
+        for File, Digest in FileDigestList:
+            if GetFileDigest(File) != Digest:
+                return False
+        for Ref in EnvReference:
+            if self._GetEnvValue(Ref) != EnvReference[Ref]:
+                return False
+
+        self.MacroDictionary.update(Macros)
+        self.ToolsDefTxtDictionary = Dictionary
+        self.ToolsDefTxtDatabase = Database
+        return True
+
+    ## Save the parsed result of tools_def.txt for next build
+    #
+    # @param CacheKey:  The file name and workspace settings of this parse
+    #
+    def _SaveCache(self, CacheKey):
+        CachePath = self._GetCachePath()
+        if not CachePath:
+            return
+        Macros = dict([(Name, Value) for (Name, Value) in self.MacroDictionary.items() if Name.startswith("DEF(")])
+        Cache = (CacheKey, self._FileDigestList, self._EnvReference, Macros,
+                 self.ToolsDefTxtDictionary, self.ToolsDefTxtDatabase)
+        try:
+            if not os.path.exists(os.path.dirname(CachePath)):
+                os.makedirs(os.path.dirname(CachePath))
+            with open(CachePath, 'wb') as Fd:
+                cPickle.dump(Cache, Fd, cPickle.HIGHEST_PROTOCOL)
+        except Exception, Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
+
 
     ## IncludeToolDefFile
     #
@@ -119,6 +199,7 @@ class ToolDefClassObject(object):
                 EdkLogger.error("tools_def.txt parser", FILE_OPEN_FAILURE, ExtraData=FileName)
         else:
             EdkLogger.error("tools_def.txt parser", FILE_NOT_FOUND, ExtraData=FileName)
+        self._FileDigestList.append((FileName, GetFileDigest(FileName)))
 
         for Index in range(len(FileContent)):
             Line = FileContent[Index].strip()
@@ -239,13 +320,12 @@ class ToolDefClassObject(object):
         # os.environ contains all environment variables uppercase on Windows which cause the key in the self.MacroDictionary is uppercase, but Ref may not
         EnvReference = gEnvRefPattern.findall(Value)
         for Ref in EnvReference:
-            if Ref not in self.MacroDictionary and Ref.upper() not in self.MacroDictionary:
+            EnvValue = self._GetEnvValue(Ref)
+            self._EnvReference[Ref] = EnvValue
+            if EnvValue == None:
                 Value = Value.replace(Ref, "")
             else:
-                if Ref in self.MacroDictionary:
-                    Value = Value.replace(Ref, self.MacroDictionary[Ref])
-                else:
-                    Value = Value.replace(Ref, self.MacroDictionary[Ref.upper()])
+                Value = Value.replace(Ref, EnvValue)
         MacroReference = gMacroRefPattern.findall(Value)
         for Ref in MacroReference:
             if Ref not in self.MacroDictionary:
@@ -254,6 +334,19 @@ class ToolDefClassObject(object):
 
         return True, Value
 
+    ## Get the value of an environment variable reference
+    #
+    # @param Ref:     The reference in ENV(name) form
+    #
+    # @retval Value:  The value of the environment variable, or None if it is not defined
+    #
+    def _GetEnvValue(self, Ref):
+        if Ref in self.MacroDictionary:
+            return self.MacroDictionary[Ref]
+        if Ref.upper() in self.MacroDictionary:
+            return self.MacroDictionary[Ref.upper()]
+        return None
+
 ## ToolDefDict
 #
 # Load tools_def.txt in input Conf dir
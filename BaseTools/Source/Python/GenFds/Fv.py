@@ -115,6 +115,8 @@ class FV (FvClassObject):
                                             T_CHAR_LF)
 
         # Process Modules in FfsList
+        if not Flag:
+            GenFdsGlobalVariable.BeginDeferredTools()
         for FfsFile in self.FfsList :
             if Flag:
                 if isinstance(FfsFile, FfsFileStatement.FileStatement):
@@ -128,6 +130,7 @@ class FV (FvClassObject):
                                             FileName          + \
                                             T_CHAR_LF)
         if not Flag:
+            GenFdsGlobalVariable.EndDeferredTools()
             SaveFileOnChange(self.InfFileName, self.FvInfFile.getvalue(), False)
             self.FvInfFile.close()
         #
@@ -17,6 +17,7 @@
 #
 from optparse import OptionParser
 import sys
+import multiprocessing
 import Common.LongFilePathOs as os
 import linecache
 import FdfParser
@@ -183,9 +184,22 @@ def main():
                 if len(ToolChainList) != 1:
                     EdkLogger.error("GenFds", OPTION_VALUE_INVALID, ExtraData="Only allows one instance for ToolChain.")
                 GenFdsGlobalVariable.ToolChainTag = ToolChainList[0]
+
+            # if no thread number given in command line, get it from target.txt
+            if Options.ThreadNumber == None:
+                ThreadNumber = TargetTxt.TargetTxtDictionary[DataType.TAB_TAT_DEFINES_MAX_CONCURRENT_THREAD_NUMBER]
+                if ThreadNumber:
+                    Options.ThreadNumber = int(ThreadNumber, 0)
         else:
             EdkLogger.error("GenFds", FILE_NOT_FOUND, ExtraData=BuildConfigurationFile)
 
+        if not Options.ThreadNumber:
+            try:
+                Options.ThreadNumber = multiprocessing.cpu_count()
+            except (ImportError, NotImplementedError):
+                Options.ThreadNumber = 1
+        GenFdsGlobalVariable.ThreadNumber = Options.ThreadNumber
+
         #Set global flag for build mode
         GlobalData.gIgnoreSource = Options.IgnoreSources
 
@@ -424,7 +438,10 @@ def CheckBuildOptionPcd():
 #  @param  NameGuid         The Guid name
 #
 def FindExtendTool(KeyStringList, CurrentArchList, NameGuid):
-    ToolDb = ToolDefClassObject.ToolDefDict(GenFdsGlobalVariable.ConfDir).ToolsDefTxtDatabase
+    # tools_def.txt is only loaded once for all GUIDed sections
+    if GenFdsGlobalVariable.ToolDef == None:
+        GenFdsGlobalVariable.ToolDef = ToolDefClassObject.ToolDefDict(GenFdsGlobalVariable.ConfDir)
+    ToolDb = GenFdsGlobalVariable.ToolDef.ToolsDefTxtDatabase
     # if user not specify filter, try to deduce it from global data.
     if KeyStringList == None or KeyStringList == []:
         Target = GenFdsGlobalVariable.TargetName
@@ -440,7 +457,7 @@ def FindExtendTool(KeyStringList, CurrentArchList, NameGuid):
         if NameGuid in GenFdsGlobalVariable.GuidToolDefinition.keys():
             return GenFdsGlobalVariable.GuidToolDefinition[NameGuid]
 
-    ToolDefinition = ToolDefClassObject.ToolDefDict(GenFdsGlobalVariable.ConfDir).ToolsDefTxtDictionary
+    ToolDefinition = GenFdsGlobalVariable.ToolDef.ToolsDefTxtDictionary
     ToolPathTmp = None
     ToolOption = None
     ToolPathKey = None
@@ -541,6 +558,7 @@ def myOptionParser():
     Parser.add_option("--ignore-sources", action="store_true", dest="IgnoreSources", default=False, help="Focus to a binary build and ignore all source files")
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=False, help="Enable GenFds multi thread to generate ffs file.")
+    Parser.add_option("-n", "--thread-number", action="store", type="int", dest="ThreadNumber", help="Number of threads running GenSec and GenFfs in parallel. The value overrides target.txt's MAX_CONCURRENT_THREAD_NUMBER. Less than 2 will disable parallel section generation.")
 
     (Options, args) = Parser.parse_args()
     return Options
@@ -18,8 +18,12 @@
 import Common.LongFilePathOs as os
 import sys
 import subprocess
+import shlex
 import struct
 import array
+import threading
+import hashlib
+import Queue
 
 from Common.BuildToolError import *
 from Common import EdkLogger
@@ -33,6 +37,36 @@ from Common.Misc import PathClass
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from Common.MultipleWorkspace import MultipleWorkspace as mws
 
+#
+# GenSec, GenFfs and GenFv are run in process when the PyFvTools extension is
+# available, so that they don't read back the files written by each other.
+#
+try:
+    import PyFvTools
+except ImportError:
+    PyFvTools = None
+
+## External tool invocation
+#
+#   A tool command together with the files it reads and the file it writes, so
+#   that it can be run on a worker thread once the tools producing its inputs
+#   have completed.
+#
+class ToolJob:
+    def __init__(self, Cmd, ErrorMess, Input=None, Output=None, FlagIndex=None):
+        self.Cmd = Cmd
+        self.ErrorMess = ErrorMess
+        self.Input = Input
+        self.Output = Output
+        self.FlagIndex = FlagIndex
+        self.DependList = []
+        self.Done = threading.Event()
+        self.ReturnCode = None
+        self.Out = ''
+        self.Error = ''
+        self.Exception = None
+        self.FailedJob = None
+
 ## Global variables
 #
 #
@@ -69,11 +103,26 @@ class GenFdsGlobalVariable:
     ToolChainFamily = "MSFT"
     __BuildRuleDatabase = None
     GuidToolDefinition = {}
+    ToolDef = None
     FfsCmdDict = {}
     SecCmdList = []
     CopyList   = []
     ModuleFile = ''
     EnableGenfdsMultiThread = False
+
+    #
+    # GenSec and GenFfs calls made while the FFS files of a FV are generated are
+    # queued to ThreadNumber worker threads instead of being run in place. Each
+    # queued tool waits for the tools producing its inputs, and everything is
+    # waited for before any tool whose output is read back by GenFds (GenFv,
+    # GUIDed section tools, ...) runs. ThreadNumber 1 runs every tool in place.
+    #
+    ThreadNumber = 1
+    ToolDeferDepth = 0
+    ToolQueue = None
+    ToolJobList = []
+    PendingToolDict = {}
+    InProcessToolList = ['GenSec', 'GenFfs', 'GenFv']
     
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
@@ -423,6 +472,11 @@ class GenFdsGlobalVariable:
         if Input == None or len(Input) == 0:
             return True
 
+        # "Output" or any "Input" still waiting for a queued tool is out of date
+        for F in [Output] + list(Input):
+            if os.path.normpath(F) in GenFdsGlobalVariable.PendingToolDict:
+                return True
+
         # if fdf file is changed after the 'Output" is generated, update the 'Output'
         OutputTime = os.path.getmtime(Output)
         if GenFdsGlobalVariable.FdfFileTimeStamp > OutputTime:
@@ -491,7 +545,8 @@ class GenFdsGlobalVariable:
             else:
                 if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                     return
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section", Input=list(Input),
+                                                      Output=Output, Defer=True)
         else:
             Cmd += ["-o", Output]
             Cmd += Input
@@ -502,10 +557,11 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
-                if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
-                    GenFdsGlobalVariable.LargeFileInFvFlags):
-                    GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
+                FlagIndex = None
+                if GenFdsGlobalVariable.LargeFileInFvFlags:
+                    FlagIndex = len(GenFdsGlobalVariable.LargeFileInFvFlags) - 1
+                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section", Input=list(Input),
+                                                      Output=Output, FlagIndex=FlagIndex, Defer=True)
 
     @staticmethod
     def GetAlignment (AlignString):
@@ -554,7 +610,8 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS", Input=list(Input),
+                                                  Output=Output, Defer=True)
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -699,9 +756,216 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
+            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue,
+                                                  Input=list(Input), Output=Output)
+
+    ## ContentDigest()
+    #
+    #   Digest of a tool command line and the contents of its input files. It is
+    #   saved next to the output as Output + '.hash' once the tool succeeds, so the
+    #   tool is skipped when an input is only touched but not changed.
+    #
+    #   @param  Cmd             The tool command line
+    #   @param  Input           The files read by the tool
+    #   @retval string          The digest, or None if an input can't be read
+    #
+    @staticmethod
+    def ContentDigest(Cmd, Input):
+        Md5 = hashlib.md5()
+        Md5.update(' '.join(Cmd))
+        for File in Input:
+            Md5.update(File)
+            try:
+                FileObj = open(File, 'rb')
+                try:
+                    Data = FileObj.read(0x100000)
+                    while Data:
+                        Md5.update(Data)
+                        Data = FileObj.read(0x100000)
+                finally:
+                    FileObj.close()
+            except IOError:
+                return None
+        return Md5.hexdigest()
+
+    ## RunToolJob()
+    #
+    #   Run a tool once the tools producing its inputs are done. May be called
+    #   from a worker thread, so errors are only recorded in the job here.
+    #
+    @staticmethod
+    def RunToolJob(Job):
+        try:
+            for Depend in Job.DependList:
+                Depend.Done.wait()
+                if Depend.ReturnCode != 0:
+                    Job.ReturnCode = Depend.ReturnCode
+                    Job.FailedJob = Depend.FailedJob or Depend
+                    return
+
+            Digest = None
+            if Job.Output != None and Job.Input != None:
+                HashFile = Job.Output + '.hash'
+                Digest = GenFdsGlobalVariable.ContentDigest(Job.Cmd, Job.Input)
+                if Digest != None and os.path.exists(Job.Output) and os.path.exists(HashFile):
+                    HashObj = open(HashFile, 'r')
+                    OldDigest = HashObj.read()
+                    HashObj.close()
+                    if OldDigest == Digest:
+                        Job.ReturnCode = 0
+
+            if Job.ReturnCode == None and GenFdsGlobalVariable.IsInProcessTool(Job.Cmd[0]):
+                (ExitCodes, Job.Out, Job.Error) = PyFvTools.RunBatch([GenFdsGlobalVariable.SplitCommand(Job.Cmd)])
+                Job.ReturnCode = ExitCodes[-1]
+                if Job.ReturnCode != 0:
+                    Job.FailedJob = Job
+                    return
+                if Digest != None:
+                    SaveFileOnChange(HashFile, Digest, False)
+            elif Job.ReturnCode == None:
+                try:
+                    PopenObject = subprocess.Popen(' '.join(Job.Cmd), stdout=subprocess.PIPE, stderr=subprocess.PIPE, shell=True)
+                except Exception, X:
+                    Job.Exception = X
+                    Job.ReturnCode = -1
+                    Job.FailedJob = Job
+                    return
+                (Job.Out, Job.Error) = PopenObject.communicate()
+                while PopenObject.returncode == None :
+                    PopenObject.wait()
+                Job.ReturnCode = PopenObject.returncode
+                if Job.ReturnCode != 0:
+                    Job.FailedJob = Job
+                    return
+                if Digest != None:
+                    SaveFileOnChange(HashFile, Digest, False)
+
+            if (Job.FlagIndex != None and
+                os.path.getsize(Job.Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE):
+                GenFdsGlobalVariable.LargeFileInFvFlags[Job.FlagIndex] = True
+        finally:
+            Job.Done.set()
+
+    ## SplitCommand()
+    #
+    #   Split a command into arguments the way the shell run by the subprocess
+    #   path would, so that quoted arguments keep their spaces.
+    #
+    #   @param  Cmd             The command as a list of strings
+    #   @retval list            The arguments
+    #
+    @staticmethod
+    def SplitCommand(Cmd):
+        if os.name != 'nt':
+            return shlex.split(' '.join(Cmd))
+        ArgList = []
+        for Arg in shlex.split(' '.join(Cmd), posix=False):
+            if len(Arg) > 1 and Arg[0] == Arg[-1] == '"':
+                Arg = Arg[1:-1]
+            ArgList.append(Arg)
+        return ArgList
+
+    ## IsInProcessTool()
+    #
+    #   Check whether a tool is run in process by PyFvTools.
+    #
+    #   @param  ToolPath        The tool name or path
+    #   @retval True            The tool is run in process
+    #
+    @staticmethod
+    def IsInProcessTool(ToolPath):
+        if PyFvTools == None:
+            return False
+        ToolName = os.path.splitext(os.path.basename(ToolPath))[0]
+        return ToolName in GenFdsGlobalVariable.InProcessToolList
+
+    ## ReportToolJob()
+    #
+    #   Log the result of a completed tool and stop GenFds if it failed.
+    #
+    @staticmethod
+    def ReportToolJob(Job, returnValue=[]):
+        if Job.FailedJob != None and Job.FailedJob != Job:
+            Job = Job.FailedJob
+        if Job.Exception != None:
+            EdkLogger.error("GenFds", COMMAND_FAILURE, ExtraData="%s: %s" % (str(Job.Exception), Job.Cmd[0]))
+        if returnValue != [] and returnValue[0] != 0:
+            #get command return value
+            returnValue[0] = Job.ReturnCode
+            return
+        if Job.ReturnCode != 0 or GenFdsGlobalVariable.VerboseMode or GenFdsGlobalVariable.DebugLevel != -1:
+            GenFdsGlobalVariable.InfLogger ("Return Value = %d" % Job.ReturnCode)
+            GenFdsGlobalVariable.InfLogger (Job.Out)
+            GenFdsGlobalVariable.InfLogger (Job.Error)
+            if Job.ReturnCode != 0:
+                print "###", Job.Cmd
+                EdkLogger.error("GenFds", COMMAND_FAILURE, Job.ErrorMess)
+
+    ## ToolWorker()
+    #
+    #   Worker thread body running queued tools in order.
+    #
+    @staticmethod
+    def ToolWorker():
+        while True:
+            Job = GenFdsGlobalVariable.ToolQueue.get()
+            GenFdsGlobalVariable.RunToolJob(Job)
+
+    ## BeginDeferredTools()
+    #
+    #   Queue GenSec and GenFfs calls to the worker threads until the matching
+    #   EndDeferredTools(). Calls may be nested for FV images inside FFS files.
+    #
+    @staticmethod
+    def BeginDeferredTools():
+        if GenFdsGlobalVariable.ThreadNumber < 2:
+            return
+        if GenFdsGlobalVariable.ToolQueue == None:
+            GenFdsGlobalVariable.ToolQueue = Queue.Queue()
+            for Index in range(GenFdsGlobalVariable.ThreadNumber):
+                Worker = threading.Thread(target=GenFdsGlobalVariable.ToolWorker, name="GenFdsTool%d" % Index)
+                Worker.setDaemon(True)
+                Worker.start()
+        GenFdsGlobalVariable.ToolDeferDepth += 1
+
+    ## EndDeferredTools()
+    #
+    #   Wait for all queued tools.
+    #
+    @staticmethod
+    def EndDeferredTools():
+        if GenFdsGlobalVariable.ThreadNumber < 2:
+            return
+        GenFdsGlobalVariable.ToolDeferDepth -= 1
+        GenFdsGlobalVariable.WaitForTools()
 
-    def CallExternalTool (cmd, errorMess, returnValue=[]):
+    ## WaitForTools()
+    #
+    #   Wait for the queued tools producing the given files, or for all queued
+    #   tools if no file list is given, and report their failures.
+    #
+    #   @param  Files           The files to be read by the caller
+    #
+    @staticmethod
+    def WaitForTools(Files=None):
+        if not GenFdsGlobalVariable.ToolJobList:
+            return
+        if Files == None:
+            JobList = GenFdsGlobalVariable.ToolJobList
+            GenFdsGlobalVariable.ToolJobList = []
+            GenFdsGlobalVariable.PendingToolDict = {}
+        else:
+            JobList = []
+            for File in Files:
+                Job = GenFdsGlobalVariable.PendingToolDict.get(os.path.normpath(File))
+                if Job != None:
+                    JobList.append(Job)
+        for Job in JobList:
+            Job.Done.wait()
+            if Files == None or Job.ReturnCode != 0:
+                GenFdsGlobalVariable.ReportToolJob(Job)
+
+    def CallExternalTool (cmd, errorMess, returnValue=[], Input=None, Output=None, FlagIndex=None, Defer=False):
 
         if type(cmd) not in (tuple, list):
             GenFdsGlobalVariable.ErrorLogger("ToolError!  Invalid parameter type in call to CallExternalTool")
@@ -720,25 +984,27 @@ class GenFdsGlobalVariable:
             if GenFdsGlobalVariable.SharpCounter % GenFdsGlobalVariable.SharpNumberPerLine == 0:
                 sys.stdout.write('\n')
 
-        try:
-            PopenObject = subprocess.Popen(' '.join(cmd), stdout=subprocess.PIPE, stderr=subprocess.PIPE, shell=True)
-        except Exception, X:
-            EdkLogger.error("GenFds", COMMAND_FAILURE, ExtraData="%s: %s" % (str(X), cmd[0]))
-        (out, error) = PopenObject.communicate()
-
-        while PopenObject.returncode == None :
-            PopenObject.wait()
-        if returnValue != [] and returnValue[0] != 0:
-            #get command return value
-            returnValue[0] = PopenObject.returncode
+        Job = ToolJob(cmd, errorMess, Input, Output, FlagIndex)
+        if Defer and GenFdsGlobalVariable.ToolDeferDepth > 0:
+            for File in list(Input) + [Output]:
+                Depend = GenFdsGlobalVariable.PendingToolDict.get(os.path.normpath(File))
+                if Depend != None:
+                    Job.DependList.append(Depend)
+            GenFdsGlobalVariable.PendingToolDict[os.path.normpath(Output)] = Job
+            GenFdsGlobalVariable.ToolJobList.append(Job)
+            GenFdsGlobalVariable.ToolQueue.put(Job)
             return
-        if PopenObject.returncode != 0 or GenFdsGlobalVariable.VerboseMode or GenFdsGlobalVariable.DebugLevel != -1:
-            GenFdsGlobalVariable.InfLogger ("Return Value = %d" % PopenObject.returncode)
-            GenFdsGlobalVariable.InfLogger (out)
-            GenFdsGlobalVariable.InfLogger (error)
-            if PopenObject.returncode != 0:
-                print "###", cmd
-                EdkLogger.error("GenFds", COMMAND_FAILURE, errorMess)
+
+        GenFdsGlobalVariable.WaitForTools(Input)
+        GenFdsGlobalVariable.RunToolJob(Job)
+        GenFdsGlobalVariable.ReportToolJob(Job, returnValue)
+
+        #
+        # Once the outermost FV is generated, its section and FFS files are no
+        # longer needed in memory.
+        #
+        if PyFvTools != None and cmd[0] == 'GenFv' and GenFdsGlobalVariable.ToolDeferDepth == 0:
+            PyFvTools.FreeFiles()
 
     def VerboseLogger (msg):
         EdkLogger.verbose(msg)
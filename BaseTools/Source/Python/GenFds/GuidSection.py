@@ -165,6 +165,7 @@ class GuidSection(GuidSectionClassObject) :
             # Just in case the external tool fails at this time but succeeded before
             # Error should be reported if the external tool does not generate a new output based on new input
             #
+            GenFdsGlobalVariable.WaitForTools([DummyFile])
             if os.path.exists(TempFile) and os.path.exists(DummyFile) and os.path.getmtime(TempFile) < os.path.getmtime(DummyFile):
                 os.remove(TempFile)
 
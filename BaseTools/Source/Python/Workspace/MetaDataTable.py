@@ -15,6 +15,7 @@
 # Import Modules
 #
 import Common.LongFilePathOs as os
+import weakref
 
 import Common.EdkLogger as EdkLogger
 from CommonDataClass import DataClass
@@ -39,7 +40,11 @@ class Table(object):
     _ID_MAX_ = 0x80000000
     _DUMMY_ = 0
 
+    # all tables, so that they can be moved to a new connection of the database
+    TableSet = weakref.WeakSet()
+
     def __init__(self, Cursor, Name='', IdBase=0, Temporary=False):
+        Table.TableSet.add(self)
         self.Cur = Cursor
         self.Table = Name
         self.IdBase = int(IdBase)
@@ -168,7 +173,8 @@ class TableFile(Table):
         Path VARCHAR,
         FullPath VARCHAR NOT NULL,
         Model INTEGER DEFAULT 0,
-        TimeStamp SINGLE NOT NULL
+        TimeStamp SINGLE NOT NULL,
+        Hash VARCHAR
         '''
     def __init__(self, Cursor):
         Table.__init__(self, Cursor, 'File')
@@ -183,9 +189,10 @@ class TableFile(Table):
     # @param FullPath:  FullPath of a File
     # @param Model:     Model of a File
     # @param TimeStamp: TimeStamp of a File
+    # @param Hash:      Digest of the content of a File
     #
-    def Insert(self, Name, ExtName, Path, FullPath, Model, TimeStamp):
-        (Name, ExtName, Path, FullPath) = ConvertToSqlString((Name, ExtName, Path, FullPath))
+    def Insert(self, Name, ExtName, Path, FullPath, Model, TimeStamp, Hash=''):
+        (Name, ExtName, Path, FullPath, Hash) = ConvertToSqlString((Name, ExtName, Path, FullPath, Hash))
         return Table.Insert(
             self,
             Name,
@@ -193,7 +200,8 @@ class TableFile(Table):
             Path,
             FullPath,
             Model,
-            TimeStamp
+            TimeStamp,
+            Hash
             )
 
     ## InsertFile
@@ -262,6 +270,27 @@ class TableFile(Table):
     def SetFileTimeStamp(self, FileId, TimeStamp):
         self.Exec("update %s set TimeStamp=%s where ID='%s'" % (self.Table, TimeStamp, FileId))
 
+    ## Get the content digest of a given file
+    #
+    #   @param  FileId      ID of file
+    #
+    #   @retval hash        Digest of the file content when it was parsed last time
+    #
+    def GetFileHash(self, FileId):
+        QueryScript = "select Hash from %s where ID = '%s'" % (self.Table, FileId)
+        RecordList = self.Exec(QueryScript)
+        if len(RecordList) == 0:
+            return None
+        return RecordList[0][0]
+
+    ## Update the content digest of a given file
+    #
+    #   @param  FileId      ID of file
+    #   @param  Hash        Digest of the file content
+    #
+    def SetFileHash(self, FileId, Hash):
+        self.Exec("update %s set Hash='%s' where ID='%s'" % (self.Table, Hash, FileId))
+
     ## Get list of file with given type
     #
     #   @param  FileType    Type value of file
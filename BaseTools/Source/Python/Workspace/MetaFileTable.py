@@ -18,6 +18,7 @@ import uuid
 
 import Common.EdkLogger as EdkLogger
 from Common.BuildToolError import FORMAT_INVALID
+from Common.Misc import GetFileDigest
 
 from MetaDataTable import Table, TableFile
 from MetaDataTable import ConvertToSqlString
@@ -55,13 +56,19 @@ class MetaFileTable(Table):
             TimeStamp = self.MetaFile.TimeStamp
             Result = self.Cur.execute("select ID from %s where ID<0" % (self.Table)).fetchall()
             if not Result:
-                # update the timestamp in database
+                # update the timestamp and digest in database
                 self._FileIndexTable.SetFileTimeStamp(self.IdBase, TimeStamp)                
+                self._FileIndexTable.SetFileHash(self.IdBase, GetFileDigest(self.MetaFile.Path))
                 return False
 
             if TimeStamp != self._FileIndexTable.GetFileTimeStamp(self.IdBase):
                 # update the timestamp in database
                 self._FileIndexTable.SetFileTimeStamp(self.IdBase, TimeStamp)
+                # the file is just touched if its content is the same as last time
+                Hash = GetFileDigest(self.MetaFile.Path)
+                if Hash == self._FileIndexTable.GetFileHash(self.IdBase):
+                    return True
+                self._FileIndexTable.SetFileHash(self.IdBase, Hash)
                 return False
         except Exception, Exc:
             EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
@@ -163,6 +163,23 @@ class WorkspaceDatabase(object):
             if self._CheckWhetherDbNeedRenew(RenewDb, DbPath):
                 os.remove(DbPath)
         
+        self._Connect(DbPath)
+        self._SharedTableList = []
+
+        # create table for internal uses
+        self.TblDataModel = TableDataModel(self.Cur)
+        self.TblFile = TableFile(self.Cur)
+        self.Platform = None
+
+        # conversion object for build or file format conversion purpose
+        self.BuildObject = WorkspaceDatabase.BuildObjectFactory(self)
+        self.TransformObject = WorkspaceDatabase.TransformObjectFactory(self)
+
+    ## Connect to the database file
+    #
+    # @param DbPath    Path of database file
+    #
+    def _Connect(self, DbPath):
         # create db with optimized parameters
         self.Conn = sqlite3.connect(DbPath, isolation_level='DEFERRED')
         self.Conn.execute("PRAGMA synchronous=OFF")
@@ -175,14 +192,51 @@ class WorkspaceDatabase(object):
         self.Conn.text_factory = str
         self.Cur = self.Conn.cursor()
 
-        # create table for internal uses
-        self.TblDataModel = TableDataModel(self.Cur)
-        self.TblFile = TableFile(self.Cur)
-        self.Platform = None
-
-        # conversion object for build or file format conversion purpose
-        self.BuildObject = WorkspaceDatabase.BuildObjectFactory(self)
-        self.TransformObject = WorkspaceDatabase.TransformObjectFactory(self)
+    ## Share the database with forked processes
+    #
+    # A SQLite connection must not be used across fork(), so the processes
+    # open their own connection with Reconnect(). The temporary tables exist
+    # in this connection only. They are copied, under the same names, to the
+    # database file until EndShare() is called. This connection still sees
+    # its temporary tables in their place.
+    #
+    # @retval str       Path of the database file
+    # @retval None      The database is in memory and can't be shared
+    #
+    def BeginShare(self):
+        DbPath = None
+        for Seq, Name, File in self.Cur.execute("pragma database_list").fetchall():
+            if Name == 'main':
+                DbPath = File
+        if not DbPath:
+            return None
+
+        self._SharedTableList = [Name for (Name,) in
+                                 self.Cur.execute("select name from sqlite_temp_master where type='table'").fetchall()]
+        for Name in self._SharedTableList:
+            self.Cur.execute("create table main.%s as select * from temp.%s" % (Name, Name))
+        self.Conn.commit()
+        return DbPath
+
+    ## Remove the copies of temporary tables made by BeginShare()
+    def EndShare(self):
+        for Name in self._SharedTableList:
+            self.Cur.execute("drop table main.%s" % Name)
+        self._SharedTableList = []
+        self.Conn.commit()
+
+    ## Open a new connection in a forked process
+    #
+    # The connection inherited from the parent process is left untouched, and
+    # all tables are moved to the new connection.
+    #
+    # @param DbPath    Path of database file returned by BeginShare()
+    #
+    def Reconnect(self, DbPath):
+        self._InheritedConn = (self.Conn, self.Cur)
+        self._Connect(DbPath)
+        for Tbl in Table.TableSet:
+            Tbl.Cur = self.Cur
 
     ## Check whether workspace database need to be renew.
     #  The renew reason maybe:
@@ -769,6 +769,7 @@ class Build():
         self.BuildReport    = BuildReport(BuildOptions.ReportFile, BuildOptions.ReportType)
         self.TargetTxt      = TargetTxtClassObject()
         self.ToolDef        = ToolDefClassObject()
+        self.ToolDefinitionFile = None
         self.AutoGenTime    = 0
         self.MakeTime       = 0
         self.GenFdsTime     = 0
@@ -786,9 +787,6 @@ class Build():
         if GlobalData.gBinCacheSource and not GlobalData.gUseHashCache:
             EdkLogger.error("build", OPTION_NOT_SUPPORTED, ExtraData="--binary-source must be used together with --hash.")
 
-        if GlobalData.gBinCacheDest and GlobalData.gBinCacheSource:
-            EdkLogger.error("build", OPTION_NOT_SUPPORTED, ExtraData="--binary-destination can not be used together with --binary-source.")
-
         if GlobalData.gBinCacheSource:
             BinCacheSource = os.path.normpath(GlobalData.gBinCacheSource)
             if not os.path.isabs(BinCacheSource):
@@ -866,6 +864,7 @@ class Build():
             self.LaunchPrebuild()
             self.TargetTxt = TargetTxtClassObject()
             self.ToolDef   = ToolDefClassObject()
+            self.ToolDefinitionFile = None
         if not (self.LaunchPrebuildFlag and os.path.exists(self.PlatformBuildPath)):
             self.InitBuild()
 
@@ -889,7 +888,10 @@ class Build():
                 ToolDefinitionFile = gToolsDefinition
                 ToolDefinitionFile = os.path.normpath(mws.join(self.WorkspaceDir, 'Conf', ToolDefinitionFile))
             if os.path.isfile(ToolDefinitionFile) == True:
-                StatusCode = self.ToolDef.LoadToolDefFile(ToolDefinitionFile)
+                # InitPreBuild() and InitBuild() both come here; parse it only once
+                if ToolDefinitionFile != self.ToolDefinitionFile:
+                    StatusCode = self.ToolDef.LoadToolDefFile(ToolDefinitionFile)
+                    self.ToolDefinitionFile = ToolDefinitionFile
             else:
                 EdkLogger.error("build", FILE_NOT_FOUND, ExtraData=ToolDefinitionFile)
         else:
@@ -1229,6 +1231,13 @@ class Build():
 
         # skip file generation for cleanxxx targets, run and fds target
         if Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds']:
+            # generate the files of modules with multiple processes first, with
+            # no progress thread running when they are forked
+            CreateCodeFile = CreateDepsCodeFile and (not self.SkipAutoGen or Target == 'genc')
+            CreateMakeFile = CreateDepsMakeFile and Target != 'genc' and (not self.SkipAutoGen or Target == 'genmake')
+            if (CreateCodeFile or CreateMakeFile) and isinstance(AutoGenObject, PlatformAutoGen):
+                AutoGenObject.CreateModuleFiles(CreateCodeFile, CreateMakeFile, FfsCommand, self.ThreadNumber)
+
             # for target which must generate AutoGen code and makefile
             if not self.SkipAutoGen or Target == 'genc':
                 self.Progress.Start("Generating code")
@@ -1858,9 +1867,6 @@ class Build():
                             Ma = ModuleAutoGen(Wa, Module, BuildTarget, ToolChain, Arch, self.PlatformFile)
                             if Ma == None: continue
                             MaList.append(Ma)
-                            if Ma.CanSkipbyHash():
-                                self.HashSkipModules.append(Ma)
-                                continue
                             # Not to auto-gen for targets 'clean', 'cleanlib', 'cleanall', 'run', 'fds'
                             if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds']:
                                 # for target which must generate AutoGen code and makefile
@@ -1872,6 +1878,9 @@ class Build():
                                         del CmdListDict[Module.File, Arch]
                                     else:
                                         Ma.CreateMakeFile(True)
+                            if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds'] and Ma.CanSkipbyHash():
+                                self.HashSkipModules.append(Ma)
+                                continue
                             self.BuildModules.append(Ma)
                     self.AutoGenTime += int(round((time.time() - AutoGenStart)))
                     MakeStart = time.time()
@@ -2025,16 +2034,30 @@ class Build():
                             if Inf in Pa.Platform.Modules:
                                 continue
                             ModuleList.append(Inf)
+                    MaList = []
                     for Module in ModuleList:
                         # Get ModuleAutoGen object to generate C code file and makefile
                         Ma = ModuleAutoGen(Wa, Module, BuildTarget, ToolChain, Arch, self.PlatformFile)
                         
                         if Ma == None:
                             continue
-                        if Ma.CanSkipbyHash():
-                            self.HashSkipModules.append(Ma)
-                            continue
-
+                        MaList.append((Ma, Module))
+
+                    # generate the files of modules with multiple processes first
+                    if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds']:
+                        CreateCodeFile = not self.SkipAutoGen or self.Target == 'genc'
+                        CreateMakeFile = self.Target != 'genc' and (not self.SkipAutoGen or self.Target == 'genmake')
+                        WorkList = []
+                        for Ma, Module in MaList:
+                            GenFfsList = []
+                            if CmdListDict and self.Fdf and (Module.File, Arch) in CmdListDict:
+                                GenFfsList = CmdListDict[Module.File, Arch]
+                            WorkList.append((Ma, CreateCodeFile, CreateMakeFile, GenFfsList))
+                        # no progress thread may run when the processes are forked
+                        self.Progress.Stop("done!")
+                        CreateModuleFiles(WorkList, self.ThreadNumber)
+
+                    for Ma, Module in MaList:
                         # Not to auto-gen for targets 'clean', 'cleanlib', 'cleanall', 'run', 'fds'
                         if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds']:
                             # for target which must generate AutoGen code and makefile
@@ -2051,6 +2074,9 @@ class Build():
                                     Ma.CreateMakeFile(True)
                             if self.Target == "genmake":
                                 continue
+                        if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds'] and Ma.CanSkipbyHash():
+                            self.HashSkipModules.append(Ma)
+                            continue
                         self.BuildModules.append(Ma)
                     self.Progress.Stop("done!")
                     self.AutoGenTime += int(round((time.time() - AutoGenStart)))
@@ -2229,6 +2255,9 @@ class Build():
             RemoveDirectory(os.path.dirname(GlobalData.gDatabasePath), True)
 
     def CreateAsBuiltInf(self):
+        if not BuildTask.HasError():
+            for Module in self.BuildModules:
+                Module.SaveModuleHash()
         for Module in self.BuildModules:
             Module.CreateAsBuiltInf()
         for Module in self.HashSkipModules:
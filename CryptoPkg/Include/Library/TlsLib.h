@@ -77,6 +77,20 @@ TlsFree (
   IN     VOID                     *Tls
   );
 
+/**
+  Free a TLS/SSL session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID                     *Session
+  );
+
 /**
   Create a new TLS object for a connection.
 
@@ -422,6 +436,46 @@ TlsSetSessionId (
   IN     UINT16                   SessionIdLen
   );
 
+/**
+  Sets a previously established TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() to be reused when the
+  TLS/SSL connection is to be established. If the server does not accept the
+  session, a full handshake is performed.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS/SSL session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session could not be set.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  );
+
+/**
+  Set the server name to be sent in the server_name (SNI) extension during TLS/SSL connect.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  ServerName      Pointer to a Null-terminated ASCII host name of the server.
+
+  @retval  EFI_SUCCESS           The server name was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The server name could not be set.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetServerName (
+  IN     VOID                     *Tls,
+  IN     CONST CHAR8              *ServerName
+  );
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -641,6 +695,25 @@ TlsGetSessionId (
   IN OUT UINT16                   *SessionIdLen
   );
 
+/**
+  Gets the TLS/SSL session used by the specified TLS connection.
+
+  This function returns a reference to the TLS/SSL session currently used by the
+  specified TLS connection, so that it can be resumed by a later connection through
+  TlsSetSession(). The returned session must be released with TlsFreeSession().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  Pointer to the TLS/SSL session object.
+           If no session is available, TlsGetSession() returns NULL.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID                     *Tls
+  );
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -15,6 +15,14 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "InternalCryptLib.h"
 #include <openssl/sha.h>
 
+//
+// SHA-1 context with the hardware transform support checked once at
+// Sha1Init(), so that Sha1Update() doesn't execute CPUID on every call.
+//
+typedef struct {
+  SHA_CTX     Ctx;
+  BOOLEAN     HwSupported;
+} CRYPT_SHA1_CONTEXT;
 
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-1 hash operations.
@@ -29,9 +37,9 @@ Sha1GetContextSize (
   )
 {
   //
-  // Retrieves OpenSSL SHA Context Size
+  // Retrieves OpenSSL SHA Context Size, plus the hardware support flag
   //
-  return (UINTN) (sizeof (SHA_CTX));
+  return (UINTN) (sizeof (CRYPT_SHA1_CONTEXT));
 }
 
 /**
@@ -59,10 +67,12 @@ Sha1Init (
     return FALSE;
   }
 
+  ((CRYPT_SHA1_CONTEXT *) Sha1Context)->HwSupported = InternalShaHwIsSupported ();
+
   //
   // OpenSSL SHA-1 Context Initialization
   //
-  return (BOOLEAN) (SHA1_Init ((SHA_CTX *) Sha1Context));
+  return (BOOLEAN) (SHA1_Init (&((CRYPT_SHA1_CONTEXT *) Sha1Context)->Ctx));
 }
 
 /**
@@ -92,7 +102,7 @@ Sha1Duplicate (
     return FALSE;
   }
 
-  CopyMem (NewSha1Context, Sha1Context, sizeof (SHA_CTX));
+  CopyMem (NewSha1Context, Sha1Context, sizeof (CRYPT_SHA1_CONTEXT));
 
   return TRUE;
 }
@@ -123,6 +133,11 @@ Sha1Update (
   IN      UINTN       DataSize
   )
 {
+  SHA_CTX      *Context;
+  CONST UINT8  *Buffer;
+  UINTN        Length;
+  UINT64       BitCount;
+
   //
   // Check input parameters.
   //
@@ -137,10 +152,46 @@ Sha1Update (
     return FALSE;
   }
 
+  Context = &((CRYPT_SHA1_CONTEXT *) Sha1Context)->Ctx;
+  Buffer  = (CONST UINT8 *) Data;
+
+  if (((CRYPT_SHA1_CONTEXT *) Sha1Context)->HwSupported) {
+    //
+    // Top up a partially filled block through OpenSSL first, so that the
+    // remaining input starts on a block boundary.
+    //
+    if (Context->num != 0 && DataSize >= SHA_CBLOCK - Context->num) {
+      Length = SHA_CBLOCK - Context->num;
+      if (SHA1_Update (Context, Buffer, Length) == 0) {
+        return FALSE;
+      }
+      Buffer   += Length;
+      DataSize -= Length;
+    }
+
+    //
+    // Hash the whole blocks in hardware and keep the OpenSSL bit count in
+    // sync, so that the tail and SHA1_Final() can continue in software.
+    // The chaining values h0-h4 are laid out as an array in SHA_CTX.
+    //
+    Length = DataSize & ~((UINTN) SHA_CBLOCK - 1);
+    if (Context->num == 0 && Length != 0) {
+      InternalSha1HwBlocks ((UINT32 *) &Context->h0, Buffer, Length / SHA_CBLOCK);
+
+      BitCount = LShiftU64 (Context->Nh, 32) | Context->Nl;
+      BitCount = BitCount + LShiftU64 (Length, 3);
+      Context->Nl = (SHA_LONG) BitCount;
+      Context->Nh = (SHA_LONG) RShiftU64 (BitCount, 32);
+
+      Buffer   += Length;
+      DataSize -= Length;
+    }
+  }
+
   //
   // OpenSSL SHA-1 Hash Update
   //
-  return (BOOLEAN) (SHA1_Update ((SHA_CTX *) Sha1Context, Data, DataSize));
+  return (BOOLEAN) (SHA1_Update (Context, Buffer, DataSize));
 }
 
 /**
@@ -180,7 +231,7 @@ Sha1Final (
   //
   // OpenSSL SHA-1 Hash Finalization
   //
-  return (BOOLEAN) (SHA1_Final (HashValue, (SHA_CTX *) Sha1Context));
+  return (BOOLEAN) (SHA1_Final (HashValue, &((CRYPT_SHA1_CONTEXT *) Sha1Context)->Ctx));
 }
 
 /**
@@ -209,6 +260,8 @@ Sha1HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  CRYPT_SHA1_CONTEXT  Context;
+
   //
   // Check input parameters.
   //
@@ -220,11 +273,14 @@ Sha1HashAll (
   }
 
   //
-  // OpenSSL SHA-1 Hash Computation.
+  // Go through Sha1Update() so that the hardware transform is used when
+  // it is available.
   //
-  if (SHA1 (Data, DataSize, HashValue) == NULL) {
+  if (!Sha1Init (&Context)) {
+    return FALSE;
+  }
+  if (!Sha1Update (&Context, Data, DataSize)) {
     return FALSE;
-  } else {
-    return TRUE;
   }
+  return Sha1Final (&Context, HashValue);
 }
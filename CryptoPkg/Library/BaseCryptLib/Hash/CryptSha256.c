@@ -15,6 +15,15 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "InternalCryptLib.h"
 #include <openssl/sha.h>
 
+//
+// SHA-256 context with the hardware transform support checked once at
+// Sha256Init(), so that Sha256Update() doesn't execute CPUID on every call.
+//
+typedef struct {
+  SHA256_CTX  Ctx;
+  BOOLEAN     HwSupported;
+} CRYPT_SHA256_CONTEXT;
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-256 hash operations.
 
@@ -28,9 +37,9 @@ Sha256GetContextSize (
   )
 {
   //
-  // Retrieves OpenSSL SHA-256 Context Size
+  // Retrieves OpenSSL SHA-256 Context Size, plus the hardware support flag
   //
-  return (UINTN) (sizeof (SHA256_CTX));
+  return (UINTN) (sizeof (CRYPT_SHA256_CONTEXT));
 }
 
 /**
@@ -58,10 +67,12 @@ Sha256Init (
     return FALSE;
   }
 
+  ((CRYPT_SHA256_CONTEXT *) Sha256Context)->HwSupported = InternalShaHwIsSupported ();
+
   //
   // OpenSSL SHA-256 Context Initialization
   //
-  return (BOOLEAN) (SHA256_Init ((SHA256_CTX *) Sha256Context));
+  return (BOOLEAN) (SHA256_Init (&((CRYPT_SHA256_CONTEXT *) Sha256Context)->Ctx));
 }
 
 /**
@@ -91,7 +102,7 @@ Sha256Duplicate (
     return FALSE;
   }
 
-  CopyMem (NewSha256Context, Sha256Context, sizeof (SHA256_CTX));
+  CopyMem (NewSha256Context, Sha256Context, sizeof (CRYPT_SHA256_CONTEXT));
 
   return TRUE;
 }
@@ -122,6 +133,11 @@ Sha256Update (
   IN      UINTN       DataSize
   )
 {
+  SHA256_CTX   *Context;
+  CONST UINT8  *Buffer;
+  UINTN        Length;
+  UINT64       BitCount;
+
   //
   // Check input parameters.
   //
@@ -136,10 +152,45 @@ Sha256Update (
     return FALSE;
   }
 
+  Context = &((CRYPT_SHA256_CONTEXT *) Sha256Context)->Ctx;
+  Buffer  = (CONST UINT8 *) Data;
+
+  if (((CRYPT_SHA256_CONTEXT *) Sha256Context)->HwSupported) {
+    //
+    // Top up a partially filled block through OpenSSL first, so that the
+    // remaining input starts on a block boundary.
+    //
+    if (Context->num != 0 && DataSize >= SHA256_CBLOCK - Context->num) {
+      Length = SHA256_CBLOCK - Context->num;
+      if (SHA256_Update (Context, Buffer, Length) == 0) {
+        return FALSE;
+      }
+      Buffer   += Length;
+      DataSize -= Length;
+    }
+
+    //
+    // Hash the whole blocks in hardware and keep the OpenSSL bit count in
+    // sync, so that the tail and SHA256_Final() can continue in software.
+    //
+    Length = DataSize & ~((UINTN) SHA256_CBLOCK - 1);
+    if (Context->num == 0 && Length != 0) {
+      InternalSha256HwBlocks ((UINT32 *) Context->h, Buffer, Length / SHA256_CBLOCK);
+
+      BitCount = LShiftU64 (Context->Nh, 32) | Context->Nl;
+      BitCount = BitCount + LShiftU64 (Length, 3);
+      Context->Nl = (SHA_LONG) BitCount;
+      Context->Nh = (SHA_LONG) RShiftU64 (BitCount, 32);
+
+      Buffer   += Length;
+      DataSize -= Length;
+    }
+  }
+
   //
   // OpenSSL SHA-256 Hash Update
   //
-  return (BOOLEAN) (SHA256_Update ((SHA256_CTX *) Sha256Context, Data, DataSize));
+  return (BOOLEAN) (SHA256_Update (Context, Buffer, DataSize));
 }
 
 /**
@@ -179,7 +230,7 @@ Sha256Final (
   //
   // OpenSSL SHA-256 Hash Finalization
   //
-  return (BOOLEAN) (SHA256_Final (HashValue, (SHA256_CTX *) Sha256Context));
+  return (BOOLEAN) (SHA256_Final (HashValue, &((CRYPT_SHA256_CONTEXT *) Sha256Context)->Ctx));
 }
 
 /**
@@ -208,6 +259,8 @@ Sha256HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  CRYPT_SHA256_CONTEXT  Context;
+
   //
   // Check input parameters.
   //
@@ -219,11 +272,14 @@ Sha256HashAll (
   }
 
   //
-  // OpenSSL SHA-256 Hash Computation.
+  // Go through Sha256Update() so that the hardware transform is used when
+  // it is available.
   //
-  if (SHA256 (Data, DataSize, HashValue) == NULL) {
+  if (!Sha256Init (&Context)) {
+    return FALSE;
+  }
+  if (!Sha256Update (&Context, Data, DataSize)) {
     return FALSE;
-  } else {
-    return TRUE;
   }
+  return Sha256Final (&Context, HashValue);
 }
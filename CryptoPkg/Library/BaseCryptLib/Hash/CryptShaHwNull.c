@@ -0,0 +1,78 @@
+/** @file
+  SHA-1 and SHA-256 hardware block transform Null Implementation, for
+  architectures and environments where the OpenSSL software transforms are
+  always used.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Check whether the processor provides the instructions used by
+  InternalSha1HwBlocks() and InternalSha256HwBlocks().
+
+  @retval FALSE  The SHA-1 and SHA-256 block transforms must be done in software.
+
+**/
+BOOLEAN
+InternalShaHwIsSupported (
+  VOID
+  )
+{
+  return FALSE;
+}
+
+/**
+  Run the SHA-1 compression function over whole 64-byte blocks using
+  the processor SHA extensions.
+
+  Return directly and do nothing, because InternalShaHwIsSupported()
+  never returns TRUE.
+
+  @param[in, out]  State       The five 32-bit SHA-1 chaining values.
+  @param[in]       Data        Pointer to the message blocks.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha1HwBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Run the SHA-256 compression function over whole 64-byte blocks using
+  the processor SHA extensions.
+
+  Return directly and do nothing, because InternalShaHwIsSupported()
+  never returns TRUE.
+
+  @param[in, out]  State       The eight 32-bit SHA-256 chaining values.
+  @param[in]       Data        Pointer to the message blocks.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256HwBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
@@ -0,0 +1,64 @@
+/** @file
+  SHA-1 and SHA-256 hardware block transform support check for X64.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "InternalCryptLib.h"
+
+//
+// CPUID feature bits used by the SHA-1 and SHA-256 hardware transforms.
+//
+#define CPUID_LEAF_VERSION_INFO         0x01
+#define CPUID_LEAF_EXTENDED_FEATURES    0x07
+#define CPUID_VERSION_INFO_ECX_SSSE3    BIT9
+#define CPUID_VERSION_INFO_ECX_SSE4_1   BIT19
+#define CPUID_EXTENDED_FEATURES_EBX_SHA BIT29
+
+/**
+  Check whether the processor provides the instructions used by
+  InternalSha1HwBlocks() and InternalSha256HwBlocks().
+
+  The result is kept in the hash context by Sha1Init() and Sha256Init()
+  rather than in a global variable, which is not writable when this library
+  is linked into an execute-in-place PEIM.
+
+  @retval TRUE   The SHA-1 and SHA-256 block transforms can be done in hardware.
+  @retval FALSE  The SHA-1 and SHA-256 block transforms must be done in software.
+
+**/
+BOOLEAN
+InternalShaHwIsSupported (
+  VOID
+  )
+{
+  UINT32  MaxLeaf;
+  UINT32  RegEbx;
+  UINT32  RegEcx;
+
+  AsmCpuid (0, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_LEAF_EXTENDED_FEATURES) {
+    return FALSE;
+  }
+
+  //
+  // The transforms use PSHUFB/PALIGNR (SSSE3) and PBLENDW (SSE4.1) besides
+  // the SHA instructions themselves.
+  //
+  AsmCpuid (CPUID_LEAF_VERSION_INFO, NULL, NULL, &RegEcx, NULL);
+  if ((RegEcx & CPUID_VERSION_INFO_ECX_SSSE3) == 0 ||
+      (RegEcx & CPUID_VERSION_INFO_ECX_SSE4_1) == 0) {
+    return FALSE;
+  }
+
+  AsmCpuidEx (CPUID_LEAF_EXTENDED_FEATURES, 0, NULL, &RegEbx, NULL, NULL);
+  return (BOOLEAN) ((RegEbx & CPUID_EXTENDED_FEATURES_EBX_SHA) != 0);
+}
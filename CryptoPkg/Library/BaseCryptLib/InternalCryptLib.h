@@ -33,4 +33,51 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define OBJ_length(o) ((o)->length)
 #endif
 
+/**
+  Check whether the processor provides the instructions used by
+  InternalSha1HwBlocks() and InternalSha256HwBlocks().
+
+  @retval TRUE   The SHA-1 and SHA-256 block transforms can be done in hardware.
+  @retval FALSE  The SHA-1 and SHA-256 block transforms must be done in software.
+
+**/
+BOOLEAN
+InternalShaHwIsSupported (
+  VOID
+  );
+
+/**
+  Run the SHA-1 compression function over whole 64-byte blocks using
+  the processor SHA extensions.
+
+  @param[in, out]  State       The five 32-bit SHA-1 chaining values.
+  @param[in]       Data        Pointer to the message blocks.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha1HwBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Run the SHA-256 compression function over whole 64-byte blocks using
+  the processor SHA extensions.
+
+  @param[in, out]  State       The eight 32-bit SHA-256 chaining values.
+  @param[in]       Data        Pointer to the message blocks.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256HwBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
 #endif
@@ -395,6 +395,76 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a previously established TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() to be reused when the
+  TLS/SSL connection is to be established. If the server does not accept the
+  session, a full handshake is performed.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS/SSL session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session could not be set.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+
+  if (TlsConn == NULL || TlsConn->Ssl == NULL || Session == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, (SSL_SESSION *) Session) != 1) {
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Set the server name to be sent in the server_name (SNI) extension during TLS/SSL connect.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  ServerName      Pointer to a Null-terminated ASCII host name of the server.
+
+  @retval  EFI_SUCCESS           The server name was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The server name could not be set.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetServerName (
+  IN     VOID                     *Tls,
+  IN     CONST CHAR8              *ServerName
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+
+  if (TlsConn == NULL || TlsConn->Ssl == NULL || ServerName == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_set_tlsext_host_name (TlsConn->Ssl, ServerName) != 1) {
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -832,6 +902,36 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the TLS/SSL session used by the specified TLS connection.
+
+  This function returns a reference to the TLS/SSL session currently used by the
+  specified TLS connection, so that it can be resumed by a later connection through
+  TlsSetSession(). The returned session must be released with TlsFreeSession().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  Pointer to the TLS/SSL session object.
+           If no session is available, TlsGetSession() returns NULL.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID                     *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+
+  if (TlsConn == NULL || TlsConn->Ssl == NULL) {
+    return NULL;
+  }
+
+  return (VOID *) SSL_get1_session (TlsConn->Ssl);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -147,6 +147,27 @@ TlsFree (
   OPENSSL_free (Tls);
 }
 
+/**
+  Free a TLS/SSL session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID                     *Session
+  )
+{
+  if (Session == NULL) {
+    return;
+  }
+
+  SSL_SESSION_free ((SSL_SESSION *) Session);
+}
+
 /**
   Create a new TLS object for a connection.
 
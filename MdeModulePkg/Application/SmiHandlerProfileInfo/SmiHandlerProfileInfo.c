@@ -619,6 +619,9 @@ DumpSmiHandler(
           Print(L"         <RVA>0x%x</RVA>\n", (UINTN) (SmiHandlerStruct->CallerAddr - ImageStruct->ImageBase));
         }
         Print(L"      </Caller>\n", SmiHandlerStruct->Handler);
+        if ((SmiStruct->Header.Revision >= 0x0002) && (SmiStruct->HandlerCategory != SmmCoreSmiHandlerCategoryHardwareHandler)) {
+          Print(L"      <Dispatch Count=\"%ld\" TotalLatencyNs=\"%ld\" MaxLatencyNs=\"%ld\" />\n", SmiHandlerStruct->DispatchCount, SmiHandlerStruct->TotalLatency, SmiHandlerStruct->MaxLatency);
+        }
         SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
         Print(L"    </SmiHandler>\n");
       }
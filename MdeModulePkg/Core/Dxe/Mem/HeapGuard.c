@@ -44,6 +44,20 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN mLevelShift[GUARDED_HEAP_MAP_TABLE_DEPTH]
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN mLevelMask[GUARDED_HEAP_MAP_TABLE_DEPTH]
                                     = GUARDED_HEAP_MAP_TABLE_DEPTH_MASKS;
 
+//
+// Number of allocations seen since the last guarded one, used to guard only
+// one in every PcdHeapGuardSampleRate allocations.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32 mGuardSampleCounter = 0;
+
+//
+// Guarded pool pages just freed, kept with their Guard pages and bitmap bits
+// still in place. An allocation of the same type and page count can take them
+// back without any page table attribute change.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED HEAP_GUARD_CACHE_ENTRY
+                              mGuardCache[HEAP_GUARD_CACHE_SIZE];
+
 /**
   Set corresponding bits in bitmap table to 1 according to the address.
 
@@ -728,6 +742,114 @@ IsPageTypeToGuard (
   return IsMemoryTypeToGuard (MemoryType, AllocateType, GUARD_HEAP_TYPE_PAGE);
 }
 
+/**
+  Check to see if the current allocation is sampled for Guard or not.
+
+  Only one in every PcdHeapGuardSampleRate allocations is guarded. This must
+  be called only after the allocation is known to be of a type to guard, so
+  that the sampling applies to guarded types only.
+
+  @return TRUE  The current allocation should be guarded.
+  @return FALSE The current allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampled (
+  VOID
+  )
+{
+  UINT32    SampleRate;
+
+  SampleRate = PcdGet32 (PcdHeapGuardSampleRate);
+  if (SampleRate <= 1) {
+    return TRUE;
+  }
+
+  mGuardSampleCounter += 1;
+  if (mGuardSampleCounter < SampleRate) {
+    return FALSE;
+  }
+
+  mGuardSampleCounter = 0;
+  return TRUE;
+}
+
+/**
+  Keep guarded pool pages just freed for reuse by a later allocation.
+
+  The Guard pages and the guarded bitmap of the memory are left untouched so
+  that no page table attribute update is needed now or on reuse. Only small
+  blocks of boot time memory types are kept.
+
+  Caller must hold the pool memory lock.
+
+  @param[in]  MemoryType      Memory type of the pages.
+  @param[in]  Memory          Base address of the guarded pages.
+  @param[in]  NumberOfPages   Number of guarded pages, not including Guards.
+
+  @return TRUE  The pages are kept and must not be freed by caller.
+  @return FALSE The pages are not kept and must be freed by caller.
+**/
+BOOLEAN
+RecycleGuardedPages (
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN EFI_PHYSICAL_ADDRESS   Memory,
+  IN UINTN                  NumberOfPages
+  )
+{
+  UINTN     Index;
+
+  if (NumberOfPages == 0 || NumberOfPages > HEAP_GUARD_CACHE_MAX_PAGES) {
+    return FALSE;
+  }
+
+  if (MemoryType != EfiBootServicesData && MemoryType != EfiBootServicesCode &&
+      MemoryType != EfiLoaderData && MemoryType != EfiLoaderCode) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < HEAP_GUARD_CACHE_SIZE; ++Index) {
+    if (mGuardCache[Index].NumberOfPages == 0) {
+      mGuardCache[Index].Memory        = Memory;
+      mGuardCache[Index].NumberOfPages = NumberOfPages;
+      mGuardCache[Index].MemoryType    = MemoryType;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Take back guarded pool pages kept by RecycleGuardedPages().
+
+  Caller must hold the pool memory lock.
+
+  @param[in]  MemoryType      Memory type of the pages wanted.
+  @param[in]  NumberOfPages   Number of pages wanted, not including Guards.
+
+  @return Base address of the guarded pages, or 0 if none matched.
+**/
+EFI_PHYSICAL_ADDRESS
+ReuseGuardedPages (
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  NumberOfPages
+  )
+{
+  UINTN                   Index;
+  EFI_PHYSICAL_ADDRESS    Memory;
+
+  for (Index = 0; Index < HEAP_GUARD_CACHE_SIZE; ++Index) {
+    if (mGuardCache[Index].NumberOfPages == NumberOfPages &&
+        mGuardCache[Index].MemoryType == MemoryType) {
+      Memory = mGuardCache[Index].Memory;
+      mGuardCache[Index].NumberOfPages = 0;
+      return Memory;
+    }
+  }
+
+  return 0;
+}
+
 /**
   Set head Guard and tail Guard for the given memory range.
 
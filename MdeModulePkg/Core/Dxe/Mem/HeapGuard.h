@@ -166,6 +166,19 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 //
 #define HEAP_GUARD_DEBUG_LEVEL  (DEBUG_POOL|DEBUG_PAGE)
 
+//
+// Number of freed guarded pool blocks kept for reuse, and the largest block
+// (in pages, not including Guards) which can be kept.
+//
+#define HEAP_GUARD_CACHE_SIZE       16
+#define HEAP_GUARD_CACHE_MAX_PAGES  4
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS  Memory;
+  UINTN                 NumberOfPages;
+  EFI_MEMORY_TYPE       MemoryType;
+} HEAP_GUARD_CACHE_ENTRY;
+
 typedef struct {
   UINT32                TailMark;
   UINT32                HeadMark;
@@ -322,6 +335,48 @@ IsPageTypeToGuard (
   IN EFI_ALLOCATE_TYPE      AllocateType
   );
 
+/**
+  Check to see if the current allocation is sampled for Guard or not.
+
+  @return TRUE  The current allocation should be guarded.
+  @return FALSE The current allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampled (
+  VOID
+  );
+
+/**
+  Keep guarded pool pages just freed for reuse by a later allocation.
+
+  @param[in]  MemoryType      Memory type of the pages.
+  @param[in]  Memory          Base address of the guarded pages.
+  @param[in]  NumberOfPages   Number of guarded pages, not including Guards.
+
+  @return TRUE  The pages are kept and must not be freed by caller.
+  @return FALSE The pages are not kept and must be freed by caller.
+**/
+BOOLEAN
+RecycleGuardedPages (
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN EFI_PHYSICAL_ADDRESS   Memory,
+  IN UINTN                  NumberOfPages
+  );
+
+/**
+  Take back guarded pool pages kept by RecycleGuardedPages().
+
+  @param[in]  MemoryType      Memory type of the pages wanted.
+  @param[in]  NumberOfPages   Number of pages wanted, not including Guards.
+
+  @return Base address of the guarded pages, or 0 if none matched.
+**/
+EFI_PHYSICAL_ADDRESS
+ReuseGuardedPages (
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  NumberOfPages
+  );
+
 /**
   Check to see if the page at the given address is guarded or not.
 
@@ -1387,7 +1387,8 @@ CoreAllocatePages (
   EFI_STATUS  Status;
   BOOLEAN     NeedGuard;
 
-  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding;
+  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding &&
+              IsGuardSampled ();
   Status = CoreInternalAllocatePages (Type, MemoryType, NumberOfPages, Memory,
                                       NeedGuard);
   if (!EFI_ERROR (Status)) {
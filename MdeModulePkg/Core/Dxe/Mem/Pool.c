@@ -240,7 +240,8 @@ CoreInternalAllocatePool (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding;
+  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding &&
+              IsGuardSampled ();
 
   //
   // Acquire the memory lock and make the allocation
@@ -319,6 +320,17 @@ CoreAllocatePoolPagesI (
   VOID        *Buffer;
   EFI_STATUS  Status;
 
+  //
+  // Guarded pages freed recently already have their Guards and memory
+  // protection in place. Take them back if any matches.
+  //
+  if (NeedGuard) {
+    Buffer = (VOID *)(UINTN)ReuseGuardedPages (PoolType, NoPages);
+    if (Buffer != NULL) {
+      return Buffer;
+    }
+  }
+
   Status = CoreAcquireLockOrFail (&gMemoryLock);
   if (EFI_ERROR (Status)) {
     return NULL;
@@ -638,6 +650,14 @@ CoreFreePoolPagesWithGuard (
   EFI_PHYSICAL_ADDRESS    MemoryGuarded;
   UINTN                   NoPagesGuarded;
 
+  //
+  // Keep small guarded blocks for reuse, which saves updating the page table
+  // attributes of the Guards both now and in the next allocation.
+  //
+  if (RecycleGuardedPages (PoolType, Memory, NoPages)) {
+    return;
+  }
+
   MemoryGuarded  = Memory;
   NoPagesGuarded = NoPages;
 
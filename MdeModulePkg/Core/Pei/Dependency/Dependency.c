@@ -87,6 +87,8 @@ IsPpiInstalled (
   @param PeiServices            An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation
   @param DependencyExpression   Pointer to a dependency expression.  The Grammar adheres to
                                 the BNF described above and is stored in postfix notation.
+  @param PpiHashMask            Optional pointer to return the bit mask of the PPI hash chains
+                                of the GUIDs in the dependency expression.
 
   @retval TRUE      if it is a well-formed Grammar
   @retval FALSE     if the dependency expression overflows the evaluation stack
@@ -97,7 +99,8 @@ IsPpiInstalled (
 BOOLEAN
 PeimDispatchReadiness (
   IN EFI_PEI_SERVICES   **PeiServices,
-  IN VOID               *DependencyExpression
+  IN VOID               *DependencyExpression,
+  OUT UINT32            *PpiHashMask OPTIONAL
   )
 {
   DEPENDENCY_EXPRESSION_OPERAND  *Iterator;
@@ -106,6 +109,10 @@ PeimDispatchReadiness (
 
   Iterator  = DependencyExpression;
 
+  if (PpiHashMask != NULL) {
+    *PpiHashMask = 0;
+  }
+
   StackPtr = EvalStack;
 
   while (TRUE) {
@@ -132,6 +139,9 @@ PeimDispatchReadiness (
         // We will evaluate if the PPI is insalled on the POP operation.
         //
         StackPtr->Operator = (VOID *) Iterator;
+        if (PpiHashMask != NULL) {
+          *PpiHashMask |= (UINT32) (1 << PpiGuidHash ((EFI_GUID *) Iterator));
+        }
         Iterator = Iterator + sizeof (EFI_GUID);
         DEBUG ((DEBUG_DISPATCH, "  PUSH GUID(%g) = %a\n", StackPtr->Operator, IsPpiInstalled (PeiServices, StackPtr) ? "TRUE" : "FALSE"));
         StackPtr++;
@@ -1290,6 +1290,22 @@ DepexSatisfied (
   EFI_STATUS           Status;
   VOID                 *DepexData;
   EFI_FV_FILE_INFO     FileInfo;
+  PEI_CORE_DEPEX_CACHE *DepexCache;
+  BOOLEAN              Satisfied;
+
+  //
+  // A DEPEX only depends on the PPIs it refers to. If the DEPEX was FALSE
+  // and no PPI has been installed in or removed from the hash chains of its
+  // GUIDs since, it is still FALSE, so don't search the PEIM for it again.
+  // A PPI reinstalled with a different GUID is removed from the chain of
+  // the old GUID, which matters to a DEPEX with NOT.
+  //
+  DepexCache = &Private->Fv[Private->CurrentPeimFvCount].DepexCache[PeimCount];
+  if ((PeimCount >= Private->AprioriCount) &&
+      (DepexCache->PpiInstallStamp != 0) &&
+      !IsPpiInstalledSince (Private, DepexCache->PpiHashMask, DepexCache->PpiInstallStamp)) {
+    return FALSE;
+  }
 
   Status = PeiServicesFfsGetFileInfo (FileHandle, &FileInfo);
   if (EFI_ERROR (Status)) {
@@ -1326,7 +1342,13 @@ DepexSatisfied (
   //
   // Evaluate a given DEPEX
   //
-  return PeimDispatchReadiness (&Private->Ps, DepexData);
+  Satisfied = PeimDispatchReadiness (&Private->Ps, DepexData, &DepexCache->PpiHashMask);
+  if (Satisfied) {
+    DepexCache->PpiInstallStamp = 0;
+  } else {
+    DepexCache->PpiInstallStamp = Private->PpiData.PpiInstallStamp;
+  }
+  return Satisfied;
 }
 
 /**
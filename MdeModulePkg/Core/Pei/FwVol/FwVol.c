@@ -248,6 +248,103 @@ FileHandleToVolume (
   return NULL;
 }
 
+/**
+  Search for the first matching file in the file index of a firmware volume.
+
+  The file index holds the same files, in the same order, as a walk of the FFS
+  headers performed by FindFileEx(), except for the pad files. So the search
+  result is the same as the one of the walk, without touching the flash again.
+
+  @param CoreFvHandle    Pointer to the indexed PEI_CORE_FV_HANDLE to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      Points to the current file handle, or NULL to start
+                         from the first file. Updated upon return.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @retval EFI_SUCCESS     Success to search given file
+  @retval EFI_NOT_FOUND   No files matching the search criteria were found
+  @retval EFI_UNSUPPORTED FileHandle is not a file of the file index, the
+                          caller needs to walk the FFS headers instead.
+
+**/
+EFI_STATUS
+FindFileInFileIndex (
+  IN        PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN  CONST EFI_GUID                 *FileName,   OPTIONAL
+  IN        EFI_FV_FILETYPE          SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  )
+{
+  PEI_CORE_FV_FILE_ENTRY                *FileIndex;
+  EFI_FFS_FILE_HEADER                   *FfsFileHeader;
+  UINTN                                 Index;
+  UINTN                                 Low;
+  UINTN                                 High;
+  UINTN                                 FileOffset;
+  UINT32                                NameKey;
+
+  FileIndex = CoreFvHandle->FileIndex;
+  Index     = 0;
+
+  if ((*FileHandle != NULL) && (FileName == NULL)) {
+    //
+    // The entries are sorted by offset, so find the position of the current
+    // file with a binary search and continue the search after it.
+    //
+    FileOffset = (UINTN) *FileHandle - (UINTN) CoreFvHandle->FvHeader;
+    Low        = 0;
+    High       = CoreFvHandle->FileIndexCount;
+    while (Low < High) {
+      Index = (Low + High) / 2;
+      if (FileIndex[Index].Offset < FileOffset) {
+        Low = Index + 1;
+      } else {
+        High = Index;
+      }
+    }
+    if ((Low >= CoreFvHandle->FileIndexCount) || (FileIndex[Low].Offset != FileOffset)) {
+      return EFI_UNSUPPORTED;
+    }
+    Index = Low + 1;
+  }
+
+  NameKey = 0;
+  if (FileName != NULL) {
+    NameKey = ReadUnaligned32 ((UINT32 *) FileName);
+  }
+
+  for (; Index < CoreFvHandle->FileIndexCount; Index++) {
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *) ((UINT8 *) CoreFvHandle->FvHeader + FileIndex[Index].Offset);
+    if (FileName != NULL) {
+      if ((FileIndex[Index].NameKey == NameKey) &&
+          CompareGuid (&FfsFileHeader->Name, (EFI_GUID *) FileName)) {
+        *FileHandle = (EFI_PEI_FILE_HANDLE) FfsFileHeader;
+        return EFI_SUCCESS;
+      }
+    } else if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
+      if ((FileIndex[Index].Type == EFI_FV_FILETYPE_PEIM) ||
+          (FileIndex[Index].Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+          (FileIndex[Index].Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE)) {
+        *FileHandle = (EFI_PEI_FILE_HANDLE) FfsFileHeader;
+        return EFI_SUCCESS;
+      } else if ((AprioriFile != NULL) && (FileIndex[Index].Type == EFI_FV_FILETYPE_FREEFORM)) {
+        if (CompareGuid (&FfsFileHeader->Name, &gPeiAprioriFileNameGuid)) {
+          *AprioriFile = (EFI_PEI_FILE_HANDLE) FfsFileHeader;
+        }
+      }
+    } else if ((SearchType == FileIndex[Index].Type) || (SearchType == EFI_FV_FILETYPE_ALL)) {
+      *FileHandle = (EFI_PEI_FILE_HANDLE) FfsFileHeader;
+      return EFI_SUCCESS;
+    }
+  }
+
+  *FileHandle = NULL;
+  return EFI_NOT_FOUND;
+}
+
 /**
   Given the input file pointer, search for the first matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -288,6 +385,9 @@ FindFileEx (
   UINT8                                 FileState;
   UINT8                                 DataCheckSum;
   BOOLEAN                               IsFfs3Fv;
+  PEI_CORE_INSTANCE                     *PrivateData;
+  UINTN                                 Index;
+  EFI_STATUS                            Status;
   
   //
   // Convert the handle of FV to FV header for memory-mapped firmware volume
@@ -295,6 +395,21 @@ FindFileEx (
   FwVolHeader = (EFI_FIRMWARE_VOLUME_HEADER *) FvHandle;
   FileHeader  = (EFI_FFS_FILE_HEADER **)FileHandle;
 
+  //
+  // Use the file index if the FV has been indexed by the PEI Core.
+  //
+  PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (GetPeiServicesTablePointer ());
+  for (Index = 0; Index < PrivateData->FvCount; Index++) {
+    if ((PrivateData->Fv[Index].FileIndex != NULL) &&
+        (PrivateData->Fv[Index].FvHeader == FwVolHeader)) {
+      Status = FindFileInFileIndex (&PrivateData->Fv[Index], FileName, SearchType, FileHandle, AprioriFile);
+      if (Status != EFI_UNSUPPORTED) {
+        return Status;
+      }
+      break;
+    }
+  }
+
   IsFfs3Fv = CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid);
 
   FvLength = FwVolHeader->FvLength;
@@ -452,6 +567,161 @@ FindFileEx (
   return EFI_NOT_FOUND;  
 }
 
+/**
+  Build the file index of a firmware volume known to the PEI Core.
+
+  The FFS headers of the FV are walked and checked only once here. The later
+  file searches in the FV are served from the index by FindFileEx(). Only the
+  FVs in FFS2 or FFS3 format that are processed by the FV PPIs of the PEI Core
+  are indexed. If the index can not be allocated, the FV is left unindexed.
+
+  @param CoreFvHandle    Pointer to the PEI_CORE_FV_HANDLE of the FV.
+
+**/
+VOID
+BuildFvFileIndex (
+  IN OUT PEI_CORE_FV_HANDLE       *CoreFvHandle
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader;
+  EFI_PEI_FILE_HANDLE         FileHandle;
+  PEI_CORE_FV_FILE_ENTRY      *FileIndex;
+  UINTN                       FileCount;
+  UINTN                       Index;
+
+  FwVolHeader = CoreFvHandle->FvHeader;
+  CoreFvHandle->FileIndex      = NULL;
+  CoreFvHandle->FileIndexCount = 0;
+
+  if ((CoreFvHandle->FvHandle != (EFI_PEI_FV_HANDLE) FwVolHeader) ||
+      (!CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem2Guid) &&
+       !CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid))) {
+    return;
+  }
+
+  FileCount  = 0;
+  FileHandle = NULL;
+  while (!EFI_ERROR (FindFileEx (FwVolHeader, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+    FileCount++;
+  }
+  if (FileCount == 0) {
+    return;
+  }
+
+  FileIndex = AllocatePool (FileCount * sizeof (PEI_CORE_FV_FILE_ENTRY));
+  if (FileIndex == NULL) {
+    return;
+  }
+
+  FileHandle = NULL;
+  for (Index = 0; Index < FileCount; Index++) {
+    if (EFI_ERROR (FindFileEx (FwVolHeader, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+      break;
+    }
+    FileIndex[Index].Offset  = (UINT32) ((UINTN) FileHandle - (UINTN) FwVolHeader);
+    FileIndex[Index].NameKey = ReadUnaligned32 ((UINT32 *) &((EFI_FFS_FILE_HEADER *) FileHandle)->Name);
+    FileIndex[Index].Type    = ((EFI_FFS_FILE_HEADER *) FileHandle)->Type;
+  }
+
+  CoreFvHandle->FileIndex      = FileIndex;
+  CoreFvHandle->FileIndexCount = Index;
+  DEBUG ((DEBUG_INFO, "Indexed %d files in FV at 0x%p\n", (UINT32) Index, FwVolHeader));
+}
+
+/**
+  Convert a pointer of the decoded section cache from the temporary memory to
+  PEI installed memory.
+
+  @param SecCoreData     Points to a data structure containing SEC to PEI handoff data.
+  @param PrivateData     Pointer to PeiCore's private data structure.
+  @param Pointer         Pointer to the pointer to convert.
+
+**/
+VOID
+ConvertCacheSectionPointer (
+  IN CONST EFI_SEC_PEI_HAND_OFF  *SecCoreData,
+  IN PEI_CORE_INSTANCE           *PrivateData,
+  IN OUT VOID                    **Pointer
+  )
+{
+  UINTN                 Address;
+  UINTN                 IndexHole;
+
+  Address = (UINTN) *Pointer;
+
+  //
+  // Memory pages are checked first as they may be allocated inside the old Heap.
+  //
+  if ((PrivateData->MemoryPages.Size != 0) &&
+      (Address >= (UINTN) PrivateData->MemoryPages.Base) &&
+      (Address < (UINTN) PrivateData->MemoryPages.Base + PrivateData->MemoryPages.Size)) {
+    if (PrivateData->MemoryPages.OffsetPositive) {
+      *Pointer = (VOID *) (Address + PrivateData->MemoryPages.Offset);
+    } else {
+      *Pointer = (VOID *) (Address - PrivateData->MemoryPages.Offset);
+    }
+    return;
+  }
+
+  if ((Address >= (UINTN) SecCoreData->PeiTemporaryRamBase) &&
+      (Address < (UINTN) SecCoreData->PeiTemporaryRamBase + SecCoreData->PeiTemporaryRamSize)) {
+    if (PrivateData->HeapOffsetPositive) {
+      *Pointer = (VOID *) (Address + PrivateData->HeapOffset);
+    } else {
+      *Pointer = (VOID *) (Address - PrivateData->HeapOffset);
+    }
+    return;
+  }
+
+  if ((Address >= (UINTN) SecCoreData->StackBase) &&
+      (Address < (UINTN) SecCoreData->StackBase + SecCoreData->StackSize)) {
+    if (PrivateData->StackOffsetPositive) {
+      *Pointer = (VOID *) (Address + PrivateData->StackOffset);
+    } else {
+      *Pointer = (VOID *) (Address - PrivateData->StackOffset);
+    }
+    return;
+  }
+
+  for (IndexHole = 0; IndexHole < HOLE_MAX_NUMBER; IndexHole ++) {
+    if ((PrivateData->HoleData[IndexHole].Size != 0) &&
+        (Address >= (UINTN) PrivateData->HoleData[IndexHole].Base) &&
+        (Address < (UINTN) PrivateData->HoleData[IndexHole].Base + PrivateData->HoleData[IndexHole].Size)) {
+      if (PrivateData->HoleData[IndexHole].OffsetPositive) {
+        *Pointer = (VOID *) (Address + PrivateData->HoleData[IndexHole].Offset);
+      } else {
+        *Pointer = (VOID *) (Address - PrivateData->HoleData[IndexHole].Offset);
+      }
+      return;
+    }
+  }
+}
+
+/**
+
+  Migrate the pointers of the decoded section cache from the temporary memory
+  to PEI installed memory, so that the cached sections can still be used after
+  permanent memory is installed.
+
+  @param SecCoreData     Points to a data structure containing SEC to PEI handoff data, such as the size 
+                         and location of temporary RAM, the stack location and the BFV location.
+  @param PrivateData     Pointer to PeiCore's private data structure.
+
+**/
+VOID
+ConvertCacheSectionPointers (
+  IN CONST EFI_SEC_PEI_HAND_OFF  *SecCoreData,
+  IN PEI_CORE_INSTANCE           *PrivateData
+  )
+{
+  UINTN                 Index;
+
+  for (Index = 0; Index < PrivateData->CacheSection.AllSectionCount; Index++) {
+    ConvertCacheSectionPointer (SecCoreData, PrivateData, (VOID **) &PrivateData->CacheSection.Section[Index]);
+    ConvertCacheSectionPointer (SecCoreData, PrivateData, &PrivateData->CacheSection.SectionData[Index]);
+  }
+}
+
 /**
   Initialize PeiCore Fv List.
 
@@ -518,6 +788,7 @@ PeiInitializeFv (
     FvHandle
     ));    
   PrivateData->FvCount ++;
+  BuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount - 1]);
                             
   //
   // Post a call-back for the FvInfoPPI and FvInfo2PPI services to expose
@@ -648,6 +919,7 @@ FirmwareVolmeInfoPpiNotifyCallback (
       FvHandle
       ));    
     PrivateData->FvCount ++;
+    BuildFvFileIndex (&PrivateData->Fv[CurFvCount]);
 
     //
     // Scan and process the new discoveried FV for EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE 
@@ -668,7 +940,7 @@ FirmwareVolmeInfoPpiNotifyCallback (
                           (VOID**)&DepexData
                           );
         if (!EFI_ERROR (Status)) {
-          if (!PeimDispatchReadiness (PeiServices, DepexData)) {
+          if (!PeimDispatchReadiness (PeiServices, DepexData, NULL)) {
             //
             // Dependency is not satisfied.
             //
@@ -2402,6 +2674,7 @@ ThirdPartyFvPpiNotifyCallback (
       FvHandle
       ));    
     PrivateData->FvCount ++;
+    BuildFvFileIndex (&PrivateData->Fv[CurFvCount]);
 
     //
     // Scan and process the new discoveried FV for EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE 
@@ -2422,7 +2695,7 @@ ThirdPartyFvPpiNotifyCallback (
                           (VOID**)&DepexData
                           );
         if (!EFI_ERROR (Status)) {
-          if (!PeimDispatchReadiness (PeiServices, DepexData)) {
+          if (!PeimDispatchReadiness (PeiServices, DepexData, NULL)) {
             //
             // Dependency is not satisfied.
             //
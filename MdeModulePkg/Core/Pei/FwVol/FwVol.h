@@ -308,6 +308,43 @@ FindFileEx (
   IN OUT    EFI_PEI_FV_HANDLE        *AprioriFile  OPTIONAL
   );
 
+/**
+  Search for the first matching file in the file index of a firmware volume.
+
+  @param CoreFvHandle    Pointer to the indexed PEI_CORE_FV_HANDLE to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      Points to the current file handle, or NULL to start
+                         from the first file. Updated upon return.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @retval EFI_SUCCESS     Success to search given file
+  @retval EFI_NOT_FOUND   No files matching the search criteria were found
+  @retval EFI_UNSUPPORTED FileHandle is not a file of the file index, the
+                          caller needs to walk the FFS headers instead.
+
+**/
+EFI_STATUS
+FindFileInFileIndex (
+  IN        PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN  CONST EFI_GUID                 *FileName,   OPTIONAL
+  IN        EFI_FV_FILETYPE          SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  );
+
+/**
+  Build the file index of a firmware volume known to the PEI Core.
+
+  @param CoreFvHandle    Pointer to the PEI_CORE_FV_HANDLE of the FV.
+
+**/
+VOID
+BuildFvFileIndex (
+  IN OUT PEI_CORE_FV_HANDLE       *CoreFvHandle
+  );
+
 /**
   Report the information for a new discoveried FV in unknown format.
   
@@ -65,6 +65,13 @@ typedef union {
   VOID                        *Raw;
 } PEI_PPI_LIST_POINTERS;
 
+///
+/// Number of hash buckets of the PPI database index. It must be a power of 2
+/// and not bigger than 32, so that the buckets a DEPEX refers to fit in a
+/// UINT32 bit mask.
+///
+#define PEI_PPI_HASH_BUCKET_COUNT  16
+
 ///
 /// PPI database structure which contains two link: PpiList and NotifyList. PpiList
 /// is in head of PpiListPtrs array and notify is in end of PpiListPtrs.
@@ -94,6 +101,25 @@ typedef struct {
   /// Ppi database has the PcdPeiCoreMaxPpiSupported number of entries.
   ///
   PEI_PPI_LIST_POINTERS   *PpiListPtrs;
+  ///
+  /// Index of the first and the last installed PPI in each hash chain,
+  /// -1 if the chain is empty.
+  ///
+  INTN                    PpiHashHead[PEI_PPI_HASH_BUCKET_COUNT];
+  INTN                    PpiHashTail[PEI_PPI_HASH_BUCKET_COUNT];
+  ///
+  /// Index of the next installed PPI in the same hash chain, -1 for the end
+  /// of the chain. The chains are kept in install order. It has the
+  /// PcdPeiCoreMaxPpiSupported number of entries.
+  ///
+  INTN                    *PpiHashNext;
+  ///
+  /// Count of PPI installations and removals, and its value when a PPI was
+  /// last installed in or removed from each hash chain. A PPI is only removed
+  /// from a chain when it is reinstalled with a different GUID.
+  ///
+  UINT32                  PpiInstallStamp;
+  UINT32                  PpiHashStamp[PEI_PPI_HASH_BUCKET_COUNT];
 } PEI_PPI_DATABASE;
 
 
@@ -107,6 +133,38 @@ typedef struct {
 #define PEIM_STATE_REGISITER_FOR_SHADOW   0x02
 #define PEIM_STATE_DONE                   0x03
 
+///
+/// Result of the last DEPEX evaluation of a PEIM that is not dispatched yet.
+///
+typedef struct {
+  ///
+  /// Bit mask of the PPI hash chains of the GUIDs in the DEPEX.
+  ///
+  UINT32                              PpiHashMask;
+  ///
+  /// PpiInstallStamp of the PPI database when the DEPEX evaluated to FALSE,
+  /// 0 if the DEPEX needs to be evaluated.
+  ///
+  UINT32                              PpiInstallStamp;
+} PEI_CORE_DEPEX_CACHE;
+
+///
+/// Entry of the file index of a firmware volume. The file index records the
+/// valid FFS files of the FV in order, so that file searches do not need to
+/// walk and checksum the FFS headers again.
+///
+typedef struct {
+  ///
+  /// Offset of the FFS file header from the start of the FV.
+  ///
+  UINT32                              Offset;
+  ///
+  /// First 32 bits of the file name, used to skip mismatched files.
+  ///
+  UINT32                              NameKey;
+  EFI_FV_FILETYPE                     Type;
+} PEI_CORE_FV_FILE_ENTRY;
+
 typedef struct {
   EFI_FIRMWARE_VOLUME_HEADER          *FvHeader;
   EFI_PEI_FIRMWARE_VOLUME_PPI         *FvPpi;
@@ -119,8 +177,17 @@ typedef struct {
   // Ponter to the buffer with the PcdPeiCoreMaxPeimPerFv number of Entries.
   //
   EFI_PEI_FILE_HANDLE                 *FvFileHandles;
+  //
+  // Ponter to the buffer with the PcdPeiCoreMaxPeimPerFv number of Entries.
+  //
+  PEI_CORE_DEPEX_CACHE                *DepexCache;
   BOOLEAN                             ScanFv;
   UINT32                              AuthenticationStatus;
+  //
+  // Pointer to the file index of the FV, NULL if the FV is not indexed.
+  //
+  PEI_CORE_FV_FILE_ENTRY              *FileIndex;
+  UINTN                               FileIndexCount;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -344,6 +411,8 @@ PeiCore (
   @param PeiServices            An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
   @param DependencyExpression   Pointer to a dependency expression.  The Grammar adheres to
                                 the BNF described above and is stored in postfix notation.
+  @param PpiHashMask            Optional pointer to return the bit mask of the PPI hash chains
+                                of the GUIDs in the dependency expression.
 
   @retval TRUE      if it is a well-formed Grammar
   @retval FALSE     if the dependency expression overflows the evaluation stack
@@ -354,7 +423,8 @@ PeiCore (
 BOOLEAN
 PeimDispatchReadiness (
   IN EFI_PEI_SERVICES   **PeiServices,
-  IN VOID               *DependencyExpression
+  IN VOID               *DependencyExpression,
+  OUT UINT32            *PpiHashMask OPTIONAL
   );
 
 /**
@@ -425,6 +495,40 @@ InitializePpiServices (
   IN PEI_CORE_INSTANCE   *OldCoreData
   );
 
+/**
+
+  Get the hash chain of a PPI GUID in the PPI database.
+
+  @param Guid            Pointer to the PPI GUID. It does not need to be aligned.
+
+  @return The index of the hash chain, less than PEI_PPI_HASH_BUCKET_COUNT.
+
+**/
+UINTN
+PpiGuidHash (
+  IN CONST EFI_GUID      *Guid
+  );
+
+/**
+
+  Check whether any PPI has been installed in, or removed from, the given
+  hash chains since the PPI database had the given install stamp.
+
+  @param PrivateData     Pointer to the PEI Core data.
+  @param PpiHashMask     Bit mask of the hash chains to check.
+  @param PpiInstallStamp The PpiInstallStamp of the PPI database to compare with.
+
+  @retval TRUE           One of the hash chains has changed.
+  @retval FALSE          None of the hash chains has changed.
+
+**/
+BOOLEAN
+IsPpiInstalledSince (
+  IN PEI_CORE_INSTANCE   *PrivateData,
+  IN UINT32              PpiHashMask,
+  IN UINT32              PpiInstallStamp
+  );
+
 /**
 
   Migrate the Hob list from the temporary memory to PEI installed memory.
@@ -440,6 +544,23 @@ ConvertPpiPointers (
   IN PEI_CORE_INSTANCE           *PrivateData
   );
 
+/**
+
+  Migrate the pointers of the decoded section cache from the temporary memory
+  to PEI installed memory, so that the cached sections can still be used after
+  permanent memory is installed.
+
+  @param SecCoreData     Points to a data structure containing SEC to PEI handoff data, such as the size 
+                         and location of temporary RAM, the stack location and the BFV location.
+  @param PrivateData     Pointer to PeiCore's private data structure.
+
+**/
+VOID
+ConvertCacheSectionPointers (
+  IN CONST EFI_SEC_PEI_HAND_OFF  *SecCoreData,
+  IN PEI_CORE_INSTANCE           *PrivateData
+  );
+
 /**
 
   Install PPI services. It is implementation of EFI_PEI_SERVICE.InstallPpi.
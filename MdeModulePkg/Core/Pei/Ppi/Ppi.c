@@ -29,11 +29,162 @@ InitializePpiServices (
   IN PEI_CORE_INSTANCE *OldCoreData
   )
 {
+  UINTN  Bucket;
+
   if (OldCoreData == NULL) {
     PrivateData->PpiData.NotifyListEnd = PcdGet32 (PcdPeiCoreMaxPpiSupported)-1;
     PrivateData->PpiData.DispatchListEnd = PcdGet32 (PcdPeiCoreMaxPpiSupported)-1;
     PrivateData->PpiData.LastDispatchedNotify = PcdGet32 (PcdPeiCoreMaxPpiSupported)-1;
+    for (Bucket = 0; Bucket < PEI_PPI_HASH_BUCKET_COUNT; Bucket++) {
+      PrivateData->PpiData.PpiHashHead[Bucket] = -1;
+      PrivateData->PpiData.PpiHashTail[Bucket] = -1;
+    }
+  }
+}
+
+/**
+
+  Get the hash chain of a PPI GUID in the PPI database.
+
+  @param Guid            Pointer to the PPI GUID. It does not need to be aligned.
+
+  @return The index of the hash chain, less than PEI_PPI_HASH_BUCKET_COUNT.
+
+**/
+UINTN
+PpiGuidHash (
+  IN CONST EFI_GUID      *Guid
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *) Guid) ^
+         ReadUnaligned32 ((CONST UINT32 *) Guid + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *) Guid + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *) Guid + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+  return (UINTN) (Hash & (PEI_PPI_HASH_BUCKET_COUNT - 1));
+}
+
+/**
+
+  Link an installed PPI into its hash chain. The chain is kept in the order
+  of the PPI database so that instances are found in install order.
+
+  @param PpiData         Pointer to the PPI database.
+  @param Index           Index of the PPI in the PPI database.
+
+**/
+VOID
+InsertPpiHash (
+  IN PEI_PPI_DATABASE    *PpiData,
+  IN INTN                Index
+  )
+{
+  UINTN  Bucket;
+  INTN   Prev;
+
+  Bucket = PpiGuidHash (PpiData->PpiListPtrs[Index].Ppi->Guid);
+
+  if (PpiData->PpiHashTail[Bucket] < Index) {
+    //
+    // New PPIs are always installed at the end of the database.
+    //
+    PpiData->PpiHashNext[Index] = -1;
+    if (PpiData->PpiHashTail[Bucket] < 0) {
+      PpiData->PpiHashHead[Bucket] = Index;
+    } else {
+      PpiData->PpiHashNext[PpiData->PpiHashTail[Bucket]] = Index;
+    }
+    PpiData->PpiHashTail[Bucket] = Index;
+  } else if (PpiData->PpiHashHead[Bucket] > Index) {
+    PpiData->PpiHashNext[Index] = PpiData->PpiHashHead[Bucket];
+    PpiData->PpiHashHead[Bucket] = Index;
+  } else {
+    //
+    // A reinstalled PPI with a different GUID keeps its place in the database.
+    //
+    Prev = PpiData->PpiHashHead[Bucket];
+    while (PpiData->PpiHashNext[Prev] < Index) {
+      Prev = PpiData->PpiHashNext[Prev];
+    }
+    PpiData->PpiHashNext[Index] = PpiData->PpiHashNext[Prev];
+    PpiData->PpiHashNext[Prev]  = Index;
   }
+
+  PpiData->PpiInstallStamp++;
+  PpiData->PpiHashStamp[Bucket] = PpiData->PpiInstallStamp;
+}
+
+/**
+
+  Unlink an installed PPI from its hash chain. This also counts as a change
+  of the chain, since a DEPEX may depend on the PPI not being installed.
+
+  @param PpiData         Pointer to the PPI database.
+  @param Index           Index of the PPI in the PPI database.
+
+**/
+VOID
+RemovePpiHash (
+  IN PEI_PPI_DATABASE    *PpiData,
+  IN INTN                Index
+  )
+{
+  UINTN  Bucket;
+  INTN   Prev;
+
+  Bucket = PpiGuidHash (PpiData->PpiListPtrs[Index].Ppi->Guid);
+
+  if (PpiData->PpiHashHead[Bucket] == Index) {
+    PpiData->PpiHashHead[Bucket] = PpiData->PpiHashNext[Index];
+    Prev = -1;
+  } else {
+    Prev = PpiData->PpiHashHead[Bucket];
+    while (PpiData->PpiHashNext[Prev] != Index) {
+      Prev = PpiData->PpiHashNext[Prev];
+    }
+    PpiData->PpiHashNext[Prev] = PpiData->PpiHashNext[Index];
+  }
+
+  if (PpiData->PpiHashTail[Bucket] == Index) {
+    PpiData->PpiHashTail[Bucket] = Prev;
+  }
+
+  PpiData->PpiInstallStamp++;
+  PpiData->PpiHashStamp[Bucket] = PpiData->PpiInstallStamp;
+}
+
+/**
+
+  Check whether any PPI has been installed in, or removed from, the given
+  hash chains since the PPI database had the given install stamp.
+
+  @param PrivateData     Pointer to the PEI Core data.
+  @param PpiHashMask     Bit mask of the hash chains to check.
+  @param PpiInstallStamp The PpiInstallStamp of the PPI database to compare with.
+
+  @retval TRUE           One of the hash chains has changed.
+  @retval FALSE          None of the hash chains has changed.
+
+**/
+BOOLEAN
+IsPpiInstalledSince (
+  IN PEI_CORE_INSTANCE   *PrivateData,
+  IN UINT32              PpiHashMask,
+  IN UINT32              PpiInstallStamp
+  )
+{
+  UINTN  Bucket;
+
+  for (Bucket = 0; PpiHashMask != 0; Bucket++, PpiHashMask >>= 1) {
+    if (((PpiHashMask & 1) != 0) && (PrivateData->PpiData.PpiHashStamp[Bucket] > PpiInstallStamp)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
 }
 
 /**
@@ -229,6 +380,12 @@ InternalPeiInstallPpi (
     // PcdPeiCoreMaxPpiSupported can be set to a larger value in DSC to satisfy more PPI requirement.
     //
     if (Index == PrivateData->PpiData.NotifyListEnd + 1) {
+      //
+      // The PPIs before this one in the list stay installed.
+      //
+      for (Index = LastCallbackInstall; Index < PrivateData->PpiData.PpiListEnd; Index++) {
+        InsertPpiHash (&PrivateData->PpiData, Index);
+      }
       return  EFI_OUT_OF_RESOURCES;
     }
     //
@@ -262,6 +419,14 @@ InternalPeiInstallPpi (
     Index++;
   }
 
+  //
+  // Add the newly installed PPIs to the hash index once the whole list is
+  // known to be valid.
+  //
+  for (Index = LastCallbackInstall; Index < PrivateData->PpiData.PpiListEnd; Index++) {
+    InsertPpiHash (&PrivateData->PpiData, Index);
+  }
+
   //
   // Dispatch any callback level notifies for newly installed PPIs.
   //
@@ -360,7 +525,13 @@ PeiReInstallPpi (
   //
   DEBUG((EFI_D_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
   ASSERT (Index < (INTN)(PcdGet32 (PcdPeiCoreMaxPpiSupported)));
-  PrivateData->PpiData.PpiListPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *) NewPpi;
+  if (CompareGuid (OldPpi->Guid, NewPpi->Guid)) {
+    PrivateData->PpiData.PpiListPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *) NewPpi;
+  } else {
+    RemovePpiHash (&PrivateData->PpiData, Index);
+    PrivateData->PpiData.PpiListPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *) NewPpi;
+    InsertPpiHash (&PrivateData->PpiData, Index);
+  }
 
   //
   // Dispatch any callback level notifies for the newly installed PPI.
@@ -413,9 +584,11 @@ PeiLocatePpi (
   PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS(PeiServices);
 
   //
-  // Search the data base for the matching instance of the GUIDed PPI.
+  // Search the hash chain of the GUID for the matching instance of the GUIDed PPI.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiListEnd; Index++) {
+  for (Index = PrivateData->PpiData.PpiHashHead[PpiGuidHash (Guid)];
+       Index >= 0;
+       Index = PrivateData->PpiData.PpiHashNext[Index]) {
     TempPtr = PrivateData->PpiData.PpiListPtrs[Index].Ppi;
     CheckGuid = TempPtr->Guid;
 
@@ -701,7 +874,17 @@ DispatchNotify (
 
     CheckGuid = NotifyDescriptor->Guid;
 
-    for (Index2 = InstallStartIndex; Index2 < InstallStopIndex; Index2++) {
+    //
+    // Only the PPIs in the hash chain of the GUID may match. The chain is in
+    // install order, so the PPIs are notified in the same order as they were
+    // installed.
+    //
+    for (Index2 = PrivateData->PpiData.PpiHashHead[PpiGuidHash (CheckGuid)];
+         (Index2 >= 0) && (Index2 < InstallStopIndex);
+         Index2 = PrivateData->PpiData.PpiHashNext[Index2]) {
+      if (Index2 < InstallStartIndex) {
+        continue;
+      }
       SearchGuid = PrivateData->PpiData.PpiListPtrs[Index2].Ppi->Guid;
       //
       // Don't use CompareGuid function here for performance reasons.
@@ -86,8 +86,14 @@ typedef struct {
 
   EFI_GUID    HandlerType; // Type of interrupt
   LIST_ENTRY  SmiHandlers; // All handlers
+  LIST_ENTRY  HashLink;    // Link on the hash bucket of HandlerType
 } SMI_ENTRY;
 
+//
+// Number of hash buckets SMI entries are looked up through, must be a power of 2
+//
+#define SMI_ENTRY_HASH_SIZE  32
+
 #define SMI_HANDLER_SIGNATURE  SIGNATURE_32('s','m','i','h')
 
  typedef struct {
@@ -98,6 +104,11 @@ typedef struct {
   SMI_ENTRY                     *SmiEntry;
   VOID                          *Context;    // for profile
   UINTN                         ContextSize; // for profile
+  UINT64                        DispatchCount; // for profile
+  UINT64                        TotalTicks;    // for profile
+  UINT64                        MaxTicks;      // for profile
+  SMM_CORE_SMI_HANDLER_STRUCTURE *ProfileData; // for profile
+  BOOLEAN                       ToRemove;    // Unregistered while SMIs were being dispatched
 } SMI_HANDLER;
 
 //
@@ -1131,6 +1142,18 @@ SmmCoreInitializeSmiHandlerProfile (
   VOID
   );
 
+/**
+  Record the time an SMI handler took to run.
+
+  @param SmiHandler  The SMI handler that was dispatched.
+  @param StartTicks  The performance counter value before it was dispatched.
+**/
+VOID
+SmiHandlerProfileRecordLatency (
+  IN SMI_HANDLER  *SmiHandler,
+  IN UINT64       StartTicks
+  );
+
 /**
   This function is called by SmmChildDispatcher module to report
   a new SMI handler is registered, to SmmCore.
@@ -1263,6 +1286,13 @@ typedef enum {
 
 extern LIST_ENTRY  mSmmPoolLists[SmmPoolTypeMax][MAX_POOL_INDEX];
 
+//
+// Number of pages the pool carves into free blocks each time all of its free
+// lists for a pool type are empty, so that page allocation is amortized over
+// many small pool allocations.
+//
+#define SMM_POOL_SLAB_PAGES  4
+
 /**
   Internal Function. Allocate n pages from given free page node.
 
@@ -16,6 +16,10 @@
 
 LIST_ENTRY  mSmmPoolLists[SmmPoolTypeMax][MAX_POOL_INDEX];
 //
+// Bit N is set when mSmmPoolLists[SmmPoolType][N] is not empty.
+//
+UINT32      mSmmPoolListBitmap[SmmPoolTypeMax];
+//
 // To cache the SMRAM base since when Loading modules At fixed address feature is enabled, 
 // all module is assigned an offset relative the SMRAM base in build time.
 //
@@ -113,9 +117,92 @@ SmmInitializeMemoryServices (
 
 }
 
+/**
+  Internal Function. Put a free pool block on the free list of its size.
+
+  @param  SmmPoolType           SMM pool type of the block.
+  @param  PoolIndex             Index which indicate the Pool size.
+  @param  FreePoolHdr           The free pool block.
+
+**/
+VOID
+InternalInsertFreePool (
+  IN SMM_POOL_TYPE     SmmPoolType,
+  IN UINTN             PoolIndex,
+  IN FREE_POOL_HEADER  *FreePoolHdr
+  )
+{
+  POOL_TAIL             *Tail;
+
+  ASSERT (PoolIndex < MAX_POOL_INDEX);
+  FreePoolHdr->Header.Signature = 0;
+  FreePoolHdr->Header.Size = MIN_POOL_SIZE << PoolIndex;
+  FreePoolHdr->Header.Available = TRUE;
+  FreePoolHdr->Header.Type = 0;
+  Tail = HEAD_TO_TAIL(&FreePoolHdr->Header);
+  Tail->Signature = 0;
+  Tail->Size = 0;
+  InsertHeadList (&mSmmPoolLists[SmmPoolType][PoolIndex], &FreePoolHdr->Link);
+  mSmmPoolListBitmap[SmmPoolType] |= (UINT32)(1 << PoolIndex);
+}
+
+/**
+  Internal Function. Carve a slab of pages into free pool blocks.
+
+  SMM_POOL_SLAB_PAGES pages are requested at once, falling back to a single
+  page when SMRAM is short. The first MAX_POOL_SIZE * 2 bytes are returned to
+  the caller and the rest are put on the free list of the largest pool size.
+
+  @param  PoolType              Type of pool to allocate.
+  @param  SmmPoolType           SMM pool type of PoolType.
+  @param  FreePoolHdr           The returned block of MAX_POOL_SIZE * 2 bytes.
+
+  @retval EFI_OUT_OF_RESOURCES   Allocation failed.
+  @retval EFI_SUCCESS            Slab successfully allocated.
+
+**/
+EFI_STATUS
+InternalAllocPoolSlab (
+  IN  EFI_MEMORY_TYPE   PoolType,
+  IN  SMM_POOL_TYPE     SmmPoolType,
+  OUT FREE_POOL_HEADER  **FreePoolHdr
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  Address;
+  UINTN                 NoPages;
+  UINTN                 Offset;
+
+  NoPages = SMM_POOL_SLAB_PAGES * EFI_SIZE_TO_PAGES (MAX_POOL_SIZE << 1);
+  Status  = SmmInternalAllocatePages (AllocateAnyPages, PoolType, NoPages, &Address, FALSE);
+  if (EFI_ERROR (Status)) {
+    NoPages = EFI_SIZE_TO_PAGES (MAX_POOL_SIZE << 1);
+    Status  = SmmInternalAllocatePages (AllocateAnyPages, PoolType, NoPages, &Address, FALSE);
+    if (EFI_ERROR (Status)) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  for (Offset = EFI_PAGES_TO_SIZE (NoPages); Offset > (MAX_POOL_SIZE << 1);) {
+    Offset -= MAX_POOL_SIZE;
+    InternalInsertFreePool (
+      SmmPoolType,
+      MAX_POOL_INDEX - 1,
+      (FREE_POOL_HEADER *)(UINTN)(Address + Offset)
+      );
+  }
+
+  *FreePoolHdr = (FREE_POOL_HEADER *)(UINTN)Address;
+  return EFI_SUCCESS;
+}
+
 /**
   Internal Function. Allocate a pool by specified PoolIndex.
 
+  The smallest non-empty free list that can satisfy the request is found from
+  a bitmap in constant time, and the block taken from it is split down to the
+  requested size. Only when all free lists are empty are pages allocated.
+
   @param  PoolType              Type of pool to allocate.
   @param  PoolIndex             Index which indicate the Pool size.
   @param  FreePoolHdr           The returned Free pool.
@@ -134,53 +221,52 @@ InternalAllocPoolByIndex (
   EFI_STATUS            Status;
   FREE_POOL_HEADER      *Hdr;
   POOL_TAIL             *Tail;
-  EFI_PHYSICAL_ADDRESS  Address;
   SMM_POOL_TYPE         SmmPoolType;
+  UINT32                Bitmap;
+  UINTN                 Index;
 
-  Address     = 0;
   SmmPoolType = UefiMemoryTypeToSmmPoolType(PoolType);
 
-  ASSERT (PoolIndex <= MAX_POOL_INDEX);
-  Status = EFI_SUCCESS;
-  Hdr = NULL;
-  if (PoolIndex == MAX_POOL_INDEX) {
-    Status = SmmInternalAllocatePages (AllocateAnyPages, PoolType,
-                                       EFI_SIZE_TO_PAGES (MAX_POOL_SIZE << 1),
-                                       &Address, FALSE);
-    if (EFI_ERROR (Status)) {
-      return EFI_OUT_OF_RESOURCES;
-    }
-    Hdr = (FREE_POOL_HEADER *) (UINTN) Address;
-  } else if (!IsListEmpty (&mSmmPoolLists[SmmPoolType][PoolIndex])) {
-    Hdr = BASE_CR (GetFirstNode (&mSmmPoolLists[SmmPoolType][PoolIndex]), FREE_POOL_HEADER, Link);
+  ASSERT (PoolIndex < MAX_POOL_INDEX);
+  Bitmap = mSmmPoolListBitmap[SmmPoolType] & ((UINT32)-1 << PoolIndex);
+  if (Bitmap != 0) {
+    Index = (UINTN) LowBitSet32 (Bitmap);
+    Hdr = BASE_CR (GetFirstNode (&mSmmPoolLists[SmmPoolType][Index]), FREE_POOL_HEADER, Link);
     RemoveEntryList (&Hdr->Link);
+    if (IsListEmpty (&mSmmPoolLists[SmmPoolType][Index])) {
+      mSmmPoolListBitmap[SmmPoolType] &= ~(UINT32)(1 << Index);
+    }
   } else {
-    Status = InternalAllocPoolByIndex (PoolType, PoolIndex + 1, &Hdr);
-    if (!EFI_ERROR (Status)) {
-      Hdr->Header.Signature = 0;
-      Hdr->Header.Size >>= 1;
-      Hdr->Header.Available = TRUE;
-      Hdr->Header.Type = 0;
-      Tail = HEAD_TO_TAIL(&Hdr->Header);
-      Tail->Signature = 0;
-      Tail->Size = 0;
-      InsertHeadList (&mSmmPoolLists[SmmPoolType][PoolIndex], &Hdr->Link);
-      Hdr = (FREE_POOL_HEADER*)((UINT8*)Hdr + Hdr->Header.Size);
+    Status = InternalAllocPoolSlab (PoolType, SmmPoolType, &Hdr);
+    if (EFI_ERROR (Status)) {
+      *FreePoolHdr = NULL;
+      return Status;
     }
+    Index = MAX_POOL_INDEX;
   }
 
-  if (!EFI_ERROR (Status)) {
-    Hdr->Header.Signature = POOL_HEAD_SIGNATURE;
-    Hdr->Header.Size = MIN_POOL_SIZE << PoolIndex;
-    Hdr->Header.Available = FALSE;
-    Hdr->Header.Type = PoolType;
-    Tail = HEAD_TO_TAIL(&Hdr->Header);
-    Tail->Signature = POOL_TAIL_SIGNATURE;
-    Tail->Size = Hdr->Header.Size;
+  //
+  // Split the block, keeping the upper half of each split on the free lists
+  //
+  while (Index > PoolIndex) {
+    Index--;
+    InternalInsertFreePool (
+      SmmPoolType,
+      Index,
+      (FREE_POOL_HEADER *)((UINT8 *)Hdr + (MIN_POOL_SIZE << Index))
+      );
   }
 
+  Hdr->Header.Signature = POOL_HEAD_SIGNATURE;
+  Hdr->Header.Size = MIN_POOL_SIZE << PoolIndex;
+  Hdr->Header.Available = FALSE;
+  Hdr->Header.Type = PoolType;
+  Tail = HEAD_TO_TAIL(&Hdr->Header);
+  Tail->Signature = POOL_TAIL_SIGNATURE;
+  Tail->Size = Hdr->Header.Size;
+
   *FreePoolHdr = Hdr;
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -208,13 +294,8 @@ InternalFreePoolByIndex (
   SmmPoolType = UefiMemoryTypeToSmmPoolType(FreePoolHdr->Header.Type);
 
   PoolIndex = (UINTN) (HighBitSet32 ((UINT32)FreePoolHdr->Header.Size) - MIN_POOL_SHIFT);
-  FreePoolHdr->Header.Signature = 0;
-  FreePoolHdr->Header.Available = TRUE;
-  FreePoolHdr->Header.Type = 0;
-  PoolTail->Signature = 0;
-  PoolTail->Size = 0;
   ASSERT (PoolIndex < MAX_POOL_INDEX);
-  InsertHeadList (&mSmmPoolLists[SmmPoolType][PoolIndex], &FreePoolHdr->Link);
+  InternalInsertFreePool (SmmPoolType, PoolIndex, FreePoolHdr);
   return EFI_SUCCESS;
 }
 
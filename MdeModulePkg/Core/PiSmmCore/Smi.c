@@ -16,13 +16,62 @@
 
 LIST_ENTRY  mSmiEntryList       = INITIALIZE_LIST_HEAD_VARIABLE (mSmiEntryList);
 
+//
+// SMI entries hashed by HandlerType, so that SmiManage() does not compare the
+// GUID of every registered entry on each SMI.
+//
+LIST_ENTRY  mSmiEntryHashTable[SMI_ENTRY_HASH_SIZE];
+
 SMI_ENTRY   mRootSmiEntry = {
   SMI_ENTRY_SIGNATURE,
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.AllEntries),
   {0},
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.SmiHandlers),
+  INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.HashLink),
 };
 
+//
+// Set when SMI handler profile is enabled, to time every dispatched handler.
+//
+BOOLEAN     mSmiHandlerLatencyEnabled = FALSE;
+
+//
+// Nesting depth of SmiManage(). Handlers unregistered while it is non-zero
+// are only freed once the outermost SmiManage() returns.
+//
+UINTN       mSmiManageCallingDepth = 0;
+
+/**
+  Get the hash bucket of an SMI handler type.
+
+  @param  HandlerType            The type of the interrupt
+
+  @return The hash bucket of HandlerType.
+
+**/
+LIST_ENTRY *
+SmmCoreGetSmiEntryHashBucket (
+  IN CONST EFI_GUID  *HandlerType
+  )
+{
+  UINT32      Hash;
+  UINTN       Index;
+
+  if (mSmiEntryHashTable[0].ForwardLink == NULL) {
+    for (Index = 0; Index < SMI_ENTRY_HASH_SIZE; Index++) {
+      InitializeListHead (&mSmiEntryHashTable[Index]);
+    }
+  }
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)HandlerType);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 1);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 2);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+  return &mSmiEntryHashTable[Hash & (SMI_ENTRY_HASH_SIZE - 1)];
+}
+
 /**
   Finds the SMI entry for the requested handler type.
 
@@ -39,19 +88,21 @@ SmmCoreFindSmiEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY  *Bucket;
   LIST_ENTRY  *Link;
   SMI_ENTRY   *Item;
   SMI_ENTRY   *SmiEntry;
 
   //
-  // Search the SMI entry list for the matching GUID
+  // Search the hash bucket of the GUID for the matching SMI entry
   //
   SmiEntry = NULL;
-  for (Link = mSmiEntryList.ForwardLink;
-       Link != &mSmiEntryList;
+  Bucket   = SmmCoreGetSmiEntryHashBucket (HandlerType);
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink) {
 
-    Item = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+    Item = CR (Link, SMI_ENTRY, HashLink, SMI_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->HandlerType, HandlerType)) {
       //
       // This is the SMI entry
@@ -76,14 +127,77 @@ SmmCoreFindSmiEntry (
       InitializeListHead (&SmiEntry->SmiHandlers);
 
       //
-      // Add it to SMI entry list
+      // Add it to SMI entry list and its hash bucket
       //
       InsertTailList (&mSmiEntryList, &SmiEntry->AllEntries);
+      InsertTailList (Bucket, &SmiEntry->HashLink);
     }
   }
   return SmiEntry;
 }
 
+/**
+  Remove an SMI handler from its SMI entry and free it, along with the SMI
+  entry if no handler is left on it.
+
+  @param  SmiHandler     The SMI handler to remove.
+
+**/
+VOID
+RemoveSmiHandler (
+  IN SMI_HANDLER  *SmiHandler
+  )
+{
+  SMI_ENTRY    *SmiEntry;
+
+  SmiEntry = SmiHandler->SmiEntry;
+
+  RemoveEntryList (&SmiHandler->Link);
+  FreePool (SmiHandler);
+
+  if (SmiEntry == NULL) {
+    //
+    // This is root SMI handler
+    //
+    return;
+  }
+
+  if (IsListEmpty (&SmiEntry->SmiHandlers)) {
+    //
+    // No handler registered for this interrupt now, remove the SMI_ENTRY
+    //
+    RemoveEntryList (&SmiEntry->AllEntries);
+    RemoveEntryList (&SmiEntry->HashLink);
+
+    FreePool (SmiEntry);
+  }
+}
+
+/**
+  Remove the SMI handlers which were unregistered while SMIs were being
+  dispatched.
+
+  @param  Head           The list of SMI handlers.
+
+**/
+VOID
+RemoveSmiHandlersToRemove (
+  IN LIST_ENTRY  *Head
+  )
+{
+  LIST_ENTRY   *Link;
+  SMI_HANDLER  *SmiHandler;
+
+  Link = Head->ForwardLink;
+  while (Link != Head) {
+    SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+    Link = Link->ForwardLink;
+    if (SmiHandler->ToRemove) {
+      RemoveSmiHandler (SmiHandler);
+    }
+  }
+}
+
 /**
   Manage SMI of a particular type.
 
@@ -112,10 +226,14 @@ SmiManage (
   SMI_ENTRY    *SmiEntry;
   SMI_HANDLER  *SmiHandler;
   BOOLEAN      SuccessReturn;
+  BOOLEAN      WillReturn;
   EFI_STATUS   Status;
-  
+  UINT64       StartTicks;
+
+  StartTicks = 0;
   Status = EFI_NOT_FOUND;
   SuccessReturn = FALSE;
+  WillReturn = FALSE;
   if (HandlerType == NULL) {
     //
     // Root SMI handler
@@ -135,8 +253,21 @@ SmiManage (
   }
   Head = &SmiEntry->SmiHandlers;
 
+  //
+  // Handlers unregistered from within a handler stay linked until the
+  // outermost SmiManage() returns, so that Link and SmiHandler stay valid.
+  //
+  mSmiManageCallingDepth++;
+
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+    if (SmiHandler->ToRemove) {
+      continue;
+    }
+
+    if (mSmiHandlerLatencyEnabled) {
+      StartTicks = GetPerformanceCounter ();
+    }
 
     Status = SmiHandler->Handler (
                (EFI_HANDLE) SmiHandler,
@@ -145,6 +276,10 @@ SmiManage (
                CommBufferSize
                );
 
+    if (mSmiHandlerLatencyEnabled) {
+      SmiHandlerProfileRecordLatency (SmiHandler, StartTicks);
+    }
+
     switch (Status) {
     case EFI_INTERRUPT_PENDING:
       //
@@ -152,7 +287,7 @@ SmiManage (
       // no additional handlers will be processed and EFI_INTERRUPT_PENDING will be returned.
       //
       if (HandlerType != NULL) {
-        return EFI_INTERRUPT_PENDING;
+        WillReturn = TRUE;
       }
       break;
 
@@ -163,7 +298,7 @@ SmiManage (
       // additional handlers will be processed.
       //
       if (HandlerType != NULL) {
-        return EFI_SUCCESS;
+        WillReturn = TRUE;
       }
       SuccessReturn = TRUE;
       break;
@@ -190,6 +325,30 @@ SmiManage (
       ASSERT (FALSE);
       break;
     }
+
+    if (WillReturn) {
+      break;
+    }
+  }
+
+  ASSERT (mSmiManageCallingDepth > 0);
+  mSmiManageCallingDepth--;
+
+  if (mSmiManageCallingDepth == 0) {
+    //
+    // Free the handlers unregistered during the dispatch
+    //
+    RemoveSmiHandlersToRemove (&mRootSmiEntry.SmiHandlers);
+    Link = mSmiEntryList.ForwardLink;
+    while (Link != &mSmiEntryList) {
+      SmiEntry = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+      Link = Link->ForwardLink;
+      RemoveSmiHandlersToRemove (&SmiEntry->SmiHandlers);
+    }
+  }
+
+  if (WillReturn) {
+    return Status;
   }
 
   if (SuccessReturn) {
@@ -275,7 +434,6 @@ SmiHandlerUnRegister (
   )
 {
   SMI_HANDLER  *SmiHandler;
-  SMI_ENTRY    *SmiEntry;
 
   SmiHandler = (SMI_HANDLER *) DispatchHandle;
 
@@ -283,30 +441,20 @@ SmiHandlerUnRegister (
     return EFI_INVALID_PARAMETER;
   }
 
-  if (SmiHandler->Signature != SMI_HANDLER_SIGNATURE) {
+  if (SmiHandler->Signature != SMI_HANDLER_SIGNATURE || SmiHandler->ToRemove) {
     return EFI_INVALID_PARAMETER;
   }
 
-  SmiEntry = SmiHandler->SmiEntry;
-
-  RemoveEntryList (&SmiHandler->Link);
-  FreePool (SmiHandler);
-
-  if (SmiEntry == NULL) {
+  if (mSmiManageCallingDepth > 0) {
     //
-    // This is root SMI handler
+    // SMIs are being dispatched and the handler may be the one running, so
+    // defer freeing it until SmiManage() is done with it.
     //
+    SmiHandler->ToRemove = TRUE;
     return EFI_SUCCESS;
   }
 
-  if (IsListEmpty (&SmiEntry->SmiHandlers)) {
-    //
-    // No handler registered for this interrupt now, remove the SMI_ENTRY
-    //
-    RemoveEntryList (&SmiEntry->AllEntries);
-
-    FreePool (SmiEntry);
-  }
+  RemoveSmiHandler (SmiHandler);
 
   return EFI_SUCCESS;
 }
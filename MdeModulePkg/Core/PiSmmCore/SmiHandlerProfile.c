@@ -80,6 +80,7 @@ InternalPeCoffGetEntryPoint (
 extern LIST_ENTRY  mSmiEntryList;
 extern LIST_ENTRY  mHardwareSmiEntryList;
 extern SMI_ENTRY   mRootSmiEntry;
+extern BOOLEAN     mSmiHandlerLatencyEnabled;
 
 extern SMI_HANDLER_PROFILE_PROTOCOL  mSmiHandlerProfile;
 
@@ -105,6 +106,9 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmHardwareSmiDatabaseSize;
 
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileRecordingStatus;
 
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64   mSmiHandlerCounterStartValue;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64   mSmiHandlerCounterEndValue;
+
 GLOBAL_REMOVE_IF_UNREFERENCED SMI_HANDLER_PROFILE_PROTOCOL  mSmiHandlerProfile = {
   SmiHandlerProfileRegisterHandler,
   SmiHandlerProfileUnregisterHandler,
@@ -714,6 +718,10 @@ GetSmmSmiHandlerDataOnSmiEntry(
     SmiHandlerStruct->Handler = (UINTN)SmiHandler->Handler;
     SmiHandlerStruct->ImageRef = AddressToImageRef((UINTN)SmiHandler->Handler);
     SmiHandlerStruct->ContextBufferSize = (UINT32)SmiHandler->ContextSize;
+    SmiHandlerStruct->DispatchCount = SmiHandler->DispatchCount;
+    SmiHandlerStruct->TotalLatency = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+    SmiHandlerStruct->MaxLatency = GetTimeInNanoSecond (SmiHandler->MaxTicks);
+    SmiHandler->ProfileData = SmiHandlerStruct;
     if (SmiHandler->ContextSize != 0) {
       SmiHandlerStruct->ContextBufferOffset = sizeof(SMM_CORE_SMI_HANDLER_STRUCTURE);
       CopyMem ((UINT8 *)SmiHandlerStruct + SmiHandlerStruct->ContextBufferOffset, SmiHandler->Context, SmiHandler->ContextSize);
@@ -882,6 +890,42 @@ SmiHandlerProfileCopyData(
   *DataOffset = *DataOffset + *DataSize;
 }
 
+/**
+  Refresh the dispatch statistics of the SMI handlers in the database.
+
+  @param SmiEntryList a list of SMI entry.
+**/
+VOID
+UpdateSmmSmiHandlerLatency (
+  IN LIST_ENTRY      *SmiEntryList
+  )
+{
+  LIST_ENTRY      *ListEntry;
+  LIST_ENTRY      *HandlerEntry;
+  SMI_ENTRY       *SmiEntry;
+  SMI_HANDLER     *SmiHandler;
+
+  for (ListEntry = SmiEntryList->ForwardLink;
+       ListEntry != SmiEntryList;
+       ListEntry = ListEntry->ForwardLink) {
+    SmiEntry = CR(ListEntry, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+    for (HandlerEntry = SmiEntry->SmiHandlers.ForwardLink;
+         HandlerEntry != &SmiEntry->SmiHandlers;
+         HandlerEntry = HandlerEntry->ForwardLink) {
+      SmiHandler = CR(HandlerEntry, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+      //
+      // Handlers registered after the database was built are not in it
+      //
+      if (SmiHandler->ProfileData == NULL) {
+        continue;
+      }
+      SmiHandler->ProfileData->DispatchCount = SmiHandler->DispatchCount;
+      SmiHandler->ProfileData->TotalLatency = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+      SmiHandler->ProfileData->MaxLatency = GetTimeInNanoSecond (SmiHandler->MaxTicks);
+    }
+  }
+}
+
 /**
   SMI handler profile handler to get info.
 
@@ -898,6 +942,12 @@ SmiHandlerProfileHandlerGetInfo(
   SmiHandlerProfileRecordingStatus = mSmiHandlerProfileRecordingStatus;
   mSmiHandlerProfileRecordingStatus = FALSE;
 
+  //
+  // Take a snapshot of the dispatch statistics for the following data reads
+  //
+  UpdateSmmSmiHandlerLatency (mSmmCoreRootSmiEntryList);
+  UpdateSmmSmiHandlerLatency (mSmmCoreSmiEntryList);
+
   SmiHandlerProfileParameterGetInfo->DataSize = mSmiHandlerProfileDatabaseSize;
   SmiHandlerProfileParameterGetInfo->Header.ReturnStatus = 0;
 
@@ -1339,6 +1389,44 @@ SmiHandlerProfileUnregisterHandler (
   return EFI_SUCCESS;
 }
 
+/**
+  Record the time an SMI handler took to run.
+
+  @param SmiHandler  The SMI handler that was dispatched.
+  @param StartTicks  The performance counter value before it was dispatched.
+**/
+VOID
+SmiHandlerProfileRecordLatency (
+  IN SMI_HANDLER  *SmiHandler,
+  IN UINT64       StartTicks
+  )
+{
+  UINT64  EndTicks;
+  UINT64  Ticks;
+
+  EndTicks = GetPerformanceCounter ();
+
+  if (mSmiHandlerCounterEndValue >= mSmiHandlerCounterStartValue) {
+    if (EndTicks >= StartTicks) {
+      Ticks = EndTicks - StartTicks;
+    } else {
+      Ticks = (mSmiHandlerCounterEndValue - StartTicks) + (EndTicks - mSmiHandlerCounterStartValue);
+    }
+  } else {
+    if (StartTicks >= EndTicks) {
+      Ticks = StartTicks - EndTicks;
+    } else {
+      Ticks = (StartTicks - mSmiHandlerCounterEndValue) + (mSmiHandlerCounterStartValue - EndTicks);
+    }
+  }
+
+  SmiHandler->DispatchCount++;
+  SmiHandler->TotalTicks += Ticks;
+  if (Ticks > SmiHandler->MaxTicks) {
+    SmiHandler->MaxTicks = Ticks;
+  }
+}
+
 /**
   Initialize SmiHandler profile feature.
 **/
@@ -1354,6 +1442,9 @@ SmmCoreInitializeSmiHandlerProfile (
   if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x1) != 0) {
     InsertTailList (&mRootSmiEntryList, &mRootSmiEntry.AllEntries);
 
+    GetPerformanceCounterProperties (&mSmiHandlerCounterStartValue, &mSmiHandlerCounterEndValue);
+    mSmiHandlerLatencyEnabled = TRUE;
+
     Status = gSmst->SmmRegisterProtocolNotify (
                       &gEfiSmmReadyToLockProtocolGuid,
                       SmmReadyToLockInSmiHandlerProfile,
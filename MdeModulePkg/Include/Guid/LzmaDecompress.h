@@ -29,7 +29,31 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been split into chunks that
+/// were compressed independently using LZMA.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0x5E2D4B6F, 0x1C7A, 0x4E83, { 0x9F, 0x3B, 0x8A, 0x0D, 0x6C, 0x2E, 0x71, 0xB4 } }
+
+#define LZMA_CHUNKED_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'C', 'H')
+
+///
+/// Header of the data in a LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID section. It is
+/// followed by a UINT32 array holding the compressed size of each chunk, and
+/// then by the chunks themselves, each one a complete LZMA stream. Chunk N
+/// decompresses to offset N * ChunkSize of the output buffer.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT32    ChunkSize;
+  UINT32    ChunkCount;
+  UINT32    UncompressedSize;
+} LZMA_CHUNKED_HEADER;
+
 extern GUID gLzmaCustomDecompressGuid;
 extern GUID gLzmaF86CustomDecompressGuid;
+extern GUID gLzmaChunkedCustomDecompressGuid;
 
 #endif
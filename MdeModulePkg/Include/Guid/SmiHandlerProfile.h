@@ -48,7 +48,7 @@ typedef struct {
 } SMM_CORE_IMAGE_DATABASE_STRUCTURE;
 
 #define SMM_CORE_SMI_DATABASE_SIGNATURE SIGNATURE_32 ('S','C','S','D')
-#define SMM_CORE_SMI_DATABASE_REVISION  0x0001
+#define SMM_CORE_SMI_DATABASE_REVISION  0x0002
 
 typedef enum {
   SmmCoreSmiHandlerCategoryRootHandler,
@@ -91,6 +91,13 @@ typedef struct {
   UINT16                ContextBufferOffset;
   UINT8                 Reserved[2];
   UINT32                ContextBufferSize;
+  //
+  // Dispatch statistics since boot, only collected for the root and GUID SMI
+  // handlers dispatched by SmmCore. Latencies are in nanoseconds.
+  //
+  UINT64                DispatchCount;
+  UINT64                TotalLatency;
+  UINT64                MaxLatency;
 //UINT8                 ContextBuffer[];
 } SMM_CORE_SMI_HANDLER_STRUCTURE;
 
@@ -0,0 +1,85 @@
+/** @file
+  MP Task Protocol provides a parallel-for service that spreads many small
+  tasks over all the processors, for work such as hashing, decompression,
+  memory test and device scans.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __MP_TASK_H__
+#define __MP_TASK_H__
+
+//{2531C06A-C8C4-4D9C-843E-E4C0A8E37BA4}
+#define EDKII_MP_TASK_PROTOCOL_GUID \
+  { \
+    0x2531c06a, 0xc8c4, 0x4d9c, { 0x84, 0x3e, 0xe4, 0xc0, 0xa8, 0xe3, 0x7b, 0xa4 } \
+  }
+
+typedef struct _EDKII_MP_TASK_PROTOCOL EDKII_MP_TASK_PROTOCOL;
+
+/**
+  The task procedure run by EDKII_MP_TASK_PARALLEL_FOR for each index.
+
+  The procedure may be run on any processor, including APs, so it must
+  follow the same rules as EFI_AP_PROCEDURE: it must not call UEFI Boot
+  Services and must be safe to run concurrently with itself.
+
+  @param[in]  Context   The caller provided context.
+  @param[in]  Index     The index of the task, from 0 to Count - 1.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_MP_TASK_PROCEDURE)(
+  IN  VOID                                *Context,
+  IN  UINTN                               Index
+  );
+
+/**
+  Run Procedure once for each index from 0 to Count - 1, spread over all
+  the enabled processors, and return when all the indexes are done.
+
+  The calling processor takes part in running the tasks, so the service
+  returns as soon as the last task completes. If the APs are busy or not
+  present, all the tasks are run on the calling processor.
+
+  @param[in]  This        The EDKII_MP_TASK_PROTOCOL instance.
+  @param[in]  Procedure   The procedure to run for each index.
+  @param[in]  Count       The number of indexes.
+  @param[in]  Grain       The number of consecutive indexes run as one task,
+                          0 lets the service choose.
+  @param[in]  Context     The context passed to Procedure.
+
+  @retval EFI_SUCCESS           All the indexes have been run.
+  @retval EFI_INVALID_PARAMETER Procedure is NULL.
+  @retval EFI_DEVICE_ERROR      The caller is not the BSP.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_PARALLEL_FOR)(
+  IN  EDKII_MP_TASK_PROTOCOL              *This,
+  IN  EDKII_MP_TASK_PROCEDURE             Procedure,
+  IN  UINTN                               Count,
+  IN  UINTN                               Grain,
+  IN  VOID                                *Context OPTIONAL
+  );
+
+///
+/// MP Task Protocol provides a parallel-for service on all the processors.
+///
+struct _EDKII_MP_TASK_PROTOCOL {
+  EDKII_MP_TASK_PARALLEL_FOR              ParallelFor;
+};
+
+extern EFI_GUID gEdkiiMpTaskProtocolGuid;
+
+#endif
@@ -16,6 +16,24 @@
 
 #include "LzmaDecompressLibInternal.h"
 
+typedef
+RETURN_STATUS
+(EFIAPI *LZMA_DECOMPRESS_GET_INFO) (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+typedef
+RETURN_STATUS
+(EFIAPI *LZMA_DECOMPRESS) (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
 /**
   Examines a GUIDed section and returns the size of the decoded buffer and the
   size of an scratch buffer required to actually decode the data in a GUIDed section.
@@ -58,36 +76,43 @@ LzmaGuidedSectionGetInfo (
   OUT UINT16      *SectionAttribute
   )
 {
+  EFI_GUID                  *InputGuid;
+  LZMA_DECOMPRESS_GET_INFO  GetInfo;
+
   ASSERT (InputSection != NULL);
   ASSERT (OutputBufferSize != NULL);
   ASSERT (ScratchBufferSize != NULL);
   ASSERT (SectionAttribute != NULL);
 
   if (IS_SECTION2 (InputSection)) {
-    if (!CompareGuid (
-        &gLzmaCustomDecompressGuid,
-        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
+    InputGuid = &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid);
+    if (!CompareGuid (&gLzmaCustomDecompressGuid, InputGuid) &&
+        !CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid)) {
       return RETURN_INVALID_PARAMETER;
     }
 
     *SectionAttribute = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->Attributes;
 
-    return LzmaUefiDecompressGetInfo (
+    GetInfo = CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid) ?
+                LzmaChunkedDecompressGetInfo : LzmaUefiDecompressGetInfo;
+    return GetInfo (
              (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
              SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
              OutputBufferSize,
              ScratchBufferSize
              );
   } else {
-    if (!CompareGuid (
-        &gLzmaCustomDecompressGuid,
-        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
+    InputGuid = &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid);
+    if (!CompareGuid (&gLzmaCustomDecompressGuid, InputGuid) &&
+        !CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid)) {
       return RETURN_INVALID_PARAMETER;
     }
 
     *SectionAttribute = ((EFI_GUID_DEFINED_SECTION *) InputSection)->Attributes;
 
-    return LzmaUefiDecompressGetInfo (
+    GetInfo = CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid) ?
+                LzmaChunkedDecompressGetInfo : LzmaUefiDecompressGetInfo;
+    return GetInfo (
              (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
              SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
              OutputBufferSize,
@@ -138,13 +163,16 @@ LzmaGuidedSectionExtraction (
   OUT       UINT32  *AuthenticationStatus
   )
 {
+  EFI_GUID         *InputGuid;
+  LZMA_DECOMPRESS  Decompress;
+
   ASSERT (OutputBuffer != NULL);
   ASSERT (InputSection != NULL);
 
   if (IS_SECTION2 (InputSection)) {
-    if (!CompareGuid (
-        &gLzmaCustomDecompressGuid,
-        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
+    InputGuid = &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid);
+    if (!CompareGuid (&gLzmaCustomDecompressGuid, InputGuid) &&
+        !CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid)) {
       return RETURN_INVALID_PARAMETER;
     }
 
@@ -153,16 +181,18 @@ LzmaGuidedSectionExtraction (
     //
     *AuthenticationStatus = 0;
 
-    return LzmaUefiDecompress (
+    Decompress = CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid) ?
+                   LzmaChunkedDecompress : LzmaUefiDecompress;
+    return Decompress (
              (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
              SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
              *OutputBuffer,
              ScratchBuffer
              );
   } else {
-    if (!CompareGuid (
-        &gLzmaCustomDecompressGuid,
-        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
+    InputGuid = &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid);
+    if (!CompareGuid (&gLzmaCustomDecompressGuid, InputGuid) &&
+        !CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid)) {
       return RETURN_INVALID_PARAMETER;
     }
 
@@ -171,7 +201,9 @@ LzmaGuidedSectionExtraction (
     //
     *AuthenticationStatus = 0;
 
-    return LzmaUefiDecompress (
+    Decompress = CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid) ?
+                   LzmaChunkedDecompress : LzmaUefiDecompress;
+    return Decompress (
              (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
              SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
              *OutputBuffer,
@@ -182,7 +214,8 @@ LzmaGuidedSectionExtraction (
 
 
 /**
-  Register LzmaDecompress and LzmaDecompressGetInfo handlers with LzmaCustomerDecompressGuid.
+  Register LzmaDecompress and LzmaDecompressGetInfo handlers with LzmaCustomerDecompressGuid
+  and LzmaChunkedCustomDecompressGuid.
 
   @retval  RETURN_SUCCESS            Register successfully.
   @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
@@ -193,10 +226,21 @@ LzmaDecompressLibConstructor (
   VOID
   )
 {
+  RETURN_STATUS  Status;
+
+  Status = ExtractGuidedSectionRegisterHandlers (
+             &gLzmaCustomDecompressGuid,
+             LzmaGuidedSectionGetInfo,
+             LzmaGuidedSectionExtraction
+             );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
   return ExtractGuidedSectionRegisterHandlers (
-          &gLzmaCustomDecompressGuid,
-          LzmaGuidedSectionGetInfo,
-          LzmaGuidedSectionExtraction
-          );      
+           &gLzmaChunkedCustomDecompressGuid,
+           LzmaGuidedSectionGetInfo,
+           LzmaGuidedSectionExtraction
+           );
 }
 
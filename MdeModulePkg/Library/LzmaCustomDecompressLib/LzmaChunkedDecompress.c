@@ -0,0 +1,236 @@
+/** @file
+  Chunked LZMA Decompress interfaces
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+#include "Sdk/C/7zTypes.h"
+#include "Sdk/C/LzmaDec.h"
+
+#define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
+
+/**
+  Returns the compressed size table that follows the chunked stream header.
+
+  @param  Source      The source buffer containing the compressed data.
+
+  @return The array of compressed chunk sizes.
+
+**/
+CONST UINT32 *
+LzmaChunkedGetSizeTable (
+  IN CONST VOID  *Source
+  )
+{
+  return (CONST UINT32 *) ((CONST UINT8 *) Source + sizeof (LZMA_CHUNKED_HEADER));
+}
+
+/**
+  Given a chunked Lzma compressed source buffer, this function retrieves the
+  size of the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The chunk size table is checked against SourceSize, so that the chunks can be
+  located safely by LzmaChunkedDecompressChunk().
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress one chunk.
+
+  @retval  RETURN_SUCCESS            The sizes were returned.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is not a valid chunked stream.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  CONST UINT32               *SizeTable;
+  UINT32                     Index;
+  UINT64                     Remaining;
+  UINT32                     DecodedSize;
+
+  if (SourceSize < sizeof (LZMA_CHUNKED_HEADER)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Header = (CONST LZMA_CHUNKED_HEADER *) Source;
+  if (Header->Signature != LZMA_CHUNKED_SIGNATURE ||
+      Header->ChunkSize == 0 ||
+      Header->ChunkCount == 0 ||
+      Header->ChunkCount != DivU64x32 (
+                              (UINT64) Header->UncompressedSize + Header->ChunkSize - 1,
+                              Header->ChunkSize
+                              ) ||
+      (SourceSize - sizeof (LZMA_CHUNKED_HEADER)) / sizeof (UINT32) < Header->ChunkCount) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Every chunk must fit in the source buffer and carry a full LZMA header.
+  //
+  SizeTable = LzmaChunkedGetSizeTable (Source);
+  Remaining = SourceSize - sizeof (LZMA_CHUNKED_HEADER) - Header->ChunkCount * sizeof (UINT32);
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    if (SizeTable[Index] > Remaining ||
+        SizeTable[Index] < LZMA_HEADER_SIZE) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    Remaining -= SizeTable[Index];
+  }
+
+  *DestinationSize = Header->UncompressedSize;
+
+  //
+  // Each chunk is a complete LZMA stream, so the per-chunk scratch size is
+  // the one of a plain LZMA stream.
+  //
+  return LzmaUefiDecompressGetInfo (
+           (CONST UINT8 *) SizeTable + Header->ChunkCount * sizeof (UINT32),
+           SizeTable[0],
+           &DecodedSize,
+           ScratchSize
+           );
+}
+
+/**
+  Decompresses one chunk of a chunked Lzma compressed source buffer.
+
+  The source buffer must have been validated by LzmaChunkedDecompressGetInfo().
+  This function does not use any global state, so different chunks may be
+  decompressed at the same time on different processors as long as each one
+  uses its own scratch buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  ChunkIndex  The index of the chunk to decompress.
+  @param  Destination The destination buffer of the whole decompressed data.
+  @param  Scratch     A scratch buffer of the size returned by LzmaChunkedDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            The chunk was decompressed.
+  @retval  RETURN_INVALID_PARAMETER  The chunk is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedDecompressChunk (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN UINT32      ChunkIndex,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  CONST UINT32               *SizeTable;
+  CONST UINT8                *Chunk;
+  UINT32                     Index;
+  UINT32                     ChunkOffset;
+  UINT32                     ExpectedSize;
+  UINT32                     DecodedSize;
+  UINT32                     ScratchSize;
+  RETURN_STATUS              Status;
+
+  Header    = (CONST LZMA_CHUNKED_HEADER *) Source;
+  SizeTable = LzmaChunkedGetSizeTable (Source);
+  ASSERT (ChunkIndex < Header->ChunkCount);
+
+  Chunk = (CONST UINT8 *) SizeTable + Header->ChunkCount * sizeof (UINT32);
+  for (Index = 0; Index < ChunkIndex; Index++) {
+    Chunk += SizeTable[Index];
+  }
+
+  //
+  // The chunk must decode to exactly its share of the output buffer, so that
+  // a corrupted chunk can not write into the area of another one. The full
+  // 64-bit size of the LZMA header is checked, because LzmaUefiDecompress()
+  // decodes to that size and DecodedSize is truncated to 32 bits.
+  //
+  ChunkOffset  = ChunkIndex * Header->ChunkSize;
+  ExpectedSize = MIN (Header->ChunkSize, Header->UncompressedSize - ChunkOffset);
+  Status = LzmaUefiDecompressGetInfo (Chunk, SizeTable[ChunkIndex], &DecodedSize, &ScratchSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+  if (GetDecodedSizeOfBuf ((UINT8 *) Chunk) != ExpectedSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return LzmaUefiDecompress (
+           Chunk,
+           SizeTable[ChunkIndex],
+           (UINT8 *) Destination + ChunkOffset,
+           Scratch
+           );
+}
+
+/**
+  Decompresses a chunked Lzma compressed source buffer.
+
+  The chunks are handed to LzmaChunkedDecompressParallel() first. If that is
+  not possible, they are decompressed one after the other on the calling
+  processor.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A scratch buffer of the size returned by LzmaChunkedDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS              Status;
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  UINT32                     Index;
+  UINT32                     DestinationSize;
+  UINT32                     ScratchSize;
+
+  Status = LzmaChunkedDecompressGetInfo (Source, (UINT32) SourceSize, &DestinationSize, &ScratchSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Header = (CONST LZMA_CHUNKED_HEADER *) Source;
+  if (Header->ChunkCount > 1) {
+    Status = LzmaChunkedDecompressParallel (Source, SourceSize, Destination);
+    if (!RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Status = LzmaChunkedDecompressChunk (Source, SourceSize, Index, Destination, Scratch);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
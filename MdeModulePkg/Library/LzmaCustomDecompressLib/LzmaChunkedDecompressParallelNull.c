@@ -0,0 +1,37 @@
+/** @file
+  Chunked LZMA decompression on the application processors, Null implementation
+  for the phases that have no MP services.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+/**
+  Decompresses all chunks of a chunked Lzma compressed source buffer on the
+  application processors.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+
+  @retval  RETURN_UNSUPPORTED  Always, the caller decompresses the chunks itself.
+
+**/
+RETURN_STATUS
+LzmaChunkedDecompressParallel (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination
+  )
+{
+  return RETURN_UNSUPPORTED;
+}
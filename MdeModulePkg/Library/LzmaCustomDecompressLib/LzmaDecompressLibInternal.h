@@ -22,6 +22,18 @@
 #include <Library/ExtractGuidedSectionLib.h>
 #include <Guid/LzmaDecompress.h>
 
+/**
+  Get the size of the uncompressed buffer by parsing EncodeData header.
+
+  @param EncodedData  Pointer to the compressed data.
+
+  @return The size of the uncompressed buffer.
+**/
+UINT64
+GetDecodedSizeOfBuf(
+  UINT8 *EncodedData
+  );
+
 /**
   Given a Lzma compressed source buffer, this function retrieves the size of 
   the uncompressed buffer and the size of the scratch buffer required 
@@ -92,5 +104,107 @@ LzmaUefiDecompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Given a chunked Lzma compressed source buffer, this function retrieves the
+  size of the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The chunk size table is checked against SourceSize, so that the chunks can be
+  located safely by LzmaChunkedDecompressChunk().
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress one chunk.
+
+  @retval  RETURN_SUCCESS            The sizes were returned.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is not a valid chunked stream.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses one chunk of a chunked Lzma compressed source buffer.
+
+  The source buffer must have been validated by LzmaChunkedDecompressGetInfo().
+  This function does not use any global state, so different chunks may be
+  decompressed at the same time on different processors as long as each one
+  uses its own scratch buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  ChunkIndex  The index of the chunk to decompress.
+  @param  Destination The destination buffer of the whole decompressed data.
+  @param  Scratch     A scratch buffer of the size returned by LzmaChunkedDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            The chunk was decompressed.
+  @retval  RETURN_INVALID_PARAMETER  The chunk is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedDecompressChunk (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN UINT32      ChunkIndex,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+/**
+  Decompresses a chunked Lzma compressed source buffer.
+
+  The chunks are handed to LzmaChunkedDecompressParallel() first. If that is
+  not possible, they are decompressed one after the other on the calling
+  processor.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A scratch buffer of the size returned by LzmaChunkedDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+/**
+  Decompresses all chunks of a chunked Lzma compressed source buffer on the
+  application processors.
+
+  @param  Source      The source buffer containing the compressed data. It must
+                      have been validated by LzmaChunkedDecompressGetInfo().
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+
+  @retval  RETURN_SUCCESS      All chunks were decompressed.
+  @retval  RETURN_UNSUPPORTED  The chunks could not all be decompressed on the
+                               application processors, so the caller has to
+                               decompress them itself.
+
+**/
+RETURN_STATUS
+LzmaChunkedDecompressParallel (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination
+  );
+
 #endif
 
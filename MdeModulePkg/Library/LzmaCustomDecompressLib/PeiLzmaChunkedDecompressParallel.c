@@ -0,0 +1,166 @@
+/** @file
+  Chunked LZMA decompression on the application processors through the PEI MP
+  Services PPI.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+#include <Ppi/MpServices.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+#include <Library/SynchronizationLib.h>
+
+typedef struct {
+  CONST VOID        *Source;
+  UINTN             SourceSize;
+  VOID              *Destination;
+  UINT32            ChunkCount;
+  UINT8             *Scratch;
+  UINT32            ScratchSize;
+  UINT32            ScratchCount;
+  volatile UINT32   NextChunk;
+  volatile UINT32   NextScratch;
+  volatile UINT32   FailedChunks;
+} LZMA_CHUNKED_JOB;
+
+/**
+  AP procedure that decompresses chunks until there are none left.
+
+  Each AP takes its own scratch buffer and then picks the next chunk that
+  nobody has taken yet, so the work balances itself across the APs.
+
+  @param[in, out] Buffer  Pointer to the LZMA_CHUNKED_JOB.
+
+**/
+VOID
+EFIAPI
+LzmaChunkedDecompressAp (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_CHUNKED_JOB  *Job;
+  UINT32            Slot;
+  UINT32            Index;
+  RETURN_STATUS     Status;
+
+  Job  = (LZMA_CHUNKED_JOB *) Buffer;
+  Slot = InterlockedIncrement (&Job->NextScratch) - 1;
+  if (Slot >= Job->ScratchCount) {
+    return;
+  }
+
+  while (TRUE) {
+    Index = InterlockedIncrement (&Job->NextChunk) - 1;
+    if (Index >= Job->ChunkCount) {
+      break;
+    }
+
+    Status = LzmaChunkedDecompressChunk (
+               Job->Source,
+               Job->SourceSize,
+               Index,
+               Job->Destination,
+               Job->Scratch + Slot * Job->ScratchSize
+               );
+    if (RETURN_ERROR (Status)) {
+      InterlockedIncrement (&Job->FailedChunks);
+    }
+  }
+}
+
+/**
+  Decompresses all chunks of a chunked Lzma compressed source buffer on the
+  application processors.
+
+  @param  Source      The source buffer containing the compressed data. It must
+                      have been validated by LzmaChunkedDecompressGetInfo().
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+
+  @retval  RETURN_SUCCESS      All chunks were decompressed.
+  @retval  RETURN_UNSUPPORTED  The chunks could not all be decompressed on the
+                               application processors, so the caller has to
+                               decompress them itself.
+
+**/
+RETURN_STATUS
+LzmaChunkedDecompressParallel (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination
+  )
+{
+  EFI_STATUS               Status;
+  CONST EFI_PEI_SERVICES   **PeiServices;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  UINTN                    NumberOfProcessors;
+  UINTN                    NumberOfEnabledProcessors;
+  UINT32                   DestinationSize;
+  UINT32                   ScratchSize;
+  UINTN                    ScratchPages;
+  LZMA_CHUNKED_JOB         Job;
+
+  Status = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **) &MpServices);
+  if (EFI_ERROR (Status)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  PeiServices = GetPeiServicesTablePointer ();
+  Status = MpServices->GetNumberOfProcessors (
+                         PeiServices,
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || NumberOfEnabledProcessors < 2) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  LzmaChunkedDecompressGetInfo (Source, (UINT32) SourceSize, &DestinationSize, &ScratchSize);
+
+  ZeroMem (&Job, sizeof (Job));
+  Job.Source       = Source;
+  Job.SourceSize   = SourceSize;
+  Job.Destination  = Destination;
+  Job.ChunkCount   = ((CONST LZMA_CHUNKED_HEADER *) Source)->ChunkCount;
+  Job.ScratchSize  = ScratchSize;
+  Job.ScratchCount = (UINT32) MIN (NumberOfEnabledProcessors - 1, Job.ChunkCount);
+
+  ScratchPages = EFI_SIZE_TO_PAGES ((UINTN) Job.ScratchSize * Job.ScratchCount);
+  Job.Scratch  = AllocatePages (ScratchPages);
+  if (Job.Scratch == NULL) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Status = MpServices->StartupAllAPs (
+                         PeiServices,
+                         MpServices,
+                         LzmaChunkedDecompressAp,
+                         FALSE,
+                         0,
+                         &Job
+                         );
+
+  FreePages (Job.Scratch, ScratchPages);
+
+  //
+  // Let the caller redo the work if an AP could not run or a chunk failed.
+  // The serial path then reports which chunk is corrupted.
+  //
+  if (EFI_ERROR (Status) || Job.NextChunk < Job.ChunkCount || Job.FailedChunks != 0) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
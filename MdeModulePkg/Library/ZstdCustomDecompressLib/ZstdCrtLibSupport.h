@@ -0,0 +1,60 @@
+/** @file
+  Include file to support building the Zstandard decompressor.
+
+  Maps the few C runtime definitions that the Zstandard sources use onto
+  the edk2 base types and libraries.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __ZSTD_CRT_LIB_SUPPORT_H__
+#define __ZSTD_CRT_LIB_SUPPORT_H__
+
+#include <Base.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+//
+// Basic types mapping
+//
+typedef UINTN   size_t;
+typedef INTN    ptrdiff_t;
+typedef INTN    intptr_t;
+typedef UINTN   uintptr_t;
+typedef INT8    int8_t;
+typedef UINT8   uint8_t;
+typedef INT16   int16_t;
+typedef UINT16  uint16_t;
+typedef INT32   int32_t;
+typedef UINT32  uint32_t;
+typedef INT64   int64_t;
+typedef UINT64  uint64_t;
+
+//
+// Definitions for global constants used by the Zstandard sources
+//
+#define CHAR_BIT     8                         /* Number of bits in a char */
+#define INT_MAX      0x7FFFFFFF                /* Maximum (signed) int value */
+#define INT_MIN      (-INT_MAX-1)              /* Minimum (signed) int value */
+#define UINT_MAX     0xFFFFFFFF                /* Maximum unsigned int value */
+#define ULLONG_MAX   0xFFFFFFFFFFFFFFFFULL     /* Maximum unsigned long long value */
+#define SIZE_MAX     MAX_UINTN                 /* Maximum size_t value */
+
+//
+// Macros that directly map functions to BaseMemoryLib functions
+//
+#define memcpy(dest,source,count)   CopyMem(dest,source,(UINTN)(count))
+#define memmove(dest,source,count)  CopyMem(dest,source,(UINTN)(count))
+#define memset(dest,ch,count)       SetMem(dest,(UINTN)(count),(UINT8)(ch))
+#define memcmp(buf1,buf2,count)     (int)(CompareMem(buf1,buf2,(UINTN)(count)))
+#define offsetof(type,member)       OFFSET_OF(type,member)
+
+#endif
@@ -0,0 +1,123 @@
+/** @file
+  Zstandard UEFI Decompress interfaces
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "ZstdDecompressLibInternal.h"
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd.h"
+
+/**
+  Given a Zstandard compressed source buffer, this function retrieves the size of
+  the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The frame must record its content size, which ZstdCompress always does.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval  RETURN_SUCCESS            The size of the uncompressed data was returned
+                                     in DestinationSize and the size of the scratch
+                                     buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER  Source is not a Zstandard frame with a known
+                                     content size.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  UINT64  ContentSize;
+
+  ContentSize = ZSTD_getFrameContentSize (Source, SourceSize);
+  if (ContentSize == ZSTD_CONTENTSIZE_ERROR ||
+      ContentSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+      ContentSize > MAX_UINT32) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *DestinationSize = (UINT32) ContentSize;
+  *ScratchSize     = (UINT32) ZSTD_estimateDCtxSize () + ZSTD_SCRATCH_ALIGNMENT;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a Zstandard compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  The decompression context lives in the scratch buffer, so no memory is
+  allocated during the decompression.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
+                      This is an optional parameter that may be NULL if the
+                      required scratch buffer size is 0.
+
+  @retval  RETURN_SUCCESS            Decompression completed successfully, and
+                                     the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer specified by Source is corrupted
+                                     (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  UINT64     ContentSize;
+  ZSTD_DCtx  *DCtx;
+  size_t     Result;
+
+  ContentSize = ZSTD_getFrameContentSize (Source, SourceSize);
+  if (ContentSize == ZSTD_CONTENTSIZE_ERROR ||
+      ContentSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+      ContentSize > MAX_UINT32) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  DCtx = ZSTD_initStaticDCtx (
+           ALIGN_POINTER (Scratch, ZSTD_SCRATCH_ALIGNMENT),
+           ZSTD_estimateDCtxSize ()
+           );
+  if (DCtx == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The whole frame is decoded in one call straight into Destination, so
+  // no window buffer is needed whatever window size the frame was made with.
+  //
+  Result = ZSTD_decompressDCtx (DCtx, Destination, (size_t) ContentSize, Source, SourceSize);
+  if (ZSTD_isError (Result) || Result != ContentSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -0,0 +1,91 @@
+/** @file
+  ZSTD UEFI header file
+
+  Allows Zstandard code to build under UEFI (edk2) build environment
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_INTERNAL_H__
+#define __ZSTD_DECOMPRESS_INTERNAL_H__
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+
+//
+// ZSTD_initStaticDCtx() needs an 8-byte aligned workspace.
+//
+#define ZSTD_SCRATCH_ALIGNMENT  8
+
+/**
+  Given a Zstandard compressed source buffer, this function retrieves the size of
+  the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The frame must record its content size, which ZstdCompress always does.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval  RETURN_SUCCESS            The size of the uncompressed data was returned
+                                     in DestinationSize and the size of the scratch
+                                     buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER  Source is not a Zstandard frame with a known
+                                     content size.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses a Zstandard compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  The decompression context lives in the scratch buffer, so no memory is
+  allocated during the decompression.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
+                      This is an optional parameter that may be NULL if the
+                      required scratch buffer size is 0.
+
+  @retval  RETURN_SUCCESS            Decompression completed successfully, and
+                                     the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer specified by Source is corrupted
+                                     (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+#endif
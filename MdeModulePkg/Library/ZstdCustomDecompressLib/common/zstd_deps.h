@@ -0,0 +1,78 @@
+/** @file
+  C runtime dependencies of the Zstandard sources for the edk2 build.
+
+  This file replaces lib/common/zstd_deps.h of the Zstandard distribution,
+  which is meant to be replaced to build the library without a C runtime.
+  The decompressor works on a context in the caller's scratch buffer, so the
+  allocation functions always fail.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef ZSTD_DEPS_COMMON
+#define ZSTD_DEPS_COMMON
+
+#include <ZstdCrtLibSupport.h>
+
+//
+// The Zstandard sources define their own versions of these Base.h macros.
+//
+#undef RETURN_ERROR
+#undef BIT0
+#undef BIT1
+#undef BIT4
+#undef BIT5
+#undef BIT6
+#undef BIT7
+
+#define ZSTD_memcpy(d,s,l)   CopyMem((d),(s),(UINTN)(l))
+#define ZSTD_memmove(d,s,l)  CopyMem((d),(s),(UINTN)(l))
+#define ZSTD_memset(p,v,l)   SetMem((p),(UINTN)(l),(UINT8)(v))
+
+#endif /* ZSTD_DEPS_COMMON */
+
+#ifdef ZSTD_DEPS_NEED_MALLOC
+#ifndef ZSTD_DEPS_MALLOC
+#define ZSTD_DEPS_MALLOC
+
+#define ZSTD_malloc(s)    ((VOID)(s), NULL)
+#define ZSTD_calloc(n,s)  ((VOID)(n), (VOID)(s), NULL)
+#define ZSTD_free(p)      ((VOID)(p))
+
+#endif /* ZSTD_DEPS_MALLOC */
+#endif /* ZSTD_DEPS_NEED_MALLOC */
+
+#ifdef ZSTD_DEPS_NEED_MATH64
+#ifndef ZSTD_DEPS_MATH64
+#define ZSTD_DEPS_MATH64
+
+#define ZSTD_div64(dividend, divisor)  DivU64x32 ((dividend), (divisor))
+
+#endif /* ZSTD_DEPS_MATH64 */
+#endif /* ZSTD_DEPS_NEED_MATH64 */
+
+#ifdef ZSTD_DEPS_NEED_ASSERT
+#ifndef ZSTD_DEPS_ASSERT
+#define ZSTD_DEPS_ASSERT
+
+#define assert(condition)  ASSERT (condition)
+
+#endif /* ZSTD_DEPS_ASSERT */
+#endif /* ZSTD_DEPS_NEED_ASSERT */
+
+#ifdef ZSTD_DEPS_NEED_IO
+#ifndef ZSTD_DEPS_IO
+#define ZSTD_DEPS_IO
+
+#define ZSTD_DEBUG_PRINT(...)  DEBUG ((DEBUG_INFO, __VA_ARGS__))
+
+#endif /* ZSTD_DEPS_IO */
+#endif /* ZSTD_DEPS_NEED_IO */
@@ -202,13 +202,9 @@ DirectRangeTest (
 
   //
   // Perform a dummy memory test, so directly write the pattern to all range
+  // and verify it
   //
-  WriteMemory (Private, StartAddress, Length);
-
-  //
-  // Verify the memory range
-  //
-  Status = VerifyMemory (Private, StartAddress, Length);
+  Status = TestMemoryRange (Private, StartAddress, Length);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -358,10 +354,8 @@ VerifyMemory (
 {
   EFI_PHYSICAL_ADDRESS            Address;
   INTN                            ErrorFound;
-  EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
 
   Address           = Start;
-  ExtendedErrorData = NULL;
 
   //
   // Add 4G memory address check for IA32 platform
@@ -383,39 +377,182 @@ VerifyMemory (
                   Private->MonoTestSize
                   );
     if (ErrorFound != 0) {
-      //
-      // Report uncorrectable errors
-      //
-      ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
-      if (ExtendedErrorData == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
+      return ReportMemoryTestError (Address);
+    }
 
-      ExtendedErrorData->DataHeader.HeaderSize  = (UINT16) sizeof (EFI_STATUS_CODE_DATA);
-      ExtendedErrorData->DataHeader.Size        = (UINT16) (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
-      ExtendedErrorData->Granularity            = EFI_MEMORY_ERROR_DEVICE;
-      ExtendedErrorData->Operation              = EFI_MEMORY_OPERATION_READ;
-      ExtendedErrorData->Syndrome               = 0x0;
-      ExtendedErrorData->Address                = Address;
-      ExtendedErrorData->Resolution             = 0x40;
+    Address += Private->CoverageSpan;
+  }
 
-      REPORT_STATUS_CODE_EX (
-          EFI_ERROR_CODE,
-          EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
-          0,
-          &gEfiGenericMemTestProtocolGuid,
-          NULL,
-          (UINT8 *) ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
-          ExtendedErrorData->DataHeader.Size
-          ); 
+  return EFI_SUCCESS;
+}
+
+/**
+  Report an uncorrectable memory error found by the memory test.
+
+  @param[in] Address  The address of the mis-compare.
+
+  @retval EFI_DEVICE_ERROR      The error has been reported.
+  @retval EFI_OUT_OF_RESOURCES  No memory to build the status code data.
+
+**/
+EFI_STATUS
+ReportMemoryTestError (
+  IN  EFI_PHYSICAL_ADDRESS         Address
+  )
+{
+  EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
+
+  //
+  // Report uncorrectable errors
+  //
+  ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
+  if (ExtendedErrorData == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ExtendedErrorData->DataHeader.HeaderSize  = (UINT16) sizeof (EFI_STATUS_CODE_DATA);
+  ExtendedErrorData->DataHeader.Size        = (UINT16) (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+  ExtendedErrorData->Granularity            = EFI_MEMORY_ERROR_DEVICE;
+  ExtendedErrorData->Operation              = EFI_MEMORY_OPERATION_READ;
+  ExtendedErrorData->Syndrome               = 0x0;
+  ExtendedErrorData->Address                = Address;
+  ExtendedErrorData->Resolution             = 0x40;
+
+  REPORT_STATUS_CODE_EX (
+      EFI_ERROR_CODE,
+      EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+      0,
+      &gEfiGenericMemTestProtocolGuid,
+      NULL,
+      (UINT8 *) ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
+      ExtendedErrorData->DataHeader.Size
+      );
+
+  FreePool (ExtendedErrorData);
+  return EFI_DEVICE_ERROR;
+}
+
+/**
+  Write and verify the memory test pattern in one chunk of a memory range.
+
+  This function is run through EDKII_MP_TASK_PROTOCOL on any processor, so
+  it must not use boot services. Every pattern line is flushed from the cache
+  as soon as it is written, the same as a non-temporal store, so that it is
+  read back from memory by the verify and does not pollute the cache. The
+  first mis-compare is recorded in the context and reported by the BSP.
+
+  @param[in] Context  Point to the MEMORY_TEST_CHUNK_CONTEXT of the range.
+  @param[in] Index    The index of the chunk in the range.
+
+**/
+VOID
+EFIAPI
+TestMemoryChunk (
+  IN  VOID                         *Context,
+  IN  UINTN                        Index
+  )
+{
+  MEMORY_TEST_CHUNK_CONTEXT    *Chunk;
+  GENERIC_MEMORY_TEST_PRIVATE  *Private;
+  EFI_PHYSICAL_ADDRESS         Start;
+  EFI_PHYSICAL_ADDRESS         End;
+  EFI_PHYSICAL_ADDRESS         Address;
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  UINTN                        Offset;
+#endif
+
+  Chunk   = (MEMORY_TEST_CHUNK_CONTEXT *) Context;
+  Private = Chunk->Private;
+
+  //
+  // Another chunk already failed, the whole range will be reported bad
+  //
+  if (Chunk->ErrorAddress != MAX_UINT64) {
+    return;
+  }
 
-      return EFI_DEVICE_ERROR;
+  Start = Chunk->Start + MultU64x64 (Chunk->ChunkSize, Index);
+  End   = Chunk->Start + Chunk->Size;
+  if (End - Start > Chunk->ChunkSize) {
+    End = Start + Chunk->ChunkSize;
+  }
+
+  for (Address = Start; Address < End; Address += Private->CoverageSpan) {
+    CopyMem ((VOID *) (UINTN) Address, Private->MonoPattern, Private->MonoTestSize);
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+    for (Offset = 0; Offset < Private->MonoTestSize; Offset += GENERIC_CACHELINE_SIZE) {
+      AsmFlushCacheLine ((VOID *) (UINTN) (Address + Offset));
     }
+#endif
+  }
 
-    Address += Private->CoverageSpan;
+  for (Address = Start; Address < End; Address += Private->CoverageSpan) {
+    if (CompareMemWithoutCheckArgument (
+          (VOID *) (UINTN) Address,
+          Private->MonoPattern,
+          Private->MonoTestSize
+          ) != 0) {
+      InterlockedCompareExchange64 ((UINT64 *) &Chunk->ErrorAddress, MAX_UINT64, Address);
+      return;
+    }
   }
+}
 
-  return EFI_SUCCESS;
+/**
+  Write and verify the memory test pattern in a range of physical memory,
+  splitting the range over all the processors when possible.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @retval EFI_SUCCESS Successful test the range of memory.
+  @retval Others      The range of memory have errors contained.
+
+**/
+EFI_STATUS
+TestMemoryRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_STATUS                 Status;
+  MEMORY_TEST_CHUNK_CONTEXT  Chunk;
+
+  //
+  // Add 4G memory address check for IA32 platform
+  // NOTE: Without page table, there is no way to use memory above 4G.
+  //
+  if (Start + Size > MAX_ADDRESS) {
+    return EFI_SUCCESS;
+  }
+
+  if (Private->MpTask != NULL && Size > MP_TEST_CHUNK_SIZE) {
+    Chunk.Private      = Private;
+    Chunk.Start        = Start;
+    Chunk.Size         = Size;
+    Chunk.ChunkSize    = MAX (MP_TEST_CHUNK_SIZE, Private->CoverageSpan);
+    Chunk.ErrorAddress = MAX_UINT64;
+
+    Status = Private->MpTask->ParallelFor (
+                                Private->MpTask,
+                                TestMemoryChunk,
+                                (UINTN) DivU64x64Remainder (Size + Chunk.ChunkSize - 1, Chunk.ChunkSize, NULL),
+                                1,
+                                &Chunk
+                                );
+    if (!EFI_ERROR (Status)) {
+      if (Chunk.ErrorAddress != MAX_UINT64) {
+        return ReportMemoryTestError (Chunk.ErrorAddress);
+      }
+      return EFI_SUCCESS;
+    }
+  }
+
+  WriteMemory (Private, Start, Size);
+
+  return VerifyMemory (Private, Start, Size);
 }
 
 /**
@@ -474,6 +611,23 @@ InitializeMemoryTest (
   if (!EFI_ERROR (Status)) {
     Private->Cpu = Cpu;
   }
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  //
+  // Split the memory test over all the processors if the MP task protocol
+  // is there, and test a larger block on every call since it goes faster.
+  // Only IA32 and X64 can flush one pattern line from the cache on an AP.
+  //
+  Status = gBS->LocateProtocol (
+                  &gEdkiiMpTaskProtocolGuid,
+                  NULL,
+                  (VOID **) &Private->MpTask
+                  );
+  if (!EFI_ERROR (Status)) {
+    Private->BdsBlockSize = MP_TEST_BLOCK_SIZE;
+  } else {
+    Private->MpTask = NULL;
+  }
+#endif
   //
   // Create the CoverageSpan of the memory test base on the coverage level
   //
@@ -590,9 +744,7 @@ GenPerformMemoryTest (
       // The software memory test (R/W/V) perform here. It will detect the
       // memory mis-compare error.
       //
-      WriteMemory (Private, mCurrentAddress, BlockBoundary);
-
-      Status = VerifyMemory (Private, mCurrentAddress, BlockBoundary);
+      Status = TestMemoryRange (Private, mCurrentAddress, BlockBoundary);
       if (EFI_ERROR (Status)) {
         //
         // If perform here, means there is mis-compare error, and no agent can
@@ -813,6 +965,7 @@ GENERIC_MEMORY_TEST_PRIVATE mGenericMemoryTestPrivate = {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE,
   NULL,
   NULL,
+  NULL,
   {
     InitializeMemoryTest,
     GenPerformMemoryTest,
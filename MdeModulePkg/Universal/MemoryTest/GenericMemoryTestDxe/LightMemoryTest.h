@@ -20,6 +20,7 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Protocol/GenericMemoryTest.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MpTask.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -29,6 +30,7 @@
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
 //
@@ -50,6 +52,13 @@
 #define QUICK_SPAN_SIZE   (TEST_BLOCK_SIZE >> 2)
 #define SPARSE_SPAN_SIZE  (TEST_BLOCK_SIZE >> 4)
 
+//
+// When the APs help, every BDS block is larger and split into chunks that
+// are tested in parallel. The chunk size must be a multiple of every span.
+//
+#define MP_TEST_BLOCK_SIZE  0x40000000
+#define MP_TEST_CHUNK_SIZE  (TEST_BLOCK_SIZE >> 1)
+
 //
 // This structure records every nontested memory range parsed through GCD
 // service.
@@ -89,6 +98,11 @@ typedef struct {
   //
   EFI_CPU_ARCH_PROTOCOL             *Cpu;
 
+  //
+  // MP task protocol's pointer, NULL if the test runs on the BSP only
+  //
+  EDKII_MP_TASK_PROTOCOL            *MpTask;
+
   //
   // generic memory test driver's protocol
   //
@@ -119,6 +133,20 @@ typedef struct {
 
 } GENERIC_MEMORY_TEST_PRIVATE;
 
+//
+// The context shared by the processors testing the chunks of one range
+//
+typedef struct {
+  GENERIC_MEMORY_TEST_PRIVATE       *Private;
+  EFI_PHYSICAL_ADDRESS              Start;
+  UINT64                            Size;
+  UINT64                            ChunkSize;
+  //
+  // The first mis-compare address found, MAX_UINT64 if none
+  //
+  volatile UINT64                   ErrorAddress;
+} MEMORY_TEST_CHUNK_CONTEXT;
+
 #define GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS(a) \
   CR ( \
   a, \
@@ -241,6 +269,53 @@ VerifyMemory (
   IN  UINT64                       Size
   );
 
+/**
+  Report an uncorrectable memory error found by the memory test.
+
+  @param[in] Address  The address of the mis-compare.
+
+  @retval EFI_DEVICE_ERROR      The error has been reported.
+  @retval EFI_OUT_OF_RESOURCES  No memory to build the status code data.
+
+**/
+EFI_STATUS
+ReportMemoryTestError (
+  IN  EFI_PHYSICAL_ADDRESS         Address
+  );
+
+/**
+  Write and verify the memory test pattern in one chunk of a memory range.
+
+  @param[in] Context  Point to the MEMORY_TEST_CHUNK_CONTEXT of the range.
+  @param[in] Index    The index of the chunk in the range.
+
+**/
+VOID
+EFIAPI
+TestMemoryChunk (
+  IN  VOID                         *Context,
+  IN  UINTN                        Index
+  );
+
+/**
+  Write and verify the memory test pattern in a range of physical memory,
+  splitting the range over all the processors when possible.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @retval EFI_SUCCESS Successful test the range of memory.
+  @retval Others      The range of memory have errors contained.
+
+**/
+EFI_STATUS
+TestMemoryRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  );
+
 /**
   Test a range of the memory directly .
 
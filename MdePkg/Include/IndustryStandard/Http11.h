@@ -176,6 +176,16 @@
 ///
 #define HTTP_HEADER_HOST              "Host"
 
+///
+/// Connection General Header
+///
+/// The Connection general-header field allows the sender to specify options that are
+/// desired for that particular connection. HTTP/1.1 applications that do not support
+/// persistent connections MUST include the "close" connection option in every message.
+///
+#define HTTP_HEADER_CONNECTION        "Connection"
+#define HTTP_CONNECTION_CLOSE         "close"
+
 ///
 /// Location Response Header
 /// 
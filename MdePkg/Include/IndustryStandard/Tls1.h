@@ -87,6 +87,13 @@ typedef struct {
   UINT16                  Length;
 } TLS_RECORD_HEADER;
 
+///
+/// TLS server_name extension type and its host_name name type, refers to
+/// section 3 of rfc-6066.
+///
+#define TLS_EXTENSION_SERVER_NAME       0
+#define TLS_SERVER_NAME_TYPE_HOST_NAME  0
+
 #pragma pack()
 
 #endif
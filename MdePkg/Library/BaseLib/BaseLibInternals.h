@@ -618,6 +618,34 @@ InternalAsciiHexCharToUintn (
 //
 #if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
 
+#if defined (MDE_CPU_X64)
+//
+// Buffers of at least this size are checksummed with PCLMULQDQ. Below it, the
+// cost of the CPUID check is not recovered.
+//
+#define CRC32_PCLMUL_THRESHOLD  SIZE_4KB
+
+/**
+  Folds a data buffer into a running CRC32 register with the carry-less
+  multiply instruction.
+
+  @param  Crc     The running CRC32 register.
+  @param  Buffer  A pointer to the data buffer.
+  @param  Length  The number of bytes in the buffer. It must be at least 64
+                  and a multiple of 16.
+
+  @return The updated CRC32 register.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Pclmul (
+  IN      UINT32                    Crc,
+  IN      CONST UINT8               *Buffer,
+  IN      UINTN                     Length
+  );
+#endif
+
 /**
   Reads the current Global Descriptor Table Register(GDTR) descriptor.
 
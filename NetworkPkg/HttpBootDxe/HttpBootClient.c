@@ -1151,7 +1151,29 @@ HttpBootGetBootFile (
     //
     ContentLength = 0;
     Status = HttpGetEntityLength (Parser, &ContentLength);
-    if (!EFI_ERROR (Status)) {
+    if (!EFI_ERROR (Status) && (Cache != NULL) &&
+        (*ImageType == ImageTypeVirtualCd || *ImageType == ImageTypeVirtualDisk)) {
+      //
+      // The RAM disk image size is already known from the response header, so don't
+      // save the message-body in the cache. The caller will allocate the RAM disk with
+      // this size and the image will be downloaded into the RAM disk directly, instead
+      // of keeping a second copy of the whole image in the cache.
+      //
+      *BufferSize = ContentLength;
+      HttpFreeMsgParser (Parser);
+      HttpBootFreeCache (Cache);
+      FreePool (ResponseData);
+      HttpBootFreeHeader (HttpIoHeader);
+      //
+      // The unread message-body is still pending in the HTTP child, destroy it so
+      // that a new connection will be created for the next request.
+      //
+      HttpIoDestroyIo (&Private->HttpIo);
+      Private->HttpCreated = FALSE;
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    if (!EFI_ERROR (Status) && (*BufferSize != 0)) {
       IdentityMode = TRUE;
     } else {
       IdentityMode = FALSE;
@@ -387,6 +387,17 @@ HttpBootLoadFile (
     goto ON_EXIT;
   }
 
+  if (!Private->HttpCreated) {
+    //
+    // The HTTP child is destroyed once the size of a RAM disk image is known
+    // from a GET request, create it again for the download.
+    //
+    Status = HttpBootCreateHttpIo (Private);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
   //
   // Load the boot file into Buffer
   //
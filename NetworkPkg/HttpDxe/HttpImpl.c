@@ -433,6 +433,20 @@ EfiHttpRequest (
       ReConfigure = FALSE;
     } else {
       if ((HttpInstance->RemotePort == RemotePort) &&
+          (AsciiStrCmp (HttpInstance->RemoteHost, HostName) == 0) &&
+          HttpInstance->ConnectionClose) {
+        //
+        // The server has announced it will close the persistent connection, reconnect
+        // to the same host. The resolved remote address is still valid, so no need to
+        // configure the host again.
+        //
+        // Requests still queued on the old connection will not be answered there.
+        // Complete them with EFI_CONNECTION_FIN before the reconnect cancels them,
+        // so that this request does not silently take their place.
+        //
+        NetMapIterate (&HttpInstance->TxTokens, HttpTcpAbortOnClose, NULL);
+        Configure   = FALSE;
+      } else if ((HttpInstance->RemotePort == RemotePort) &&
           (AsciiStrCmp (HttpInstance->RemoteHost, HostName) == 0) && 
           (!HttpInstance->UseHttps || (HttpInstance->UseHttps && 
                                        !TlsConfigure && 
@@ -558,6 +572,7 @@ EfiHttpRequest (
     
     HttpCloseConnection (HttpInstance);
     EfiHttpCancel (This, NULL);
+    HttpInstance->ConnectionClose = FALSE;
   }
 
   //
@@ -978,6 +993,7 @@ HttpResponseWorker (
   HTTP_TOKEN_WRAP               *ValueInItem;
   UINTN                         HdrLen;
   NET_FRAGMENT                  Fragment;
+  EFI_HTTP_HEADER               *ConnectionHeader;
 
   if (Wrap == NULL || Wrap->HttpInstance == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -1180,6 +1196,14 @@ HttpResponseWorker (
       FreePool (HttpHeaders);
       HttpHeaders = NULL;
 
+      //
+      // Check whether the server will close the connection after this response,
+      // otherwise keep the connection alive for the next request to the same host.
+      //
+      ConnectionHeader = HttpFindHeader (HttpMsg->HeaderCount, HttpMsg->Headers, HTTP_HEADER_CONNECTION);
+      if (ConnectionHeader != NULL && AsciiStriCmp (ConnectionHeader->FieldValue, HTTP_CONNECTION_CLOSE) == 0) {
+        HttpInstance->ConnectionClose = TRUE;
+      }
 
       //
       // Init message-body parser by header information.
@@ -1637,6 +1637,54 @@ HttpTcpNotReady (
   return EFI_SUCCESS;
 }
 
+/**
+  Complete the HTTP request associated with Tx4Token or Tx6Token with EFI_CONNECTION_FIN
+  and remove it from the map, because the server is closing the connection it was
+  queued on.
+
+  @param[in]  Map                The container of Tx4Token or Tx6Token.
+  @param[in]  Item               Current item to check against.
+  @param[in]  Context            The context, not used.
+
+  @retval EFI_SUCCESS            The HTTP request is removed.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpTcpAbortOnClose (
+  IN NET_MAP                *Map,
+  IN NET_MAP_ITEM           *Item,
+  IN VOID                   *Context
+  )
+{
+  HTTP_TOKEN_WRAP           *ValueInItem;
+
+  ValueInItem = (HTTP_TOKEN_WRAP *) Item->Value;
+
+  if (!ValueInItem->TcpWrap.IsTxDone) {
+    //
+    // The request is not sent out yet, so its token is still pending.
+    //
+    if (!ValueInItem->HttpInstance->LocalAddressIsIPv6) {
+      if (ValueInItem->TcpWrap.Tx4Token.CompletionToken.Event != NULL) {
+        gBS->CloseEvent (ValueInItem->TcpWrap.Tx4Token.CompletionToken.Event);
+      }
+    } else {
+      if (ValueInItem->TcpWrap.Tx6Token.CompletionToken.Event != NULL) {
+        gBS->CloseEvent (ValueInItem->TcpWrap.Tx6Token.CompletionToken.Event);
+      }
+    }
+
+    ValueInItem->HttpToken->Status = EFI_CONNECTION_FIN;
+    gBS->SignalEvent (ValueInItem->HttpToken->Event);
+  }
+
+  NetMapRemoveItem (Map, Item, NULL);
+  FreePool (ValueInItem);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Transmit the HTTP or HTTPS mssage by processing the associated HTTP token.
 
@@ -56,6 +56,19 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 
 #define HTTP_URL_BUFFER_LEN          4096
 
+#define HTTPS_SESSION_CACHE_SIZE     4
+#define HTTPS_SESSION_HOST_LEN       256
+
+//
+// TLS session ID of the last connection to a HTTPS server, used to resume the
+// TLS session with the same server instead of a full handshake.
+//
+typedef struct {
+  CHAR8                         RemoteHost[HTTPS_SESSION_HOST_LEN];
+  UINT16                        RemotePort;
+  EFI_TLS_SESSION_ID            SessionId;
+} HTTPS_SESSION_CACHE_ENTRY;
+
 typedef struct _HTTP_SERVICE {
   UINT32                        Signature;
   EFI_SERVICE_BINDING_PROTOCOL  ServiceBinding;
@@ -67,6 +80,8 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                    ChildrenList;
   UINTN                         ChildrenNumber;
   INTN                          State;
+  HTTPS_SESSION_CACHE_ENTRY     TlsSessionCache[HTTPS_SESSION_CACHE_SIZE];
+  UINTN                         TlsSessionCacheNext;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -117,6 +132,10 @@ typedef struct _HTTP_PROTOCOL {
   CHAR8                         *RemoteHost;
   UINT16                        RemotePort;
   EFI_IPv4_ADDRESS              RemoteAddr;
+  //
+  // TRUE if the server will close the connection after the current response.
+  //
+  BOOLEAN                       ConnectionClose;
   
   EFI_HANDLE                    Tcp6ChildHandle;
   EFI_TCP6_PROTOCOL             *Tcp6;
@@ -482,6 +501,26 @@ HttpTcpNotReady (
   IN VOID                   *Context
   );
 
+/**
+  Complete the HTTP request associated with TxToken or Tx6Token with EFI_CONNECTION_FIN
+  and remove it from the map, because the server is closing the connection it was
+  queued on.
+
+  @param[in]  Map                The container of TxToken.
+  @param[in]  Item               Current item to check against.
+  @param[in]  Context            The context, not used.
+
+  @retval EFI_SUCCESS            The HTTP request is removed.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpTcpAbortOnClose (
+  IN NET_MAP                *Map,
+  IN NET_MAP_ITEM           *Item,
+  IN VOID                   *Context
+  );
+
 /**
   Initialize Http session.
 
@@ -948,6 +948,148 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Set the remote host of the HTTP instance as the server name of the TLS session.
+
+  The TLS driver sends it in the server_name extension, and resumes a cached TLS
+  session only for the server it was established with.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The server name is set.
+  @retval EFI_INVALID_PARAMETER  The remote host is not set or too long.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+TlsSetServerNameExtension (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_TLS_EXTENSION            *Extension;
+  UINTN                        NameSize;
+  UINTN                        ExtensionSize;
+  UINT8                        *Ptr;
+
+  if (HttpInstance->RemoteHost == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  NameSize = AsciiStrLen (HttpInstance->RemoteHost);
+  if (NameSize == 0 || NameSize >= HTTPS_SESSION_HOST_LEN) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The extension data is a ServerNameList of RFC 6066 with one host_name.
+  //
+  ExtensionSize = OFFSET_OF (EFI_TLS_EXTENSION, Data) + sizeof (UINT16) + sizeof (UINT8) + sizeof (UINT16) + NameSize;
+  Extension = AllocateZeroPool (ExtensionSize);
+  if (Extension == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Extension->ExtensionType = TLS_EXTENSION_SERVER_NAME;
+  Extension->Length        = (UINT16) (ExtensionSize - OFFSET_OF (EFI_TLS_EXTENSION, Data));
+
+  Ptr = Extension->Data;
+  WriteUnaligned16 ((UINT16 *) Ptr, HTONS ((UINT16) (Extension->Length - sizeof (UINT16))));
+  Ptr += sizeof (UINT16);
+  *Ptr = TLS_SERVER_NAME_TYPE_HOST_NAME;
+  Ptr += sizeof (UINT8);
+  WriteUnaligned16 ((UINT16 *) Ptr, HTONS ((UINT16) NameSize));
+  Ptr += sizeof (UINT16);
+  CopyMem (Ptr, HttpInstance->RemoteHost, NameSize);
+
+  Status = HttpInstance->Tls->SetSessionData (
+                                HttpInstance->Tls,
+                                EfiTlsExtensionData,
+                                Extension,
+                                ExtensionSize
+                                );
+
+  FreePool (Extension);
+  return Status;
+}
+
+/**
+  Find the cached TLS session ID of the remote host of the HTTP instance.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @return  Pointer to the cache entry, or NULL if the remote host is not cached.
+
+**/
+HTTPS_SESSION_CACHE_ENTRY *
+TlsFindSessionCache (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  )
+{
+  HTTPS_SESSION_CACHE_ENTRY    *Entry;
+  UINTN                        Index;
+
+  if (HttpInstance->RemoteHost == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < HTTPS_SESSION_CACHE_SIZE; Index++) {
+    Entry = &HttpInstance->Service->TlsSessionCache[Index];
+    if (Entry->SessionId.Length != 0 &&
+        Entry->RemotePort == HttpInstance->RemotePort &&
+        AsciiStrCmp (Entry->RemoteHost, HttpInstance->RemoteHost) == 0) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Save the TLS session ID of the established session, so that the next connection
+  to the same remote host can resume the session.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+**/
+VOID
+TlsSaveSessionId (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  )
+{
+  EFI_STATUS                   Status;
+  HTTPS_SESSION_CACHE_ENTRY    *Entry;
+  EFI_TLS_SESSION_ID           SessionId;
+  UINTN                        SessionIdSize;
+
+  if (HttpInstance->RemoteHost == NULL ||
+      AsciiStrSize (HttpInstance->RemoteHost) > HTTPS_SESSION_HOST_LEN) {
+    return;
+  }
+
+  SessionIdSize = sizeof (EFI_TLS_SESSION_ID);
+  Status = HttpInstance->Tls->GetSessionData (
+                                HttpInstance->Tls,
+                                EfiTlsSessionID,
+                                &SessionId,
+                                &SessionIdSize
+                                );
+  if (EFI_ERROR (Status) || SessionId.Length == 0) {
+    return;
+  }
+
+  Entry = TlsFindSessionCache (HttpInstance);
+  if (Entry == NULL) {
+    Entry = &HttpInstance->Service->TlsSessionCache[HttpInstance->Service->TlsSessionCacheNext];
+    HttpInstance->Service->TlsSessionCacheNext = (HttpInstance->Service->TlsSessionCacheNext + 1) % HTTPS_SESSION_CACHE_SIZE;
+    AsciiStrCpyS (Entry->RemoteHost, HTTPS_SESSION_HOST_LEN, HttpInstance->RemoteHost);
+    Entry->RemotePort = HttpInstance->RemotePort;
+  }
+
+  CopyMem (&Entry->SessionId, &SessionId, sizeof (EFI_TLS_SESSION_ID));
+}
+
 /**
   Connect one TLS session by finishing the TLS handshake process.
 
@@ -977,6 +1119,7 @@ TlsConnectSession (
   UINTN                   BufferInSize;
   UINT8                   *GetSessionDataBuffer;
   UINTN                   GetSessionDataBufferSize;
+  HTTPS_SESSION_CACHE_ENTRY  *SessionEntry;
 
   BufferOut    = NULL;
   PacketOut    = NULL;
@@ -998,6 +1141,24 @@ TlsConnectSession (
     return Status;
   }
 
+  //
+  // Try to resume the previous TLS session with the same server, to avoid a full
+  // handshake. The full handshake is done if the session can't be resumed. The
+  // TLS driver only resumes a session established with the same server name.
+  //
+  SessionEntry = NULL;
+  if (!EFI_ERROR (TlsSetServerNameExtension (HttpInstance))) {
+    SessionEntry = TlsFindSessionCache (HttpInstance);
+  }
+  if (SessionEntry != NULL) {
+    HttpInstance->Tls->SetSessionData (
+                         HttpInstance->Tls,
+                         EfiTlsSessionID,
+                         &SessionEntry->SessionId,
+                         sizeof (EFI_TLS_SESSION_ID)
+                         );
+  }
+
   //
   // Create ClientHello
   //
@@ -1193,6 +1354,8 @@ TlsConnectSession (
 
   if (HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring) {
     Status = EFI_ABORTED;
+  } else {
+    TlsSaveSessionId (HttpInstance);
   }
 
   return Status;
@@ -177,6 +177,50 @@ TlsReceiveOnePdu (
   IN     EFI_EVENT          Timeout
   );
 
+/**
+  Set the remote host of the HTTP instance as the server name of the TLS session.
+
+  The TLS driver sends it in the server_name extension, and resumes a cached TLS
+  session only for the server it was established with.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The server name is set.
+  @retval EFI_INVALID_PARAMETER  The remote host is not set or too long.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+TlsSetServerNameExtension (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  );
+
+/**
+  Find the cached TLS session ID of the remote host of the HTTP instance.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @return  Pointer to the cache entry, or NULL if the remote host is not cached.
+
+**/
+HTTPS_SESSION_CACHE_ENTRY *
+TlsFindSessionCache (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  );
+
+/**
+  Save the TLS session ID of the established session, so that the next connection
+  to the same remote host can resume the session.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+**/
+VOID
+TlsSaveSessionId (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  );
+
 /**
   Connect one TLS session by finishing the TLS handshake process.
 
@@ -36,6 +36,10 @@ TlsCleanInstance (
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->ServerName != NULL) {
+      FreePool (Instance->ServerName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -91,7 +95,13 @@ TlsCleanService (
   IN TLS_SERVICE     *Service
   )
 {
+  UINTN              Index;
+
   if (Service != NULL) {
+    for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+      TlsFreeSession (Service->SessionCache[Index].Session);
+    }
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
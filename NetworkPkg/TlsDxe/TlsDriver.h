@@ -32,6 +32,17 @@
 
 #define TLS_INSTANCE_SIGNATURE   SIGNATURE_32 ('T', 'L', 'S', 'I')
 
+//
+// Maximum number of TLS sessions kept by the service for resumption.
+//
+#define TLS_SESSION_CACHE_SIZE   8
+
+//
+// Maximum size of the server name, including the Null-terminator, used to bind
+// a cached session to the server it was established with.
+//
+#define TLS_SERVER_NAME_SIZE     256
+
 ///
 /// TLS Service Data
 ///
@@ -42,6 +53,16 @@ typedef struct _TLS_SERVICE  TLS_SERVICE;
 ///
 typedef struct _TLS_INSTANCE TLS_INSTANCE;
 
+///
+/// TLS session of a completed handshake, keyed by the server it was established
+/// with and its session ID.
+///
+typedef struct {
+  CHAR8                           ServerName[TLS_SERVER_NAME_SIZE];
+  EFI_TLS_SESSION_ID              SessionId;
+  VOID                            *Session;
+} TLS_SESSION_CACHE_ENTRY;
+
 
 struct _TLS_SERVICE {
   UINT32                          Signature;
@@ -62,6 +83,15 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Sessions of the completed handshakes made with TlsCtx, which can be
+  // resumed by a later connection to the same server when its session ID is
+  // set through EfiTlsSessionID. Sessions are never shared across SSL_CTX
+  // objects.
+  //
+  TLS_SESSION_CACHE_ENTRY         SessionCache[TLS_SESSION_CACHE_SIZE];
+  UINTN                           SessionCacheNext;
 };
 
 struct _TLS_INSTANCE {
@@ -83,6 +113,12 @@ struct _TLS_INSTANCE {
   // per established connection.
   //
   VOID                            *TlsConn;
+
+  //
+  // Server name set through the server_name extension. Sessions are only
+  // cached and resumed for connections with a server name.
+  //
+  CHAR8                           *ServerName;
 };
 
 
@@ -325,3 +325,197 @@ ERROR:
   return Status;
 }
 
+
+/**
+  Set the server name of the TLS instance from the server_name extension.
+
+  @param[in]  Instance            The pointer to the TLS instance.
+  @param[in]  Data                Pointer to a list of EFI_TLS_EXTENSION.
+  @param[in]  DataSize            Total size of the extension list in bytes.
+
+  @retval EFI_SUCCESS             The server name is set.
+  @retval EFI_INVALID_PARAMETER   The extension list is malformed.
+  @retval EFI_UNSUPPORTED         The list holds an extension other than server_name,
+                                  or no host name.
+  @retval EFI_OUT_OF_RESOURCES    Required system resources could not be allocated.
+
+**/
+EFI_STATUS
+TlsSetExtensionData (
+  IN     TLS_INSTANCE                    *Instance,
+  IN     VOID                            *Data,
+  IN     UINTN                           DataSize
+  )
+{
+  EFI_STATUS                Status;
+  EFI_TLS_EXTENSION         *Extension;
+  UINT8                     *Ptr;
+  UINTN                     ListSize;
+  UINTN                     NameSize;
+  CHAR8                     *ServerName;
+  EFI_IPv4_ADDRESS          Ip4Address;
+  EFI_IPv6_ADDRESS          Ip6Address;
+
+  if (DataSize < OFFSET_OF (EFI_TLS_EXTENSION, Data)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Extension = (EFI_TLS_EXTENSION *) Data;
+  if (Extension->ExtensionType != TLS_EXTENSION_SERVER_NAME) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (DataSize != OFFSET_OF (EFI_TLS_EXTENSION, Data) + Extension->Length) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The extension data is a ServerNameList of RFC 6066 in network byte order.
+  // Only the first entry is used, which must be a host_name.
+  //
+  Ptr = Extension->Data;
+  if (Extension->Length < sizeof (UINT16) + sizeof (UINT8) + sizeof (UINT16)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ListSize = NTOHS (ReadUnaligned16 ((UINT16 *) Ptr));
+  if (ListSize != Extension->Length - sizeof (UINT16)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Ptr += sizeof (UINT16);
+  if (*Ptr != TLS_SERVER_NAME_TYPE_HOST_NAME) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Ptr     += sizeof (UINT8);
+  NameSize = NTOHS (ReadUnaligned16 ((UINT16 *) Ptr));
+  Ptr     += sizeof (UINT16);
+  if (NameSize == 0 || NameSize >= TLS_SERVER_NAME_SIZE ||
+      NameSize > ListSize - sizeof (UINT8) - sizeof (UINT16)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ServerName = AllocateZeroPool (NameSize + 1);
+  if (ServerName == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (ServerName, Ptr, NameSize);
+  if (AsciiStrLen (ServerName) != NameSize) {
+    FreePool (ServerName);
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // RFC 6066 does not allow a literal IP address in the host_name, but it still
+  // identifies the server the session is bound to.
+  //
+  if (!EFI_ERROR (NetLibAsciiStrToIp4 (ServerName, &Ip4Address)) ||
+      !EFI_ERROR (NetLibAsciiStrToIp6 (ServerName, &Ip6Address))) {
+    Status = EFI_SUCCESS;
+  } else {
+    Status = TlsSetServerName (Instance->TlsConn, ServerName);
+  }
+
+  if (EFI_ERROR (Status)) {
+    FreePool (ServerName);
+    return Status;
+  }
+
+  if (Instance->ServerName != NULL) {
+    FreePool (Instance->ServerName);
+  }
+  Instance->ServerName = ServerName;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Save the session of a completed handshake in the service session cache.
+
+  The session is bound to the server name of the TLS instance. Nothing is saved
+  if the TLS instance has no server name. The oldest cached session is replaced
+  if the cache is full.
+
+  @param[in]  Instance            The TLS instance which completed the handshake.
+
+**/
+VOID
+TlsCacheSession (
+  IN     TLS_INSTANCE                    *Instance
+  )
+{
+  EFI_STATUS                Status;
+  TLS_SERVICE               *Service;
+  EFI_TLS_SESSION_ID        SessionId;
+  TLS_SESSION_CACHE_ENTRY   *Entry;
+  VOID                      *Session;
+
+  Service = Instance->Service;
+  if (Instance->ServerName == NULL) {
+    return;
+  }
+
+  ZeroMem (&SessionId, sizeof (EFI_TLS_SESSION_ID));
+  Status = TlsGetSessionId (Instance->TlsConn, SessionId.Data, &SessionId.Length);
+  if (EFI_ERROR (Status) || SessionId.Length == 0 || SessionId.Length > sizeof (SessionId.Data)) {
+    return;
+  }
+
+  //
+  // A resumed session is already in the cache.
+  //
+  if (TlsFindCachedSession (Instance, &SessionId) != NULL) {
+    return;
+  }
+
+  Session = TlsGetSession (Instance->TlsConn);
+  if (Session == NULL) {
+    return;
+  }
+
+  Entry = &Service->SessionCache[Service->SessionCacheNext];
+  TlsFreeSession (Entry->Session);
+  AsciiStrCpyS (Entry->ServerName, TLS_SERVER_NAME_SIZE, Instance->ServerName);
+  CopyMem (&Entry->SessionId, &SessionId, sizeof (EFI_TLS_SESSION_ID));
+  Entry->Session = Session;
+
+  Service->SessionCacheNext = (Service->SessionCacheNext + 1) % TLS_SESSION_CACHE_SIZE;
+}
+
+/**
+  Find a cached session of the server of the TLS instance by its session ID.
+
+  @param[in]  Instance            The pointer to the TLS instance.
+  @param[in]  SessionId           The session ID to look for.
+
+  @return  Pointer to the cached TLS/SSL session object, or NULL if not found.
+
+**/
+VOID *
+TlsFindCachedSession (
+  IN     TLS_INSTANCE                    *Instance,
+  IN     EFI_TLS_SESSION_ID              *SessionId
+  )
+{
+  UINTN                     Index;
+  TLS_SESSION_CACHE_ENTRY   *Entry;
+
+  if (Instance->ServerName == NULL ||
+      SessionId->Length == 0 || SessionId->Length > sizeof (SessionId->Data)) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    Entry = &Instance->Service->SessionCache[Index];
+    if (Entry->Session != NULL &&
+        AsciiStrCmp (Entry->ServerName, Instance->ServerName) == 0 &&
+        Entry->SessionId.Length == SessionId->Length &&
+        CompareMem (Entry->SessionId.Data, SessionId->Data, SessionId->Length) == 0) {
+      return Entry->Session;
+    }
+  }
+
+  return NULL;
+}
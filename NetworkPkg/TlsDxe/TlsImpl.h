@@ -312,5 +312,56 @@ TlsConfigurationGetData (
   IN OUT UINTN                           *DataSize
   );
 
+/**
+  Set the server name of the TLS instance from the server_name extension.
+
+  @param[in]  Instance            The pointer to the TLS instance.
+  @param[in]  Data                Pointer to a list of EFI_TLS_EXTENSION.
+  @param[in]  DataSize            Total size of the extension list in bytes.
+
+  @retval EFI_SUCCESS             The server name is set.
+  @retval EFI_INVALID_PARAMETER   The extension list is malformed.
+  @retval EFI_UNSUPPORTED         The list holds an extension other than server_name,
+                                  or no host name.
+  @retval EFI_OUT_OF_RESOURCES    Required system resources could not be allocated.
+
+**/
+EFI_STATUS
+TlsSetExtensionData (
+  IN     TLS_INSTANCE                    *Instance,
+  IN     VOID                            *Data,
+  IN     UINTN                           DataSize
+  );
+
+/**
+  Save the session of a completed handshake in the service session cache.
+
+  The session is bound to the server name of the TLS instance. Nothing is saved
+  if the TLS instance has no server name. The oldest cached session is replaced
+  if the cache is full.
+
+  @param[in]  Instance            The TLS instance which completed the handshake.
+
+**/
+VOID
+TlsCacheSession (
+  IN     TLS_INSTANCE                    *Instance
+  );
+
+/**
+  Find a cached session of the server of the TLS instance by its session ID.
+
+  @param[in]  Instance            The pointer to the TLS instance.
+  @param[in]  SessionId           The session ID to look for.
+
+  @return  Pointer to the cached TLS/SSL session object, or NULL if not found.
+
+**/
+VOID *
+TlsFindCachedSession (
+  IN     TLS_INSTANCE                    *Instance,
+  IN     EFI_TLS_SESSION_ID              *SessionId
+  );
+
 #endif
 
@@ -60,6 +60,7 @@ TlsSetSessionData (
   TLS_INSTANCE              *Instance;
   UINT16                    *CipherId;
   UINTN                     Index;
+  VOID                      *Session;
 
   EFI_TPL                   OldTpl;
 
@@ -134,8 +135,8 @@ TlsSetSessionData (
 
     break;
   case EfiTlsExtensionData:
-    Status = EFI_UNSUPPORTED;
-    goto ON_EXIT;
+    Status = TlsSetExtensionData (Instance, Data, DataSize);
+    break;
   case EfiTlsVerifyMethod:
     if (DataSize != sizeof (EFI_TLS_VERIFY)) {
       Status = EFI_INVALID_PARAMETER;
@@ -150,6 +151,18 @@ TlsSetSessionData (
       goto ON_EXIT;
     }
 
+    //
+    // Resume the cached session with this ID if the handshake is not started yet
+    // and the session was established with the same server.
+    //
+    if (Instance->TlsSessionState == EfiTlsSessionNotStarted) {
+      Session = TlsFindCachedSession (Instance, (EFI_TLS_SESSION_ID *) Data);
+      if (Session != NULL) {
+        Status = TlsSetSession (Instance->TlsConn, Session);
+        break;
+      }
+    }
+
     Status = TlsSetSessionId (
                Instance->TlsConn,
                ((EFI_TLS_SESSION_ID *) Data)->Data,
@@ -518,6 +531,7 @@ TlsBuildResponsePacket (
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsCacheSession (Instance);
       }
     } else {
       //
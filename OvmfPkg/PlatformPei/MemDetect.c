@@ -595,6 +595,8 @@ QemuInitializeRam (
   UINT64                      LowerMemorySize;
   UINT64                      UpperMemorySize;
   MTRR_SETTINGS               MtrrSettings;
+  MTRR_BATCH                  MtrrBatch;
+  MTRR_MEMORY_RANGE           MtrrRanges[2];
   EFI_STATUS                  Status;
 
   DEBUG ((EFI_D_INFO, "%a called\n", __FUNCTION__));
@@ -682,12 +684,17 @@ QemuInitializeRam (
     SetMem (&MtrrSettings.Fixed, sizeof MtrrSettings.Fixed, 0x06);
     ZeroMem (&MtrrSettings.Variables, sizeof MtrrSettings.Variables);
     MtrrSettings.MtrrDefType |= BIT11 | BIT10 | 6;
-    MtrrSetAllMtrrs (&MtrrSettings);
+
+    //
+    // Calculate both uncacheable ranges in the settings buffer, so that the
+    // MTRRs are programmed only once.
+    //
+    MtrrBatchInitialize (&MtrrBatch, MtrrRanges, ARRAY_SIZE (MtrrRanges));
 
     //
     // Set memory range from 640KB to 1MB to uncacheable
     //
-    Status = MtrrSetMemoryAttribute (BASE_512KB + BASE_128KB,
+    Status = MtrrBatchAddRange (&MtrrBatch, BASE_512KB + BASE_128KB,
                BASE_1MB - (BASE_512KB + BASE_128KB), CacheUncacheable);
     ASSERT_EFI_ERROR (Status);
 
@@ -695,9 +702,13 @@ QemuInitializeRam (
     // Set memory range from the "top of lower RAM" (RAM below 4GB) to 4GB as
     // uncacheable
     //
-    Status = MtrrSetMemoryAttribute (LowerMemorySize,
+    Status = MtrrBatchAddRange (&MtrrBatch, LowerMemorySize,
                SIZE_4GB - LowerMemorySize, CacheUncacheable);
     ASSERT_EFI_ERROR (Status);
+
+    Status = MtrrBatchCommit (&MtrrBatch, &MtrrSettings);
+    ASSERT_EFI_ERROR (Status);
+    MtrrSetAllMtrrs (&MtrrSettings);
   }
 }
 
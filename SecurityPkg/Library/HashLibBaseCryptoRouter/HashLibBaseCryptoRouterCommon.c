@@ -18,9 +18,12 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/Tpm2CommandLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID  Guid;
   UINT32    Mask;
@@ -75,3 +78,64 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count ++;
 }
+
+/**
+  Feed data to all hash interfaces enabled by PcdTpm2HashMask in a single
+  pass over the buffer.
+
+  The buffer is split into chunks of HASH_UPDATE_CHUNK_SIZE bytes and each
+  chunk is handed to every enabled hash interface before moving on, so that
+  it is read from memory only once no matter how many PCR banks are active.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashUpdateAllInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  HASH_UPDATE        Update[HASH_COUNT];
+  HASH_HANDLE        UpdateCtx[HASH_COUNT];
+  UINTN              UpdateCount;
+  UINTN              Index;
+  UINT32             HashMask;
+  UINT8              *Chunk;
+  UINTN              ChunkLen;
+
+  //
+  // Resolve the enabled hash interfaces once, instead of once per chunk.
+  //
+  UpdateCount = 0;
+  for (Index = 0; Index < HashInterfaceCount && UpdateCount < HASH_COUNT; Index++) {
+    HashMask = Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid);
+    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
+      Update[UpdateCount]    = HashInterface[Index].HashUpdate;
+      UpdateCtx[UpdateCount] = HashCtx[Index];
+      UpdateCount++;
+    }
+  }
+
+  if (UpdateCount == 1) {
+    Update[0] (UpdateCtx[0], DataToHash, DataToHashLen);
+    return;
+  }
+
+  Chunk = DataToHash;
+  while (DataToHashLen != 0) {
+    ChunkLen = MIN (DataToHashLen, HASH_UPDATE_CHUNK_SIZE);
+    for (Index = 0; Index < UpdateCount; Index++) {
+      Update[Index] (UpdateCtx[Index], Chunk, ChunkLen);
+    }
+    Chunk         += ChunkLen;
+    DataToHashLen -= ChunkLen;
+  }
+}
@@ -15,6 +15,12 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// Size of the data chunk handed to each hash interface in turn. It is small
+// enough to stay in the data cache while all PCR banks consume it.
+//
+#define HASH_UPDATE_CHUNK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -41,4 +47,28 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES     *Digest
   );
 
+/**
+  Feed data to all hash interfaces enabled by PcdTpm2HashMask in a single
+  pass over the buffer.
+
+  The buffer is split into chunks of HASH_UPDATE_CHUNK_SIZE bytes and each
+  chunk is handed to every enabled hash interface before moving on, so that
+  it is read from memory only once no matter how many PCR banks are active.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashUpdateAllInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
@@ -19,6 +19,7 @@
 
 #include <Protocol/Cpu.h>
 #include <Protocol/MpService.h>
+#include <Protocol/MpTask.h>
 #include <Register/Msr.h>
 
 #include <Ppi/SecPlatformInformation.h>
@@ -44,6 +45,7 @@
 
 #include <Guid/IdleLoopEvent.h>
 #include <Guid/VectorHandoffTable.h>
+#include <Guid/EventLegacyBios.h>
 
 #define EFI_MEMORY_CACHETYPE_MASK     (EFI_MEMORY_UC  | \
                                        EFI_MEMORY_WC  | \
@@ -265,6 +267,19 @@ SetDataSelectors (
   UINT16 Selector
   );
 
+/**
+  Invalidates the TLB entries of the page which contains Address on the
+  calling processor.
+
+  @param  Address  The linear address in the page to invalidate.
+
+**/
+VOID
+EFIAPI
+InvalidateTlbEntry (
+  UINTN Address
+  );
+
 /**
   Update GCD memory space attributes according to current page table setup.
 **/
@@ -273,7 +288,17 @@ RefreshGcdMemoryAttributesFromPaging (
   VOID
   );
 
+/**
+  Flush the TLBs of the APs if page attributes were changed since they were
+  last flushed.
+**/
+VOID
+FlushPendingApTlb (
+  VOID
+  );
+
 extern BOOLEAN mIsAllocatingPageTable;
+extern BOOLEAN mIsMpInitialized;
 
 #endif
 
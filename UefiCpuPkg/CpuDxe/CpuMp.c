@@ -17,6 +17,7 @@
 
 EFI_HANDLE     mMpServiceHandle       = NULL;
 UINTN          mNumberOfProcessors    = 1;
+BOOLEAN        mIsMpInitialized       = FALSE;
 
 EFI_MP_SERVICES_PROTOCOL  mMpServicesTemplate = {
   GetNumberOfProcessors,
@@ -28,6 +29,10 @@ EFI_MP_SERVICES_PROTOCOL  mMpServicesTemplate = {
   WhoAmI
 };
 
+EDKII_MP_TASK_PROTOCOL  mMpTaskTemplate = {
+  ParallelFor
+};
+
 /**
   This service retrieves the number of logical processor in the platform
   and the number of those logical processors that are enabled on this boot.
@@ -267,6 +272,7 @@ StartupAllAPs (
   OUT UINTN                     **FailedCpuList         OPTIONAL
   )
 {
+  FlushPendingApTlb ();
   return MpInitLibStartupAllAPs (
            Procedure,
            SingleThread,
@@ -375,6 +381,7 @@ StartupThisAP (
   OUT BOOLEAN                   *Finished               OPTIONAL
   )
 {
+  FlushPendingApTlb ();
   return MpInitLibStartupThisAP (
            Procedure,
            ProcessorNumber,
@@ -428,6 +435,7 @@ SwitchBSP (
   IN  BOOLEAN                  EnableOldBSP
   )
 {
+  FlushPendingApTlb ();
   return MpInitLibSwitchBSP (ProcessorNumber, EnableOldBSP);
 }
 
@@ -518,6 +526,36 @@ WhoAmI (
   return MpInitLibWhoAmI (ProcessorNumber);;
 }
 
+/**
+  Run Procedure once for each index from 0 to Count - 1, spread over all
+  the enabled processors, and return when all the indexes are done.
+
+  @param[in]  This        The EDKII_MP_TASK_PROTOCOL instance.
+  @param[in]  Procedure   The procedure to run for each index.
+  @param[in]  Count       The number of indexes.
+  @param[in]  Grain       The number of consecutive indexes run as one task,
+                          0 lets the service choose.
+  @param[in]  Context     The context passed to Procedure.
+
+  @retval EFI_SUCCESS           All the indexes have been run.
+  @retval EFI_INVALID_PARAMETER Procedure is NULL.
+  @retval EFI_DEVICE_ERROR      The caller is not the BSP.
+
+**/
+EFI_STATUS
+EFIAPI
+ParallelFor (
+  IN  EDKII_MP_TASK_PROTOCOL              *This,
+  IN  EDKII_MP_TASK_PROCEDURE             Procedure,
+  IN  UINTN                               Count,
+  IN  UINTN                               Grain,
+  IN  VOID                                *Context OPTIONAL
+  )
+{
+  FlushPendingApTlb ();
+  return MpInitLibParallelFor ((MP_TASK_PROCEDURE) Procedure, Count, Grain, Context);
+}
+
 /**
   Collects BIST data from HOB.
 
@@ -790,6 +828,26 @@ InitializeMpExceptionStackSwitchHandlers (
   }
 }
 
+/**
+  Callback function for ExitBootServices and LegacyBoot.
+
+  Flush the TLBs of the APs before MpInitLib hands them over to the OS.
+
+  @param[in]  Event         Event whose notification function is being invoked.
+  @param[in]  Context       The pointer to the notification function's context,
+                            which is implementation-dependent.
+
+**/
+VOID
+EFIAPI
+FlushPendingApTlbCallback (
+  IN EFI_EVENT                Event,
+  IN VOID                     *Context
+  )
+{
+  FlushPendingApTlb ();
+}
+
 /**
   Initialize Multi-processor support.
 
@@ -802,6 +860,30 @@ InitializeMpSupport (
   EFI_STATUS     Status;
   UINTN          NumberOfProcessors;
   UINTN          NumberOfEnabledProcessors;
+  EFI_EVENT      Event;
+
+  //
+  // Register the TLB flush at TPL_NOTIFY, so that it runs before the
+  // TPL_CALLBACK handlers with which MpInitLib wakes up the APs.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                  TPL_NOTIFY,
+                  FlushPendingApTlbCallback,
+                  NULL,
+                  &Event
+                  );
+  ASSERT_EFI_ERROR (Status);
+
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  FlushPendingApTlbCallback,
+                  NULL,
+                  &gEfiEventLegacyBootGuid,
+                  &Event
+                  );
+  ASSERT_EFI_ERROR (Status);
 
   //
   // Wakeup APs to do initialization
@@ -809,6 +891,13 @@ InitializeMpSupport (
   Status = MpInitLibInitialize ();
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Make the page attributes changed while MpInitLib was initializing, such
+  // as the AP stack guards, take effect on the APs.
+  //
+  mIsMpInitialized = TRUE;
+  FlushPendingApTlb ();
+
   MpInitLibGetNumberOfProcessors (&NumberOfProcessors, &NumberOfEnabledProcessors);
   mNumberOfProcessors = NumberOfProcessors;
   DEBUG ((DEBUG_INFO, "Detect CPU count: %d\n", mNumberOfProcessors));
@@ -826,6 +915,7 @@ InitializeMpSupport (
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &mMpServiceHandle,
                   &gEfiMpServiceProtocolGuid,  &mMpServicesTemplate,
+                  &gEdkiiMpTaskProtocolGuid,   &mMpTaskTemplate,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
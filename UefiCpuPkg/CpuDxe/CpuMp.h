@@ -472,5 +472,31 @@ WhoAmI (
   OUT UINTN                    *ProcessorNumber
   );
 
+/**
+  Run Procedure once for each index from 0 to Count - 1, spread over all
+  the enabled processors, and return when all the indexes are done.
+
+  @param[in]  This        The EDKII_MP_TASK_PROTOCOL instance.
+  @param[in]  Procedure   The procedure to run for each index.
+  @param[in]  Count       The number of indexes.
+  @param[in]  Grain       The number of consecutive indexes run as one task,
+                          0 lets the service choose.
+  @param[in]  Context     The context passed to Procedure.
+
+  @retval EFI_SUCCESS           All the indexes have been run.
+  @retval EFI_INVALID_PARAMETER Procedure is NULL.
+  @retval EFI_DEVICE_ERROR      The caller is not the BSP.
+
+**/
+EFI_STATUS
+EFIAPI
+ParallelFor (
+  IN  EDKII_MP_TASK_PROTOCOL              *This,
+  IN  EDKII_MP_TASK_PROCEDURE             Procedure,
+  IN  UINTN                               Count,
+  IN  UINTN                               Grain,
+  IN  VOID                                *Context OPTIONAL
+  );
+
 #endif // _CPU_MP_H_
 
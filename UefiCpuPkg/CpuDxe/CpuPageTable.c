@@ -62,6 +62,12 @@
 #define PAGING_2M_ADDRESS_MASK_64 0x000FFFFFFFE00000ull
 #define PAGING_1G_ADDRESS_MASK_64 0x000FFFFFC0000000ull
 
+//
+// Invalidate one page at a time below this number of pages, or flush the
+// whole TLB above it.
+//
+#define MAX_INVALIDATE_TLB_ENTRY_PAGES  16
+
 typedef enum {
   PageNone,
   Page4K,
@@ -89,6 +95,23 @@ PAGE_ATTRIBUTE_TABLE mPageAttributeTable[] = {
 
 PAGE_TABLE_POOL   *mPageTablePool = NULL;
 
+//
+// Page table pages released by merging pages back, kept for the next split.
+//
+VOID              *mFreePageTablePages = NULL;
+
+//
+// Page table pages released by merging pages back, which the APs may still
+// walk through stale TLB entries. They move to mFreePageTablePages once all
+// the APs have flushed their TLBs.
+//
+VOID              *mRetiredPageTablePages = NULL;
+
+//
+// TRUE if page attributes have changed since the APs last flushed their TLBs
+//
+BOOLEAN           mApTlbFlushPending = FALSE;
+
 /**
   Enable write protection function for AP.
 
@@ -117,42 +140,6 @@ SyncCpuFlushTlb (
   CpuFlushTlb();
 }
 
-/**
-  Sync memory page attributes for AP.
-
-  @param[in] Procedure            A pointer to the function to be run on enabled APs of
-                                  the system.
-**/
-VOID
-SyncMemoryPageAttributesAp (
-  IN EFI_AP_PROCEDURE            Procedure
-  )
-{
-  EFI_STATUS                Status;
-  EFI_MP_SERVICES_PROTOCOL  *MpService;
-
-  Status = gBS->LocateProtocol (
-                  &gEfiMpServiceProtocolGuid,
-                  NULL,
-                  (VOID **)&MpService
-                  );
-  //
-  // Synchronize the update with all APs
-  //
-  if (!EFI_ERROR (Status)) {
-    Status = MpService->StartupAllAPs (
-                          MpService,          // This
-                          Procedure,          // Procedure
-                          FALSE,              // SingleThread
-                          NULL,               // WaitEvent
-                          0,                  // TimeoutInMicrosecsond
-                          NULL,               // ProcedureArgument
-                          NULL                // FailedCpuList
-                          );
-    ASSERT (Status == EFI_SUCCESS || Status == EFI_NOT_STARTED || Status == EFI_NOT_READY);
-  }
-}
-
 /**
   Return current paging context.
 
@@ -360,6 +347,8 @@ GetAttributesFromPageEntry (
   @param[in]  Attributes       The bit mask of attributes to modify for the memory region.
   @param[in]  PageAction       The page action.
   @param[out] IsModified       TRUE means page table modified. FALSE means page table not modified.
+  @param[out] IsRestricted     TRUE means the page entry grants fewer access rights than before.
+                               FALSE means it does not.
 **/
 VOID
 ConvertPageEntryAttribute (
@@ -367,7 +356,8 @@ ConvertPageEntryAttribute (
   IN  UINT64                            *PageEntry,
   IN  UINT64                            Attributes,
   IN  PAGE_ACTION                       PageAction,
-  OUT BOOLEAN                           *IsModified
+  OUT BOOLEAN                           *IsModified,
+  OUT BOOLEAN                           *IsRestricted
   )
 {
   UINT64  CurrentPageEntry;
@@ -445,6 +435,8 @@ ConvertPageEntryAttribute (
   } else {
     *IsModified = FALSE;
   }
+  *IsRestricted = (BOOLEAN)(((CurrentPageEntry & ~NewPageEntry) & (IA32_PG_P | IA32_PG_RW)) != 0 ||
+                            ((NewPageEntry & ~CurrentPageEntry) & IA32_PG_NX) != 0);
 }
 
 /**
@@ -559,6 +551,197 @@ SplitPage (
   }
 }
 
+/**
+  Return the page table entry at the given level which maps the address,
+  whether it maps a page or points to a page table of the next level.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  Address           The address to be checked.
+  @param[in]  PageAttribute     Page2M for the page directory entry, Page1G
+                                for the page directory pointer entry.
+
+  @return The page entry, or NULL if the address is not mapped down to that
+          level.
+**/
+UINT64 *
+GetPageTableEntryAtLevel (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT     *PagingContext,
+  IN  PHYSICAL_ADDRESS                  Address,
+  IN  PAGE_ATTRIBUTE                    PageAttribute
+  )
+{
+  UINTN                 Index2;
+  UINTN                 Index3;
+  UINTN                 Index4;
+  UINT64                *L2PageTable;
+  UINT64                *L3PageTable;
+  UINT64                *L4PageTable;
+  UINT64                AddressEncMask;
+
+  Index4 = ((UINTN)RShiftU64 (Address, 39)) & PAGING_PAE_INDEX_MASK;
+  Index3 = ((UINTN)Address >> 30) & PAGING_PAE_INDEX_MASK;
+  Index2 = ((UINTN)Address >> 21) & PAGING_PAE_INDEX_MASK;
+
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+
+  if (PagingContext->MachineType == IMAGE_FILE_MACHINE_X64) {
+    L4PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.X64.PageTableBase;
+    if (L4PageTable[Index4] == 0) {
+      return NULL;
+    }
+    L3PageTable = (UINT64 *)(UINTN)(L4PageTable[Index4] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  } else {
+    L3PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.Ia32.PageTableBase;
+  }
+  if (PageAttribute == Page1G) {
+    return &L3PageTable[Index3];
+  }
+
+  if ((L3PageTable[Index3] == 0) || ((L3PageTable[Index3] & IA32_PG_PS) != 0)) {
+    return NULL;
+  }
+  L2PageTable = (UINT64 *)(UINTN)(L3PageTable[Index3] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  return &L2PageTable[Index2];
+}
+
+/**
+  This function merges the page table pointed to by a page entry back into
+  one large page, if all its entries map contiguous memory with the same
+  attributes. It is the reverse of SplitPage().
+
+  @param[in, out]  PageEntry      The page entry which points to a page table.
+  @param[in]       PageAttribute  The page attribute of the page entry once it
+                                  is merged, Page2M or Page1G.
+
+  @retval TRUE   The page table is merged and freed.
+  @retval FALSE  The page table cannot be merged.
+**/
+BOOLEAN
+MergePage (
+  IN OUT UINT64                         *PageEntry,
+  IN     PAGE_ATTRIBUTE                 PageAttribute
+  )
+{
+  UINT64   *PageTable;
+  UINT64   ChildLength;
+  UINT64   ChildAddressMask;
+  UINT64   ChildAddress;
+  UINT64   Attributes;
+  UINTN    Index;
+  UINT64   AddressEncMask;
+
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+
+  if (((*PageEntry & IA32_PG_P) == 0) || ((*PageEntry & IA32_PG_PS) != 0)) {
+    return FALSE;
+  }
+
+  if (PageAttribute == Page2M) {
+    ChildLength      = SIZE_4KB;
+    ChildAddressMask = PAGING_4K_ADDRESS_MASK_64;
+  } else {
+    ChildLength      = SIZE_2MB;
+    ChildAddressMask = PAGING_2M_ADDRESS_MASK_64;
+  }
+
+  PageTable    = (UINT64 *)(UINTN)(*PageEntry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  ChildAddress = PageTable[0] & ChildAddressMask;
+  Attributes   = PageTable[0] & ~ChildAddressMask;
+  if (((ChildAddress & ~AddressEncMask) & (PageAttributeToLength (PageAttribute) - 1)) != 0) {
+    return FALSE;
+  }
+
+  if (PageAttribute == Page2M) {
+    //
+    // The PAT bit of a 4K page is where the PS bit of a 2M page is.
+    //
+    if ((Attributes & IA32_PG_PAT_4K) != 0) {
+      return FALSE;
+    }
+  } else {
+    if ((Attributes & IA32_PG_PS) == 0) {
+      return FALSE;
+    }
+  }
+
+  for (Index = 1; Index < SIZE_4KB / sizeof(UINT64); Index++) {
+    if ((PageTable[Index] & ChildAddressMask) != ChildAddress + ChildLength * Index) {
+      return FALSE;
+    }
+    if (((PageTable[Index] ^ Attributes) & ~ChildAddressMask & ~(UINT64)(IA32_PG_A | IA32_PG_D)) != 0) {
+      return FALSE;
+    }
+  }
+
+  //
+  // The access rights of the page entry apply to the whole range as well.
+  //
+  Attributes &= ~(UINT64)(IA32_PG_P | IA32_PG_RW | IA32_PG_U) | (*PageEntry & (IA32_PG_P | IA32_PG_RW | IA32_PG_U));
+  Attributes |= (*PageEntry & IA32_PG_NX) | IA32_PG_PS;
+
+  *PageEntry = ChildAddress | Attributes;
+  DEBUG ((DEBUG_INFO, "Merge - 0x%x\n", PageTable));
+
+  //
+  // Keep the page table page for the next split, once all the APs have
+  // dropped the translations cached from it.
+  //
+  *(VOID **)PageTable = mRetiredPageTablePages;
+  mRetiredPageTablePages = PageTable;
+  return TRUE;
+}
+
+/**
+  This function merges the page tables covering a memory region back into
+  large pages wherever possible, to undo the splits made by earlier changes.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  BaseAddress       The start address of the memory region.
+  @param[in]  Length            The size in bytes of the memory region.
+
+  @retval TRUE   At least one page table is merged.
+  @retval FALSE  No page table is merged.
+**/
+BOOLEAN
+MergeMemoryPages (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT     *PagingContext,
+  IN  PHYSICAL_ADDRESS                  BaseAddress,
+  IN  UINT64                            Length
+  )
+{
+  BOOLEAN                           IsMerged;
+  PHYSICAL_ADDRESS                  Address;
+  PHYSICAL_ADDRESS                  EndAddress;
+  UINT64                            *PageEntry;
+
+  IsMerged   = FALSE;
+  EndAddress = BaseAddress + Length;
+
+  for (Address = BaseAddress & ~(UINT64)PAGING_2M_MASK; Address < EndAddress; Address += SIZE_2MB) {
+    PageEntry = GetPageTableEntryAtLevel (PagingContext, Address, Page2M);
+    if ((PageEntry != NULL) && MergePage (PageEntry, Page2M)) {
+      IsMerged = TRUE;
+    }
+  }
+
+  //
+  // 1G pages only exist in 64-bit mode, and only if the processor has them.
+  //
+  if ((PagingContext->MachineType != IMAGE_FILE_MACHINE_X64) ||
+      ((PagingContext->ContextData.Ia32.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAGE_1G_SUPPORT) == 0)) {
+    return IsMerged;
+  }
+
+  for (Address = BaseAddress & ~(UINT64)PAGING_1G_MASK; Address < EndAddress; Address += SIZE_1GB) {
+    PageEntry = GetPageTableEntryAtLevel (PagingContext, Address, Page1G);
+    if ((PageEntry != NULL) && MergePage (PageEntry, Page1G)) {
+      IsMerged = TRUE;
+    }
+  }
+
+  return IsMerged;
+}
+
 /**
  Check the WP status in CR0 register. This bit is used to lock or unlock write
  access to pages marked as read-only.
@@ -610,6 +793,66 @@ EnableReadOnlyPageWriteProtect (
   AsmWriteCr0 (AsmReadCr0() | BIT16);
 }
 
+/**
+  Flush the TLBs of the APs if page attributes were changed since they were
+  last flushed.
+
+  Changes which grant access rights, page splits and page merges are left
+  pending. An AP sitting in its idle loop may keep stale TLB entries for them
+  until it is next given a procedure to run, so this function is called by the
+  MP services right before the APs are started, and when the APs are handed
+  over to the OS, so that all such changes made in between cost one TLB
+  shootdown.
+
+  Until the flush is done, the page table pages released by merging are not
+  reused.
+**/
+VOID
+FlushPendingApTlb (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  VOID                      *PageTable;
+  BOOLEAN                   IsWpEnabled;
+
+  if (!mApTlbFlushPending || !mIsMpInitialized) {
+    return;
+  }
+
+  Status = MpInitLibStartupAllAPs (
+             SyncCpuFlushTlb,    // Procedure
+             FALSE,              // SingleThread
+             NULL,               // WaitEvent
+             0,                  // TimeoutInMicrosecsond
+             NULL,               // ProcedureArgument
+             NULL                // FailedCpuList
+             );
+  if (Status == EFI_SUCCESS || Status == EFI_NOT_STARTED) {
+    mApTlbFlushPending = FALSE;
+
+    //
+    // No AP can reach the retired page tables any more. The lists are linked
+    // through the page table pages, which may be read-only.
+    //
+    if (mRetiredPageTablePages != NULL) {
+      IsWpEnabled = IsReadOnlyPageWriteProtected ();
+      if (IsWpEnabled) {
+        DisableReadOnlyPageWriteProtect ();
+      }
+      while (mRetiredPageTablePages != NULL) {
+        PageTable = mRetiredPageTablePages;
+        mRetiredPageTablePages = *(VOID **)PageTable;
+        *(VOID **)PageTable = mFreePageTablePages;
+        mFreePageTablePages = PageTable;
+      }
+      if (IsWpEnabled) {
+        EnableReadOnlyPageWriteProtect ();
+      }
+    }
+  }
+}
+
 /**
   This function modifies the page attributes for the memory region specified by BaseAddress and
   Length from their current attributes to the attributes specified by Attributes.
@@ -625,6 +868,8 @@ EnableReadOnlyPageWriteProtect (
                                 NULL mean page split is unsupported.
   @param[out] IsSplitted        TRUE means page table splitted. FALSE means page table not splitted.
   @param[out] IsModified        TRUE means page table modified. FALSE means page table not modified.
+  @param[out] IsRestricted      TRUE means access rights were taken away from some page. FALSE means
+                                access rights were only kept or granted.
 
   @retval RETURN_SUCCESS           The attributes were modified for the memory region.
   @retval RETURN_ACCESS_DENIED     The attributes for the memory resource range specified by
@@ -648,7 +893,8 @@ ConvertMemoryPageAttributes (
   IN  PAGE_ACTION                       PageAction,
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES     AllocatePagesFunc OPTIONAL,
   OUT BOOLEAN                           *IsSplitted,  OPTIONAL
-  OUT BOOLEAN                           *IsModified   OPTIONAL
+  OUT BOOLEAN                           *IsModified,  OPTIONAL
+  OUT BOOLEAN                           *IsRestricted OPTIONAL
   )
 {
   PAGE_TABLE_LIB_PAGING_CONTEXT     CurrentPagingContext;
@@ -658,6 +904,7 @@ ConvertMemoryPageAttributes (
   PAGE_ATTRIBUTE                    SplitAttribute;
   RETURN_STATUS                     Status;
   BOOLEAN                           IsEntryModified;
+  BOOLEAN                           IsEntryRestricted;
   BOOLEAN                           IsWpEnabled;
 
   if ((BaseAddress & (SIZE_4KB - 1)) != 0) {
@@ -719,6 +966,9 @@ ConvertMemoryPageAttributes (
   if (IsModified != NULL) {
     *IsModified = FALSE;
   }
+  if (IsRestricted != NULL) {
+    *IsRestricted = FALSE;
+  }
   if (AllocatePagesFunc == NULL) {
     AllocatePagesFunc = AllocatePageTableMemory;
   }
@@ -744,12 +994,17 @@ ConvertMemoryPageAttributes (
     PageEntryLength = PageAttributeToLength (PageAttribute);
     SplitAttribute = NeedSplitPage (BaseAddress, Length, PageEntry, PageAttribute);
     if (SplitAttribute == PageNone) {
-      ConvertPageEntryAttribute (&CurrentPagingContext, PageEntry, Attributes, PageAction, &IsEntryModified);
+      ConvertPageEntryAttribute (&CurrentPagingContext, PageEntry, Attributes, PageAction, &IsEntryModified, &IsEntryRestricted);
       if (IsEntryModified) {
         if (IsModified != NULL) {
           *IsModified = TRUE;
         }
       }
+      if (IsEntryRestricted) {
+        if (IsRestricted != NULL) {
+          *IsRestricted = TRUE;
+        }
+      }
       //
       // Convert success, move to next
       //
@@ -826,19 +1081,58 @@ AssignMemoryPageAttributes (
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES     AllocatePagesFunc OPTIONAL
   )
 {
-  RETURN_STATUS  Status;
-  BOOLEAN        IsModified;
-  BOOLEAN        IsSplitted;
+  RETURN_STATUS                  Status;
+  BOOLEAN                        IsModified;
+  BOOLEAN                        IsSplitted;
+  BOOLEAN                        IsMerged;
+  BOOLEAN                        IsRestricted;
+  BOOLEAN                        IsWpEnabled;
+  PAGE_TABLE_LIB_PAGING_CONTEXT  CurrentPagingContext;
+  UINTN                          Index;
 
 //  DEBUG((DEBUG_INFO, "AssignMemoryPageAttributes: 0x%lx - 0x%lx (0x%lx)\n", BaseAddress, Length, Attributes));
-  Status = ConvertMemoryPageAttributes (PagingContext, BaseAddress, Length, Attributes, PageActionAssign, AllocatePagesFunc, &IsSplitted, &IsModified);
+  Status = ConvertMemoryPageAttributes (PagingContext, BaseAddress, Length, Attributes, PageActionAssign, AllocatePagesFunc, &IsSplitted, &IsModified, &IsRestricted);
   if (!EFI_ERROR(Status)) {
     if ((PagingContext == NULL) && IsModified) {
+      GetCurrentPagingContext (&CurrentPagingContext);
+
+      //
+      // Merge back the page tables which now hold the same attributes, so
+      // that memory protection does not leave the page table fragmented.
+      //
+      IsWpEnabled = IsReadOnlyPageWriteProtected ();
+      if (IsWpEnabled) {
+        DisableReadOnlyPageWriteProtect ();
+      }
+      IsMerged = MergeMemoryPages (&CurrentPagingContext, BaseAddress, Length);
+      if (IsWpEnabled) {
+        EnableReadOnlyPageWriteProtect ();
+      }
+
       //
-      // Flush TLB as last step
+      // Flush TLB as last step. Only the pages whose attributes have changed
+      // need to be invalidated if the page table structure is unchanged and
+      // PCIDs are not in use.
       //
-      CpuFlushTlb();
-      SyncMemoryPageAttributesAp (SyncCpuFlushTlb);
+      if (!IsSplitted && !IsMerged && ((AsmReadCr4 () & BIT17) == 0) &&
+          (EFI_SIZE_TO_PAGES ((UINTN)Length) <= MAX_INVALIDATE_TLB_ENTRY_PAGES)) {
+        for (Index = 0; Index < EFI_SIZE_TO_PAGES ((UINTN)Length); Index++) {
+          InvalidateTlbEntry ((UINTN)BaseAddress + EFI_PAGES_TO_SIZE (Index));
+        }
+      } else {
+        CpuFlushTlb();
+      }
+
+      //
+      // Taking access rights away must reach the APs right now. A stale entry
+      // with fewer rights only costs the AP a page fault, which drops it, and
+      // split or merged pages map the same way as before, so those changes
+      // wait for the next time the APs are started.
+      //
+      mApTlbFlushPending = TRUE;
+      if (IsRestricted) {
+        FlushPendingApTlb ();
+      }
     }
   }
 
@@ -1065,7 +1359,8 @@ InitializePageTablePool (
     PageActionSet,
     AllocatePageTableMemory,
     NULL,
-    &IsModified
+    &IsModified,
+    NULL
     );
   ASSERT (IsModified == TRUE);
 
@@ -1101,6 +1396,15 @@ AllocatePageTableMemory (
     return NULL;
   }
 
+  //
+  // Reuse a page table page freed by a merge first.
+  //
+  if (Pages == 1 && mFreePageTablePages != NULL) {
+    Buffer = mFreePageTablePages;
+    mFreePageTablePages = *(VOID **)Buffer;
+    return Buffer;
+  }
+
   //
   // Renew the pool if necessary.
   //
@@ -54,5 +54,17 @@ SetDataSelectors PROC PUBLIC
     ret
 SetDataSelectors ENDP
 
+;------------------------------------------------------------------------------
+; VOID
+; InvalidateTlbEntry (
+;   UINTN Address
+;   );
+;------------------------------------------------------------------------------
+InvalidateTlbEntry PROC PUBLIC
+    mov     eax, [esp+4]
+    invlpg  [eax]
+    ret
+InvalidateTlbEntry ENDP
+
 
 END
@@ -50,5 +50,16 @@ SetDataSelectors PROC PUBLIC
     ret
 SetDataSelectors ENDP
 
+;------------------------------------------------------------------------------
+; VOID
+; InvalidateTlbEntry (
+;   UINTN Address
+;   );
+;------------------------------------------------------------------------------
+InvalidateTlbEntry PROC PUBLIC
+    invlpg  [rcx]
+    ret
+InvalidateTlbEntry ENDP
+
 END
 
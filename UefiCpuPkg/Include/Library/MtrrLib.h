@@ -109,6 +109,18 @@ typedef struct {
   MTRR_MEMORY_CACHE_TYPE Type;
 } MTRR_MEMORY_RANGE;
 
+//
+// A batch of memory attribute settings which are accumulated by
+// MtrrBatchAddRange() and applied by one MTRR calculation in MtrrBatchCommit().
+// The Ranges buffer is provided by the caller, so a batch can live on the
+// stack in PEI.
+//
+typedef struct {
+  MTRR_MEMORY_RANGE      *Ranges;
+  UINTN                  RangeCount;
+  UINTN                  MaxRangeCount;
+} MTRR_BATCH;
+
 /**
   Returns the variable MTRR count for the CPU.
 
@@ -412,4 +424,85 @@ MtrrSetMemoryAttributesInMtrrSettings (
   IN     CONST MTRR_MEMORY_RANGE *Ranges,
   IN     UINTN                   RangeCount
   );
+
+/**
+  Initialize an empty batch of memory attribute settings.
+
+  @param[out] Batch          The batch to initialize.
+  @param[in]  Ranges         The buffer holding the ranges of the batch.
+  @param[in]  MaxRangeCount  The count of MTRR_MEMORY_RANGE in Ranges.
+
+  @retval RETURN_SUCCESS            The batch is initialized.
+  @retval RETURN_INVALID_PARAMETER  Batch or Ranges is NULL, or MaxRangeCount is zero.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrBatchInitialize (
+  OUT MTRR_BATCH             *Batch,
+  IN  MTRR_MEMORY_RANGE      *Ranges,
+  IN  UINTN                  MaxRangeCount
+  );
+
+/**
+  Add the attribute setting of a memory range to a batch.
+
+  Nothing is calculated or programmed until MtrrBatchCommit() is called.
+  When ranges overlap, the range added last takes higher priority.
+
+  @param[in, out]  Batch        The batch to add the range to.
+  @param[in]       BaseAddress  The physical address that is the start address
+                                of a memory range.
+  @param[in]       Length       The size in bytes of the memory range.
+  @param[in]       Attribute    The bit mask of attributes to set for the
+                                memory range.
+
+  @retval RETURN_SUCCESS            The range is added to the batch.
+  @retval RETURN_INVALID_PARAMETER  Batch is NULL.
+  @retval RETURN_INVALID_PARAMETER  Length is zero.
+  @retval RETURN_BUFFER_TOO_SMALL   The batch is full. The caller may commit the
+                                    batch and add the range again.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrBatchAddRange (
+  IN OUT MTRR_BATCH          *Batch,
+  IN PHYSICAL_ADDRESS        BaseAddress,
+  IN UINT64                  Length,
+  IN MTRR_MEMORY_CACHE_TYPE  Attribute
+  );
+
+/**
+  Apply all the memory attribute settings of a batch with one MTRR calculation.
+
+  When MtrrSetting is NULL, the MTRRs of the calling processor are programmed
+  in one pass. Otherwise the MTRR setting buffer is updated, and the caller
+  can program all the processors with one MtrrSetAllMtrrs() on each of them.
+  The batch is emptied when the settings are applied, and is left untouched
+  on failure, in which case none of the settings is applied.
+
+  @param[in, out]  Batch        The batch to commit.
+  @param[in, out]  MtrrSetting  MTRR setting buffer to be set, or NULL to
+                                program the MTRRs.
+
+  @retval RETURN_SUCCESS            The attributes were set for all the memory ranges.
+  @retval RETURN_INVALID_PARAMETER  Batch is NULL.
+  @retval RETURN_INVALID_PARAMETER  Length in any range is zero.
+  @retval RETURN_UNSUPPORTED        The processor does not support one or more bytes of the
+                                    memory resource range specified by BaseAddress and Length in any range.
+  @retval RETURN_UNSUPPORTED        The bit mask of attributes is not support for the memory resource
+                                    range specified by BaseAddress and Length in any range.
+  @retval RETURN_OUT_OF_RESOURCES   There are not enough system resources to modify the attributes of
+                                    the memory resource ranges.
+  @retval RETURN_ACCESS_DENIED      The attributes for the memory resource range specified by
+                                    BaseAddress and Length cannot be modified.
+  @retval RETURN_BUFFER_TOO_SMALL   The fixed internal scratch buffer is too small for MTRR calculation.
+                                    Caller should use MtrrSetMemoryAttributesInMtrrSettings() to specify
+                                    external scratch buffer.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrBatchCommit (
+  IN OUT MTRR_BATCH          *Batch,
+  IN OUT MTRR_SETTINGS       *MtrrSetting OPTIONAL
+  );
 #endif // _MTRR_LIB_H_
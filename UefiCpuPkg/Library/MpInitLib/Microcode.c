@@ -33,13 +33,23 @@ GetCurrentMicrocodeSignature (
 }
 
 /**
-  Detect whether specified processor can find matching microcode patch and load it.
+  Search the microcode patch region for the latest microcode patch that
+  matches the specified processor signature and platform ID.
 
-  @param[in]  CpuMpData  The pointer to CPU MP Data structure.
+  @param[in]  CpuMpData           The pointer to CPU MP Data structure.
+  @param[in]  ProcessorSignature  The processor signature from CPUID leaf 1.
+  @param[in]  PlatformId          The platform ID from MSR IA32_PLATFORM_ID.
+  @param[out] LatestRevision      The update revision of the patch found,
+                                  or 0 if no patch matches.
+
+  @return  The pointer to the microcode data of the patch found, or NULL.
 **/
-VOID
-MicrocodeDetect (
-  IN CPU_MP_DATA             *CpuMpData
+VOID *
+FindMicrocodePatch (
+  IN  CPU_MP_DATA            *CpuMpData,
+  IN  UINT32                 ProcessorSignature,
+  IN  UINT8                  PlatformId,
+  OUT UINT32                 *LatestRevision
   )
 {
   UINT32                                  ExtendedTableLength;
@@ -49,45 +59,13 @@ MicrocodeDetect (
   CPU_MICROCODE_HEADER                    *MicrocodeEntryPoint;
   UINTN                                   MicrocodeEnd;
   UINTN                                   Index;
-  UINT8                                   PlatformId;
-  CPUID_VERSION_INFO_EAX                  Eax;
-  UINT32                                  CurrentRevision;
-  UINT32                                  LatestRevision;
   UINTN                                   TotalSize;
   UINT32                                  CheckSum32;
   BOOLEAN                                 CorrectMicrocode;
   VOID                                    *MicrocodeData;
-  MSR_IA32_PLATFORM_ID_REGISTER           PlatformIdMsr;
-
-  if (CpuMpData->MicrocodePatchRegionSize == 0) {
-    //
-    // There is no microcode patches
-    //
-    return;
-  }
-
-  CurrentRevision = GetCurrentMicrocodeSignature ();
-  if (CurrentRevision != 0) {
-    //
-    // Skip loading microcode if it has been loaded successfully
-    //
-    return;
-  }
 
   ExtendedTableLength = 0;
-  //
-  // Here data of CPUID leafs have not been collected into context buffer, so
-  // GetProcessorCpuid() cannot be used here to retrieve sCPUID data.
-  //
-  AsmCpuid (CPUID_VERSION_INFO, &Eax.Uint32, NULL, NULL, NULL);
-
-  //
-  // The index of platform information resides in bits 50:52 of MSR IA32_PLATFORM_ID
-  //
-  PlatformIdMsr.Uint64 = AsmReadMsr64 (MSR_IA32_PLATFORM_ID);
-  PlatformId = (UINT8) PlatformIdMsr.Bits.PlatformId;
-
-  LatestRevision = 0;
+  *LatestRevision = 0;
   MicrocodeData  = NULL;
   MicrocodeEnd = (UINTN) (CpuMpData->MicrocodePatchAddress + CpuMpData->MicrocodePatchRegionSize);
   MicrocodeEntryPoint = (CPU_MICROCODE_HEADER *) (UINTN) CpuMpData->MicrocodePatchAddress;
@@ -103,8 +81,8 @@ MicrocodeDetect (
       // because the padding data should not include 0x00000001 and it should be the repeated
       // byte format (like 0xXYXYXYXY....).
       //
-      if (MicrocodeEntryPoint->ProcessorSignature.Uint32 == Eax.Uint32 &&
-          MicrocodeEntryPoint->UpdateRevision > LatestRevision &&
+      if (MicrocodeEntryPoint->ProcessorSignature.Uint32 == ProcessorSignature &&
+          MicrocodeEntryPoint->UpdateRevision > *LatestRevision &&
           (MicrocodeEntryPoint->ProcessorFlags & (1 << PlatformId))
           ) {
         if (MicrocodeEntryPoint->DataSize == 0) {
@@ -119,7 +97,7 @@ MicrocodeDetect (
           CorrectMicrocode = TRUE;
         }
       } else if ((MicrocodeEntryPoint->DataSize != 0) &&
-                 (MicrocodeEntryPoint->UpdateRevision > LatestRevision)) {
+                 (MicrocodeEntryPoint->UpdateRevision > *LatestRevision)) {
         ExtendedTableLength = MicrocodeEntryPoint->TotalSize - (MicrocodeEntryPoint->DataSize +
                                 sizeof (CPU_MICROCODE_HEADER));
         if (ExtendedTableLength != 0) {
@@ -145,7 +123,7 @@ MicrocodeDetect (
                   //
                   // Verify Header
                   //
-                  if ((ExtendedTable->ProcessorSignature.Uint32 == Eax.Uint32) &&
+                  if ((ExtendedTable->ProcessorSignature.Uint32 == ProcessorSignature) &&
                       (ExtendedTable->ProcessorFlag & (1 << PlatformId)) ) {
                     //
                     // Find one
@@ -181,29 +159,176 @@ MicrocodeDetect (
     }
 
     if (CorrectMicrocode) {
-      LatestRevision = MicrocodeEntryPoint->UpdateRevision;
+      *LatestRevision = MicrocodeEntryPoint->UpdateRevision;
       MicrocodeData = (VOID *) ((UINTN) MicrocodeEntryPoint + sizeof (CPU_MICROCODE_HEADER));
     }
 
     MicrocodeEntryPoint = (CPU_MICROCODE_HEADER *) (((UINTN) MicrocodeEntryPoint) + TotalSize);
   } while (((UINTN) MicrocodeEntryPoint < MicrocodeEnd));
 
-  if (LatestRevision > CurrentRevision) {
+
+  return MicrocodeData;
+}
+
+/**
+  Get the latest microcode patch that matches the specified processor
+  signature and platform ID.
+
+  The microcode patch region is searched only once for each processor
+  signature and platform ID. The result is cached in CPU MP Data and shared
+  by all the processors, the processors asking for a signature that is being
+  searched by another processor wait for its result.
+
+  @param[in]  CpuMpData           The pointer to CPU MP Data structure.
+  @param[in]  ProcessorSignature  The processor signature from CPUID leaf 1.
+  @param[in]  PlatformId          The platform ID from MSR IA32_PLATFORM_ID.
+  @param[out] LatestRevision      The update revision of the patch found,
+                                  or 0 if no patch matches.
+
+  @return  The pointer to the microcode data of the patch found, or NULL.
+**/
+VOID *
+GetMicrocodePatch (
+  IN  CPU_MP_DATA            *CpuMpData,
+  IN  UINT32                 ProcessorSignature,
+  IN  UINT8                  PlatformId,
+  OUT UINT32                 *LatestRevision
+  )
+{
+  UINTN                                   Index;
+  MICROCODE_PATCH_CACHE_ENTRY             *Entry;
+  BOOLEAN                                 Claimed;
+
+  Entry   = NULL;
+  Claimed = FALSE;
+  AcquireSpinLock(&CpuMpData->MpLock);
+  for (Index = 0; Index < MICROCODE_PATCH_CACHE_SIZE; Index++) {
+    Entry = &CpuMpData->MicrocodePatchCache[Index];
+    if (Entry->State == MicrocodePatchCacheFree) {
+      //
+      // No processor has searched for this signature yet, claim the entry.
+      //
+      Entry->ProcessorSignature = ProcessorSignature;
+      Entry->PlatformId         = PlatformId;
+      Entry->State              = MicrocodePatchCacheScanning;
+      Claimed = TRUE;
+      break;
+    }
+    if (Entry->ProcessorSignature == ProcessorSignature && Entry->PlatformId == PlatformId) {
+      break;
+    }
+  }
+  ReleaseSpinLock(&CpuMpData->MpLock);
+
+  if (Index == MICROCODE_PATCH_CACHE_SIZE) {
+    //
+    // The cache is full, search the patch region directly.
+    //
+    return FindMicrocodePatch (CpuMpData, ProcessorSignature, PlatformId, LatestRevision);
+  }
+
+  if (Claimed) {
+    Entry->MicrocodeData = FindMicrocodePatch (
+                             CpuMpData,
+                             ProcessorSignature,
+                             PlatformId,
+                             &Entry->LatestRevision
+                             );
     //
-    // BIOS only authenticate updates that contain a numerically larger revision
-    // than the currently loaded revision, where Current Signature < New Update
-    // Revision. A processor with no loaded update is considered to have a
-    // revision equal to zero.
+    // Publish the result after it is completely written.
     //
-    ASSERT (MicrocodeData != NULL);
-    AsmWriteMsr64 (
-        MSR_IA32_BIOS_UPDT_TRIG,
-        (UINT64) (UINTN) MicrocodeData
-        );
+    MemoryFence ();
+    Entry->State = MicrocodePatchCacheReady;
+  } else {
+    while (Entry->State != MicrocodePatchCacheReady) {
+      CpuPause ();
+    }
+  }
+
+  *LatestRevision = Entry->LatestRevision;
+  return Entry->MicrocodeData;
+}
+
+/**
+  Detect whether specified processor can find matching microcode patch and load it.
+
+  The patch lookup is shared by the processors with the same signature, see
+  GetMicrocodePatch(). Processors of different cores load the patch
+  concurrently, the threads of one core take turns, so that they never load
+  the same patch at the same time.
+
+  @param[in]  CpuMpData  The pointer to CPU MP Data structure.
+**/
+VOID
+MicrocodeDetect (
+  IN CPU_MP_DATA             *CpuMpData
+  )
+{
+  UINT8                                   PlatformId;
+  CPUID_VERSION_INFO_EAX                  Eax;
+  UINT32                                  CurrentRevision;
+  UINT32                                  LatestRevision;
+  VOID                                    *MicrocodeData;
+  MSR_IA32_PLATFORM_ID_REGISTER           PlatformIdMsr;
+  UINT32                                  Package;
+  UINT32                                  Core;
+  SPIN_LOCK                               *MicrocodeLoadLock;
+
+  if (CpuMpData->MicrocodePatchRegionSize == 0) {
     //
-    // Get and check new microcode signature
+    // There is no microcode patches
+    //
+    return;
+  }
+
+  CurrentRevision = GetCurrentMicrocodeSignature ();
+  if (CurrentRevision != 0) {
+    //
+    // Skip loading microcode if it has been loaded successfully
+    //
+    return;
+  }
+
+  //
+  // Here data of CPUID leafs have not been collected into context buffer, so
+  // GetProcessorCpuid() cannot be used here to retrieve sCPUID data.
+  //
+  AsmCpuid (CPUID_VERSION_INFO, &Eax.Uint32, NULL, NULL, NULL);
+
+  //
+  // The index of platform information resides in bits 50:52 of MSR IA32_PLATFORM_ID
+  //
+  PlatformIdMsr.Uint64 = AsmReadMsr64 (MSR_IA32_PLATFORM_ID);
+  PlatformId = (UINT8) PlatformIdMsr.Bits.PlatformId;
+
+  MicrocodeData = GetMicrocodePatch (CpuMpData, Eax.Uint32, PlatformId, &LatestRevision);
+
+  if (LatestRevision > CurrentRevision) {
+    GetProcessorLocationByApicId (GetInitialApicId (), &Package, &Core, NULL);
+    MicrocodeLoadLock = &CpuMpData->MicrocodeLoadLock[(Core * 8 + Package) % MICROCODE_LOAD_LOCK_COUNT];
+    AcquireSpinLock (MicrocodeLoadLock);
+    //
+    // Another thread of the same core may have loaded the patch meanwhile.
     //
     CurrentRevision = GetCurrentMicrocodeSignature ();
+    if (LatestRevision > CurrentRevision) {
+      //
+      // BIOS only authenticate updates that contain a numerically larger revision
+      // than the currently loaded revision, where Current Signature < New Update
+      // Revision. A processor with no loaded update is considered to have a
+      // revision equal to zero.
+      //
+      ASSERT (MicrocodeData != NULL);
+      AsmWriteMsr64 (
+          MSR_IA32_BIOS_UPDT_TRIG,
+          (UINT64) (UINTN) MicrocodeData
+          );
+      //
+      // Get and check new microcode signature
+      //
+      CurrentRevision = GetCurrentMicrocodeSignature ();
+    }
+    ReleaseSpinLock (MicrocodeLoadLock);
     if (CurrentRevision != LatestRevision) {
       AcquireSpinLock(&CpuMpData->MpLock);
       DEBUG ((EFI_D_ERROR, "Updated microcode signature [0x%08x] does not match \
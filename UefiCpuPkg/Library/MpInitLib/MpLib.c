@@ -1549,6 +1549,9 @@ MpInitLibInitialize (
   CpuMpData->MicrocodePatchAddress    = PcdGet64 (PcdCpuMicrocodePatchAddress);
   CpuMpData->MicrocodePatchRegionSize = PcdGet64 (PcdCpuMicrocodePatchRegionSize);
   InitializeSpinLock(&CpuMpData->MpLock);
+  for (Index = 0; Index < MICROCODE_LOAD_LOCK_COUNT; Index++) {
+    InitializeSpinLock(&CpuMpData->MicrocodeLoadLock[Index]);
+  }
   //
   // Save BSP's Control registers to APs
   //
@@ -2285,6 +2288,333 @@ StartupThisAPWorker (
   return Status;
 }
 
+/**
+  Push a task at the bottom of the task deque of the calling processor.
+
+  @param[in, out] Deque   The task deque owned by the calling processor.
+  @param[in]      Task    The task to push.
+
+  @retval TRUE    The task has been pushed.
+  @retval FALSE   The task deque is full.
+**/
+BOOLEAN
+PushTask (
+  IN OUT MP_TASK_DEQUE         *Deque,
+  IN     MP_TASK               *Task
+  )
+{
+  UINT32                  Bottom;
+
+  Bottom = Deque->Bottom;
+  if (Bottom - Deque->Top >= MP_TASK_DEQUE_SIZE) {
+    return FALSE;
+  }
+  CopyMem (&Deque->Tasks[Bottom % MP_TASK_DEQUE_SIZE], Task, sizeof (MP_TASK));
+  //
+  // Make the task visible before the new bottom.
+  //
+  MemoryFence ();
+  Deque->Bottom = Bottom + 1;
+  return TRUE;
+}
+
+/**
+  Pop a task from the bottom of the task deque of the calling processor.
+
+  @param[in, out] Deque   The task deque owned by the calling processor.
+  @param[out]     Task    The task popped.
+
+  @retval TRUE    A task has been popped.
+  @retval FALSE   The task deque is empty, or its last task has been stolen.
+**/
+BOOLEAN
+PopTask (
+  IN OUT MP_TASK_DEQUE         *Deque,
+  OUT    MP_TASK               *Task
+  )
+{
+  UINT32                  Bottom;
+  UINT32                  Top;
+  BOOLEAN                 Success;
+
+  Bottom = Deque->Bottom - 1;
+  //
+  // Only the owner changes Bottom, so the exchange always succeeds. The locked
+  // instruction orders the store of Bottom before the load of Top below.
+  //
+  InterlockedCompareExchange32 ((UINT32 *) &Deque->Bottom, Bottom + 1, Bottom);
+  Top = Deque->Top;
+  if ((INT32) (Bottom - Top) < 0) {
+    Deque->Bottom = Top;
+    return FALSE;
+  }
+
+  CopyMem (Task, &Deque->Tasks[Bottom % MP_TASK_DEQUE_SIZE], sizeof (MP_TASK));
+  if (Bottom != Top) {
+    return TRUE;
+  }
+
+  //
+  // This is the last task, race with the stealing processors for it.
+  //
+  Success = (BOOLEAN) (InterlockedCompareExchange32 ((UINT32 *) &Deque->Top, Top, Top + 1) == Top);
+  Deque->Bottom = Top + 1;
+  return Success;
+}
+
+/**
+  Steal a task from the top of the task deque of another processor.
+
+  @param[in, out] Deque   The task deque owned by another processor.
+  @param[out]     Task    The task stolen.
+
+  @retval TRUE    A task has been stolen.
+  @retval FALSE   The task deque is empty, or the task was taken by another
+                  processor.
+**/
+BOOLEAN
+StealTask (
+  IN OUT MP_TASK_DEQUE         *Deque,
+  OUT    MP_TASK               *Task
+  )
+{
+  UINT32                  Bottom;
+  UINT32                  Top;
+
+  Top = Deque->Top;
+  MemoryFence ();
+  Bottom = Deque->Bottom;
+  if ((INT32) (Bottom - Top) <= 0) {
+    return FALSE;
+  }
+
+  CopyMem (Task, &Deque->Tasks[Top % MP_TASK_DEQUE_SIZE], sizeof (MP_TASK));
+  return (BOOLEAN) (InterlockedCompareExchange32 ((UINT32 *) &Deque->Top, Top, Top + 1) == Top);
+}
+
+/**
+  Run the tasks of a MpInitLibParallelFor() call on the calling processor
+  until all the tasks are done.
+
+  A task larger than the grain is split in halves, the upper halves are pushed
+  to the task deque of the calling processor where idle processors can steal
+  them. When its own deque is empty, the processor steals from the others.
+
+  @param[in] Queue            The shared state of the MpInitLibParallelFor() call.
+  @param[in] ProcessorNumber  The handle number of the calling processor.
+**/
+VOID
+RunTasks (
+  IN MP_TASK_QUEUE             *Queue,
+  IN UINTN                     ProcessorNumber
+  )
+{
+  CPU_MP_DATA             *CpuMpData;
+  MP_TASK_DEQUE           *Deque;
+  MP_TASK                 Task;
+  MP_TASK                 UpperHalf;
+  UINTN                   Victim;
+  UINTN                   Index;
+
+  CpuMpData = Queue->CpuMpData;
+  Deque     = &CpuMpData->TaskDeques[ProcessorNumber];
+  Victim    = ProcessorNumber;
+
+  while (Queue->PendingTasks != 0) {
+    if (!PopTask (Deque, &Task)) {
+      Victim = (Victim + 1) % CpuMpData->CpuCount;
+      if (Victim == ProcessorNumber ||
+          !StealTask (&CpuMpData->TaskDeques[Victim], &Task)) {
+        CpuPause ();
+        continue;
+      }
+    }
+
+    while (Task.End - Task.Start > Queue->Grain) {
+      UpperHalf.Start = Task.Start + (Task.End - Task.Start) / 2;
+      UpperHalf.End   = Task.End;
+      InterlockedIncrement ((UINT32 *) &Queue->PendingTasks);
+      if (!PushTask (Deque, &UpperHalf)) {
+        //
+        // The deque is full, run the whole task here.
+        //
+        InterlockedDecrement ((UINT32 *) &Queue->PendingTasks);
+        break;
+      }
+      Task.End = UpperHalf.Start;
+    }
+
+    for (Index = Task.Start; Index < Task.End; Index++) {
+      Queue->Procedure (Queue->Context, Index);
+    }
+    InterlockedDecrement ((UINT32 *) &Queue->PendingTasks);
+  }
+}
+
+/**
+  AP procedure of MpInitLibParallelFor() to take part in running the tasks.
+
+  @param[in, out] Buffer  Pointer to the MP_TASK_QUEUE of the call.
+**/
+VOID
+EFIAPI
+ApTaskWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  MP_TASK_QUEUE           *Queue;
+  UINTN                   ProcessorNumber;
+
+  Queue = (MP_TASK_QUEUE *) Buffer;
+  if (!EFI_ERROR (GetProcessorNumber (Queue->CpuMpData, &ProcessorNumber))) {
+    RunTasks (Queue, ProcessorNumber);
+  }
+}
+
+/**
+  Worker function to run a caller-provided procedure once for each index from
+  0 to Count - 1 on all the enabled processors.
+
+  The indexes are split into tasks that are kept in per-processor work-stealing
+  deques. The BSP takes part in running the tasks, and the function returns as
+  soon as the last task completes. If the APs are busy or not present, all the
+  tasks are run on the BSP.
+
+  @param[in]  Procedure               A pointer to the function to be run for
+                                      each index.
+  @param[in]  Count                   The number of indexes.
+  @param[in]  Grain                   The number of consecutive indexes run as
+                                      one task, 0 to let the function choose.
+  @param[in]  Context                 The context passed to Procedure.
+
+  @retval EFI_SUCCESS             All the indexes have been run.
+  @retval others                  Failed to run the indexes.
+
+**/
+EFI_STATUS
+ParallelForWorker (
+  IN  MP_TASK_PROCEDURE        Procedure,
+  IN  UINTN                    Count,
+  IN  UINTN                    Grain,
+  IN  VOID                     *Context                OPTIONAL
+  )
+{
+  CPU_MP_DATA             *CpuMpData;
+  MP_TASK_QUEUE           Queue;
+  MP_TASK                 Task;
+  UINTN                   CallerNumber;
+  UINTN                   ProcessorNumber;
+  CPU_AP_DATA             *CpuData;
+  BOOLEAN                 ApsReady;
+  CPU_STATE               ApState;
+  UINTN                   Index;
+  EFI_STATUS              Status;
+
+  if (Procedure == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CpuMpData = GetCpuMpData ();
+
+  //
+  // Check whether caller processor is BSP
+  //
+  MpInitLibWhoAmI (&CallerNumber);
+  if (CallerNumber != CpuMpData->BspNumber) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The APs take part only if they are all idle, as in StartupAllAPsWorker().
+  //
+  CheckAndUpdateApsStatus ();
+  ApsReady = (BOOLEAN) (CpuMpData->CpuCount > 1);
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    if (ProcessorNumber != CpuMpData->BspNumber) {
+      ApState = GetApState (&CpuMpData->CpuData[ProcessorNumber]);
+      if (ApState != CpuStateIdle && ApState != CpuStateDisabled) {
+        ApsReady = FALSE;
+      }
+    }
+  }
+
+  if (ApsReady && CpuMpData->TaskDeques == NULL) {
+    CpuMpData->TaskDeques = AllocatePool (sizeof (MP_TASK_DEQUE) * CpuMpData->CpuCount);
+    if (CpuMpData->TaskDeques == NULL) {
+      ApsReady = FALSE;
+    }
+  }
+
+  if (!ApsReady) {
+    for (Index = 0; Index < Count; Index++) {
+      Procedure (Context, Index);
+    }
+    return EFI_SUCCESS;
+  }
+
+  if (Grain == 0) {
+    Grain = Count / (CpuMpData->CpuCount * 8);
+    if (Grain == 0) {
+      Grain = 1;
+    }
+  }
+
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    CpuMpData->TaskDeques[ProcessorNumber].Top    = 0;
+    CpuMpData->TaskDeques[ProcessorNumber].Bottom = 0;
+  }
+
+  Queue.CpuMpData    = CpuMpData;
+  Queue.Procedure    = Procedure;
+  Queue.Context      = Context;
+  Queue.Grain        = Grain;
+  Queue.PendingTasks = 1;
+  Task.Start         = 0;
+  Task.End           = Count;
+  PushTask (&CpuMpData->TaskDeques[CallerNumber], &Task);
+
+  //
+  // Start the APs as a blocking StartupAllAPs() would do, but let the BSP run
+  // tasks instead of polling until the APs finish.
+  //
+  CpuMpData->StartCount = 0;
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    CpuData = &CpuMpData->CpuData[ProcessorNumber];
+    CpuData->Waiting = FALSE;
+    if (ProcessorNumber != CpuMpData->BspNumber && CpuData->State == CpuStateIdle) {
+      CpuData->Waiting = TRUE;
+      CpuMpData->StartCount++;
+    }
+  }
+
+  CpuMpData->Procedure     = ApTaskWorker;
+  CpuMpData->ProcArguments = &Queue;
+  CpuMpData->SingleThread  = FALSE;
+  CpuMpData->FinishedCount = 0;
+  CpuMpData->RunningCount  = 0;
+  CpuMpData->FailedCpuList = NULL;
+  CpuMpData->ExpectedTime  = CalculateTimeout (0, &CpuMpData->CurrentTime);
+  CpuMpData->TotalTime     = 0;
+  CpuMpData->WaitEvent     = NULL;
+
+  WakeUpAP (CpuMpData, TRUE, 0, ApTaskWorker, &Queue);
+
+  RunTasks (&Queue, CallerNumber);
+
+  //
+  // All the tasks are done, the APs return from ApTaskWorker() right away.
+  //
+  do {
+    Status = CheckAllAPs ();
+  } while (Status == EFI_NOT_READY);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Get pointer to CPU MP Data structure from GUIDed HOB.
 
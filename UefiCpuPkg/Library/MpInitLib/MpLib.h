@@ -191,6 +191,77 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Number of processor signature/platform ID pairs whose microcode patch
+// lookup result is cached.
+//
+#define MICROCODE_PATCH_CACHE_SIZE     8
+
+//
+// Number of locks used to serialize microcode loading by the threads of a
+// core. The lock of a core is selected by its package and core ID, cores
+// sharing a lock only wait for each other.
+//
+#define MICROCODE_LOAD_LOCK_COUNT      64
+
+//
+// Microcode patch cache entry states
+//
+typedef enum {
+  MicrocodePatchCacheFree,
+  MicrocodePatchCacheScanning,
+  MicrocodePatchCacheReady
+} MICROCODE_PATCH_CACHE_STATE;
+
+//
+// Result of the microcode patch lookup for one processor signature and
+// platform ID, shared by all the processors with the same signature.
+//
+typedef struct {
+  volatile UINT32                State;
+  UINT32                         ProcessorSignature;
+  UINT32                         PlatformId;
+  UINT32                         LatestRevision;
+  VOID                           *MicrocodeData;
+} MICROCODE_PATCH_CACHE_ENTRY;
+
+//
+// Number of tasks a processor's task deque can hold, must be a power of 2.
+//
+#define MP_TASK_DEQUE_SIZE             64
+
+//
+// Task of MpInitLibParallelFor(): the indexes from Start to End - 1.
+//
+typedef struct {
+  UINTN                          Start;
+  UINTN                          End;
+} MP_TASK;
+
+//
+// Per-processor work-stealing task deque. The owner processor pushes and pops
+// tasks at Bottom, the other processors steal tasks at Top.
+//
+typedef struct {
+  volatile UINT32                Top;
+  volatile UINT32                Bottom;
+  MP_TASK                        Tasks[MP_TASK_DEQUE_SIZE];
+} MP_TASK_DEQUE;
+
+//
+// Shared state of one MpInitLibParallelFor() call.
+//
+typedef struct {
+  CPU_MP_DATA                    *CpuMpData;
+  MP_TASK_PROCEDURE              Procedure;
+  VOID                           *Context;
+  UINTN                          Grain;
+  //
+  // Number of tasks pushed or running, the call is done when it drops to 0.
+  //
+  volatile UINT32                PendingTasks;
+} MP_TASK_QUEUE;
+
 //
 // CPU MP Data save in memory
 //
@@ -245,6 +316,9 @@ struct _CPU_MP_DATA {
   BOOLEAN                        TimerInterruptState;
   UINT64                         MicrocodePatchAddress;
   UINT64                         MicrocodePatchRegionSize;
+  MICROCODE_PATCH_CACHE_ENTRY    MicrocodePatchCache[MICROCODE_PATCH_CACHE_SIZE];
+  SPIN_LOCK                      MicrocodeLoadLock[MICROCODE_LOAD_LOCK_COUNT];
+  MP_TASK_DEQUE                  *TaskDeques;
 };
 
 extern EFI_GUID mCpuInitMpLibHobGuid;
@@ -381,6 +455,29 @@ InitMpGlobalData (
   IN CPU_MP_DATA               *CpuMpData
   );
 
+/**
+  Worker function to run a caller-provided procedure once for each index from
+  0 to Count - 1 on all the enabled processors.
+
+  @param[in]  Procedure               A pointer to the function to be run for
+                                      each index.
+  @param[in]  Count                   The number of indexes.
+  @param[in]  Grain                   The number of consecutive indexes run as
+                                      one task, 0 to let the function choose.
+  @param[in]  Context                 The context passed to Procedure.
+
+  @retval EFI_SUCCESS             All the indexes have been run.
+  @retval others                  Failed to run the indexes.
+
+**/
+EFI_STATUS
+ParallelForWorker (
+  IN  MP_TASK_PROCEDURE        Procedure,
+  IN  UINTN                    Count,
+  IN  UINTN                    Grain,
+  IN  VOID                     *Context                OPTIONAL
+  );
+
 /**
   Worker function to execute a caller provided function on all enabled APs.
 
@@ -506,4 +506,38 @@ MpInitLibEnableDisableAP (
   return EnableDisableApWorker (ProcessorNumber, EnableAP, HealthFlag);
 }
 
+/**
+  This service runs a caller-provided procedure once for each index from 0 to
+  Count - 1 on all the enabled processors. This service may only be called
+  from the BSP.
+
+  The indexes are split into tasks that are kept in per-processor work-stealing
+  deques. The BSP takes part in running the tasks, and the service returns as
+  soon as the last task completes. If the APs are busy or not present, all the
+  tasks are run on the BSP.
+
+  @param[in]  Procedure               A pointer to the function to be run for
+                                      each index. It may be run on any processor
+                                      and must follow the same rules as
+                                      EFI_AP_PROCEDURE.
+  @param[in]  Count                   The number of indexes.
+  @param[in]  Grain                   The number of consecutive indexes run as
+                                      one task, 0 to let the service choose.
+  @param[in]  Context                 The context passed to Procedure.
+
+  @retval EFI_SUCCESS             All the indexes have been run.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_INVALID_PARAMETER   Procedure is NULL.
 
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibParallelFor (
+  IN  MP_TASK_PROCEDURE        Procedure,
+  IN  UINTN                    Count,
+  IN  UINTN                    Grain,
+  IN  VOID                     *Context                OPTIONAL
+  )
+{
+  return ParallelForWorker (Procedure, Count, Grain, Context);
+}
@@ -2586,6 +2586,156 @@ MtrrSetMemoryAttribute (
   return MtrrSetMemoryAttributeInMtrrSettings (NULL, BaseAddress, Length, Attribute);
 }
 
+/**
+  Initialize an empty batch of memory attribute settings.
+
+  @param[out] Batch          The batch to initialize.
+  @param[in]  Ranges         The buffer holding the ranges of the batch.
+  @param[in]  MaxRangeCount  The count of MTRR_MEMORY_RANGE in Ranges.
+
+  @retval RETURN_SUCCESS            The batch is initialized.
+  @retval RETURN_INVALID_PARAMETER  Batch or Ranges is NULL, or MaxRangeCount is zero.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrBatchInitialize (
+  OUT MTRR_BATCH             *Batch,
+  IN  MTRR_MEMORY_RANGE      *Ranges,
+  IN  UINTN                  MaxRangeCount
+  )
+{
+  if ((Batch == NULL) || (Ranges == NULL) || (MaxRangeCount == 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Batch->Ranges        = Ranges;
+  Batch->RangeCount    = 0;
+  Batch->MaxRangeCount = MaxRangeCount;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Add the attribute setting of a memory range to a batch.
+
+  Nothing is calculated or programmed until MtrrBatchCommit() is called.
+  When ranges overlap, the range added last takes higher priority.
+
+  @param[in, out]  Batch        The batch to add the range to.
+  @param[in]       BaseAddress  The physical address that is the start address
+                                of a memory range.
+  @param[in]       Length       The size in bytes of the memory range.
+  @param[in]       Attribute    The bit mask of attributes to set for the
+                                memory range.
+
+  @retval RETURN_SUCCESS            The range is added to the batch.
+  @retval RETURN_INVALID_PARAMETER  Batch is NULL.
+  @retval RETURN_INVALID_PARAMETER  Length is zero.
+  @retval RETURN_BUFFER_TOO_SMALL   The batch is full. The caller may commit the
+                                    batch and add the range again.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrBatchAddRange (
+  IN OUT MTRR_BATCH          *Batch,
+  IN PHYSICAL_ADDRESS        BaseAddress,
+  IN UINT64                  Length,
+  IN MTRR_MEMORY_CACHE_TYPE  Attribute
+  )
+{
+  MTRR_MEMORY_RANGE          *Last;
+
+  if ((Batch == NULL) || (Length == 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Merge with the last range when they are adjacent and of the same type.
+  // Only the last range can be merged because it is the only one that no
+  // later range takes priority over.
+  //
+  if (Batch->RangeCount != 0) {
+    Last = &Batch->Ranges[Batch->RangeCount - 1];
+    if (Last->Type == Attribute) {
+      if (Last->BaseAddress + Last->Length == BaseAddress) {
+        Last->Length += Length;
+        return RETURN_SUCCESS;
+      }
+      if (BaseAddress + Length == Last->BaseAddress) {
+        Last->BaseAddress = BaseAddress;
+        Last->Length     += Length;
+        return RETURN_SUCCESS;
+      }
+    }
+  }
+
+  if (Batch->RangeCount == Batch->MaxRangeCount) {
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+
+  Batch->Ranges[Batch->RangeCount].BaseAddress = BaseAddress;
+  Batch->Ranges[Batch->RangeCount].Length      = Length;
+  Batch->Ranges[Batch->RangeCount].Type        = Attribute;
+  Batch->RangeCount++;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Apply all the memory attribute settings of a batch with one MTRR calculation.
+
+  When MtrrSetting is NULL, the MTRRs of the calling processor are programmed
+  in one pass. Otherwise the MTRR setting buffer is updated, and the caller
+  can program all the processors with one MtrrSetAllMtrrs() on each of them.
+  The batch is emptied when the settings are applied, and is left untouched
+  on failure, in which case none of the settings is applied.
+
+  @param[in, out]  Batch        The batch to commit.
+  @param[in, out]  MtrrSetting  MTRR setting buffer to be set, or NULL to
+                                program the MTRRs.
+
+  @retval RETURN_SUCCESS            The attributes were set for all the memory ranges.
+  @retval RETURN_INVALID_PARAMETER  Batch is NULL.
+  @retval RETURN_INVALID_PARAMETER  Length in any range is zero.
+  @retval RETURN_UNSUPPORTED        The processor does not support one or more bytes of the
+                                    memory resource range specified by BaseAddress and Length in any range.
+  @retval RETURN_UNSUPPORTED        The bit mask of attributes is not support for the memory resource
+                                    range specified by BaseAddress and Length in any range.
+  @retval RETURN_OUT_OF_RESOURCES   There are not enough system resources to modify the attributes of
+                                    the memory resource ranges.
+  @retval RETURN_ACCESS_DENIED      The attributes for the memory resource range specified by
+                                    BaseAddress and Length cannot be modified.
+  @retval RETURN_BUFFER_TOO_SMALL   The fixed internal scratch buffer is too small for MTRR calculation.
+                                    Caller should use MtrrSetMemoryAttributesInMtrrSettings() to specify
+                                    external scratch buffer.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrBatchCommit (
+  IN OUT MTRR_BATCH          *Batch,
+  IN OUT MTRR_SETTINGS       *MtrrSetting OPTIONAL
+  )
+{
+  RETURN_STATUS              Status;
+  UINT8                      Scratch[SCRATCH_BUFFER_SIZE];
+  UINTN                      ScratchSize;
+
+  if (Batch == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Batch->RangeCount == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  ScratchSize = sizeof (Scratch);
+  Status = MtrrSetMemoryAttributesInMtrrSettings (
+             MtrrSetting, Scratch, &ScratchSize, Batch->Ranges, Batch->RangeCount
+             );
+  if (!RETURN_ERROR (Status)) {
+    Batch->RangeCount = 0;
+  }
+  return Status;
+}
+
 /**
   Worker function setting variable MTRRs
 
@@ -301,6 +301,7 @@ SmmCpuUpdate (
   for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
     if (gSmmCpuPrivate->Operation[Index] == SmmCpuAdd) {
       gSmmCpuPrivate->Operation[Index] = SmmCpuNone;
+      mSmmMpSyncData->CpuData[Index].Arrival = GetArrivalSemaphore (Index);
       mNumberOfCpus++;
     }
   }
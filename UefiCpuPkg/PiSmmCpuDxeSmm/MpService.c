@@ -25,6 +25,7 @@ SMM_DISPATCHER_MP_SYNC_DATA                 *mSmmMpSyncData = NULL;
 UINTN                                       mSmmMpSyncDataSize;
 SMM_CPU_SEMAPHORES                          mSmmCpuSemaphores;
 UINTN                                       mSemaphoreSize;
+UINTN                                       mArrivalSemaphoreCount;
 SPIN_LOCK                                   *mPFLock = NULL;
 SMM_CPU_SYNC_MODE                           mCpuSmmSyncMode;
 BOOLEAN                                     mMachineCheckSupported = FALSE;
@@ -115,6 +116,10 @@ LockdownSemaphore (
 /**
   Wait all APs to performs an atomic compare exchange operation to release semaphore.
 
+  APs signal through the arrival semaphore of their package, so only the APs of
+  one package contend on a cache line. The BSP drains each package semaphore in
+  a single compare exchange instead of once per AP.
+
   @param   NumberOfAPs      AP number
 
 **/
@@ -123,11 +128,20 @@ WaitForAllAPs (
   IN      UINTN                     NumberOfAPs
   )
 {
-  UINTN                             BspIndex;
+  UINTN                             Index;
+  volatile UINT32                   *Arrival;
+  UINT32                            Value;
 
-  BspIndex = mSmmMpSyncData->BspIndex;
-  while (NumberOfAPs-- > 0) {
-    WaitForSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  while (NumberOfAPs > 0) {
+    for (Index = 0; Index < mArrivalSemaphoreCount; Index++) {
+      Arrival = (volatile UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Arrival + mSemaphoreSize * Index);
+      Value   = *Arrival;
+      if (Value != 0 &&
+          InterlockedCompareExchange32 ((UINT32 *)Arrival, Value, 0) == Value) {
+        ASSERT (Value <= NumberOfAPs);
+        NumberOfAPs -= Value;
+      }
+    }
   }
 }
 
@@ -371,9 +385,28 @@ BSPHandler (
   UINTN                             ApCount;
   BOOLEAN                           ClearTopLevelSmiResult;
   UINTN                             PresentCount;
+  UINT64                            PhaseStart;
 
   ASSERT (CpuIndex == mSmmMpSyncData->BspIndex);
-  ApCount = 0;
+  ApCount    = 0;
+  PhaseStart = 0;
+
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    PhaseStart = GetPerformanceCounter ();
+  }
+
+  //
+  // Back up the OS MTRRs and only swap in the SMI MTRRs when they differ. The
+  // OS keeps MTRRs consistent across processors, so the BSP's copy stands for
+  // all of them. This must be decided before the BSP's presence is flagged
+  // because APs sample SwapMtrrs as soon as they see InsideSmm set.
+  //
+  mSmmMpSyncData->SwapMtrrs = FALSE;
+  if (SmmCpuFeaturesNeedConfigureMtrrs ()) {
+    ZeroMem (&Mtrrs, sizeof (Mtrrs));
+    MtrrGetAllMtrrs (&Mtrrs);
+    mSmmMpSyncData->SwapMtrrs = (BOOLEAN)(CompareMem (&Mtrrs, &gSmiMtrrs, sizeof (Mtrrs)) != 0);
+  }
 
   //
   // Flag BSP's presence
@@ -404,9 +437,9 @@ BSPHandler (
   gSmmCpuPrivate->SmmCoreEntryContext.CurrentlyExecutingCpu = CpuIndex;
 
   //
-  // If Traditional Sync Mode or need to configure MTRRs: gather all available APs.
+  // If Traditional Sync Mode or need to swap MTRRs: gather all available APs.
   //
-  if (SyncMode == SmmCpuSyncModeTradition || SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (SyncMode == SmmCpuSyncModeTradition || mSmmMpSyncData->SwapMtrrs) {
 
     //
     // Wait for APs to arrive
@@ -423,45 +456,49 @@ BSPHandler (
     // Wait for all APs to get ready for programming MTRRs
     //
     WaitForAllAPs (ApCount);
+  }
 
-    if (SmmCpuFeaturesNeedConfigureMtrrs()) {
-      //
-      // Signal all APs it's time for backup MTRRs
-      //
-      ReleaseAllAPs ();
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    SmmProfileRecordSmiPhase (SmmProfileSmiPhaseArrival, &PhaseStart);
+  }
 
-      //
-      // WaitForSemaphore() may wait for ever if an AP happens to enter SMM at
-      // exactly this point. Please make sure PcdCpuSmmMaxSyncLoops has been set
-      // to a large enough value to avoid this situation.
-      // Note: For HT capable CPUs, threads within a core share the same set of MTRRs.
-      // We do the backup first and then set MTRR to avoid race condition for threads
-      // in the same core.
-      //
-      MtrrGetAllMtrrs(&Mtrrs);
+  if (mSmmMpSyncData->SwapMtrrs) {
+    //
+    // Signal all APs it's time for backup MTRRs
+    //
+    ReleaseAllAPs ();
 
-      //
-      // Wait for all APs to complete their MTRR saving
-      //
-      WaitForAllAPs (ApCount);
+    //
+    // WaitForSemaphore() may wait for ever if an AP happens to enter SMM at
+    // exactly this point. Please make sure PcdCpuSmmMaxSyncLoops has been set
+    // to a large enough value to avoid this situation.
+    // Note: For HT capable CPUs, threads within a core share the same set of MTRRs.
+    // We do the backup first and then set MTRR to avoid race condition for threads
+    // in the same core. The BSP has backed up its MTRRs on entry, so it only
+    // waits for all APs to complete their MTRR saving.
+    //
+    WaitForAllAPs (ApCount);
 
-      //
-      // Let all processors program SMM MTRRs together
-      //
-      ReleaseAllAPs ();
+    //
+    // Let all processors program SMM MTRRs together
+    //
+    ReleaseAllAPs ();
 
-      //
-      // WaitForSemaphore() may wait for ever if an AP happens to enter SMM at
-      // exactly this point. Please make sure PcdCpuSmmMaxSyncLoops has been set
-      // to a large enough value to avoid this situation.
-      //
-      ReplaceOSMtrrs (CpuIndex);
+    //
+    // WaitForSemaphore() may wait for ever if an AP happens to enter SMM at
+    // exactly this point. Please make sure PcdCpuSmmMaxSyncLoops has been set
+    // to a large enough value to avoid this situation.
+    //
+    ReplaceOSMtrrs (CpuIndex);
 
-      //
-      // Wait for all APs to complete their MTRR programming
-      //
-      WaitForAllAPs (ApCount);
-    }
+    //
+    // Wait for all APs to complete their MTRR programming
+    //
+    WaitForAllAPs (ApCount);
+  }
+
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    SmmProfileRecordSmiPhase (SmmProfileSmiPhaseMtrr, &PhaseStart);
   }
 
   //
@@ -494,12 +531,16 @@ BSPHandler (
   //
   PerformRemainingTasks ();
 
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    SmmProfileRecordSmiPhase (SmmProfileSmiPhaseDispatch, &PhaseStart);
+  }
+
   //
-  // If Relaxed-AP Sync Mode: gather all available APs after BSP SMM handlers are done, and
-  // make those APs to exit SMI synchronously. APs which arrive later will be excluded and
-  // will run through freely.
+  // If Relaxed-AP Sync Mode and no MTRR swap: gather all available APs after BSP SMM
+  // handlers are done, and make those APs to exit SMI synchronously. APs which arrive
+  // later will be excluded and will run through freely.
   //
-  if (SyncMode != SmmCpuSyncModeTradition && !SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (SyncMode != SmmCpuSyncModeTradition && !mSmmMpSyncData->SwapMtrrs) {
 
     //
     // Lock the counter down and retrieve the number of APs
@@ -533,7 +574,7 @@ BSPHandler (
   //
   WaitForAllAPs (ApCount);
 
-  if (SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (mSmmMpSyncData->SwapMtrrs) {
     //
     // Signal APs to restore MTRRs
     //
@@ -578,6 +619,10 @@ BSPHandler (
   //
   WaitForAllAPs (ApCount);
 
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    SmmProfileRecordSmiPhase (SmmProfileSmiPhaseExit, &PhaseStart);
+  }
+
   //
   // Reset BspIndex to -1, meaning BSP has not been elected.
   //
@@ -674,14 +719,14 @@ APHandler (
   //
   *(mSmmMpSyncData->CpuData[CpuIndex].Present) = TRUE;
 
-  if (SyncMode == SmmCpuSyncModeTradition || SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (SyncMode == SmmCpuSyncModeTradition || mSmmMpSyncData->SwapMtrrs) {
     //
     // Notify BSP of arrival at this point
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Arrival);
   }
 
-  if (SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (mSmmMpSyncData->SwapMtrrs) {
     //
     // Wait for the signal from BSP to backup MTRRs
     //
@@ -695,7 +740,7 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Arrival);
 
     //
     // Wait for BSP's signal to program MTRRs
@@ -710,7 +755,7 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Arrival);
   }
 
   while (TRUE) {
@@ -746,11 +791,11 @@ APHandler (
     ReleaseSpinLock (mSmmMpSyncData->CpuData[CpuIndex].Busy);
   }
 
-  if (SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (mSmmMpSyncData->SwapMtrrs) {
     //
     // Notify BSP the readiness of this AP to program MTRRs
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Arrival);
 
     //
     // Wait for the signal from BSP to program MTRRs
@@ -767,7 +812,7 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to Reset states/semaphore for this processor
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Arrival);
 
   //
   // Wait for the signal from BSP to Reset states/semaphore for this processor
@@ -782,7 +827,7 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to exit SMM
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Arrival);
 
 }
 
@@ -1277,15 +1322,31 @@ InitializeSmmCpuSemaphores (
   UINTN                      Pages;
   UINTN                      *SemaphoreBlock;
   UINTN                      SemaphoreAddr;
+  UINTN                      Index;
 
   SemaphoreSize   = GetSpinLockProperties ();
   ProcessorCount = gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
+
+  //
+  // One arrival semaphore per package. Room for one per processor is reserved
+  // in the per-processor semaphores, so the count is capped by ProcessorCount.
+  //
+  mArrivalSemaphoreCount = 1;
+  for (Index = 0; Index < ProcessorCount; Index++) {
+    if (gSmmCpuPrivate->ProcessorInfo[Index].ProcessorId != INVALID_APIC_ID &&
+        gSmmCpuPrivate->ProcessorInfo[Index].Location.Package >= mArrivalSemaphoreCount) {
+      mArrivalSemaphoreCount = gSmmCpuPrivate->ProcessorInfo[Index].Location.Package + 1;
+    }
+  }
+  mArrivalSemaphoreCount = MIN (mArrivalSemaphoreCount, ProcessorCount);
+
   GlobalSemaphoresSize = (sizeof (SMM_CPU_SEMAPHORE_GLOBAL) / sizeof (VOID *)) * SemaphoreSize;
   CpuSemaphoresSize    = (sizeof (SMM_CPU_SEMAPHORE_CPU) / sizeof (VOID *)) * ProcessorCount * SemaphoreSize;
   MsrSemahporeSize     = MSR_SPIN_LOCK_INIT_NUM * SemaphoreSize;
   TotalSize = GlobalSemaphoresSize + CpuSemaphoresSize + MsrSemahporeSize;
   DEBUG((EFI_D_INFO, "One Semaphore Size    = 0x%x\n", SemaphoreSize));
   DEBUG((EFI_D_INFO, "Total Semaphores Size = 0x%x\n", TotalSize));
+  DEBUG((EFI_D_INFO, "Arrival Semaphores    = 0x%x\n", mArrivalSemaphoreCount));
   Pages = EFI_SIZE_TO_PAGES (TotalSize);
   SemaphoreBlock = AllocatePages (Pages);
   ASSERT (SemaphoreBlock != NULL);
@@ -1312,6 +1373,8 @@ InitializeSmmCpuSemaphores (
   mSmmCpuSemaphores.SemaphoreCpu.Run     = (UINT32 *)SemaphoreAddr;
   SemaphoreAddr += ProcessorCount * SemaphoreSize;
   mSmmCpuSemaphores.SemaphoreCpu.Present = (BOOLEAN *)SemaphoreAddr;
+  SemaphoreAddr += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Arrival = (UINT32 *)SemaphoreAddr;
 
   SemaphoreAddr = (UINTN)SemaphoreBlock + GlobalSemaphoresSize + CpuSemaphoresSize;
   mSmmCpuSemaphores.SemaphoreMsr.Msr              = (SPIN_LOCK *)SemaphoreAddr;
@@ -1370,13 +1433,34 @@ InitializeMpSyncData (
         (UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Run + mSemaphoreSize * CpuIndex);
       mSmmMpSyncData->CpuData[CpuIndex].Present =
         (BOOLEAN *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Present + mSemaphoreSize * CpuIndex);
+      mSmmMpSyncData->CpuData[CpuIndex].Arrival = GetArrivalSemaphore (CpuIndex);
       *(mSmmMpSyncData->CpuData[CpuIndex].Busy)    = 0;
       *(mSmmMpSyncData->CpuData[CpuIndex].Run)     = 0;
       *(mSmmMpSyncData->CpuData[CpuIndex].Present) = FALSE;
+      *(mSmmMpSyncData->CpuData[CpuIndex].Arrival) = 0;
     }
   }
 }
 
+/**
+  Get the arrival semaphore of the package a processor belongs to.
+
+  @param  CpuIndex  The index of the processor.
+
+  @return The arrival semaphore the processor signals the BSP through.
+
+**/
+volatile UINT32 *
+GetArrivalSemaphore (
+  IN UINTN  CpuIndex
+  )
+{
+  UINTN                      Slot;
+
+  Slot = gSmmCpuPrivate->ProcessorInfo[CpuIndex].Location.Package % mArrivalSemaphoreCount;
+  return (volatile UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Arrival + mSemaphoreSize * Slot);
+}
+
 /**
   Initialize global data for MP synchronization.
 
@@ -331,6 +331,11 @@ typedef struct {
   volatile VOID                     *Parameter;
   volatile UINT32                   *Run;
   volatile BOOLEAN                  *Present;
+  //
+  // Arrival semaphore shared by all processors in the same package. APs
+  // signal the BSP through it instead of the BSP's own Run semaphore.
+  //
+  volatile UINT32                   *Arrival;
 } SMM_CPU_DATA_BLOCK;
 
 typedef enum {
@@ -352,6 +357,11 @@ typedef struct {
   volatile SMM_CPU_SYNC_MODE    EffectiveSyncMode;
   volatile BOOLEAN              SwitchBsp;
   volatile BOOLEAN              *CandidateBsp;
+  //
+  // Set by the BSP when the OS MTRRs differ from the SMI MTRRs and have to be
+  // replaced for this SMI.
+  //
+  volatile BOOLEAN              SwapMtrrs;
 } SMM_DISPATCHER_MP_SYNC_DATA;
 
 #define MSR_SPIN_LOCK_INIT_NUM 15
@@ -382,6 +392,7 @@ typedef struct {
   SPIN_LOCK                         *Busy;
   volatile UINT32                   *Run;
   volatile BOOLEAN                  *Present;
+  volatile UINT32                   *Arrival;
 } SMM_CPU_SEMAPHORE_CPU;
 
 ///
@@ -415,6 +426,7 @@ extern EFI_SMM_CPU_SERVICE_PROTOCOL        mSmmCpuService;
 extern IA32_DESCRIPTOR                     gcSmiInitGdtr;
 extern SMM_CPU_SEMAPHORES                  mSmmCpuSemaphores;
 extern UINTN                               mSemaphoreSize;
+extern UINTN                               mArrivalSemaphoreCount;
 extern SPIN_LOCK                           *mPFLock;
 extern SPIN_LOCK                           *mConfigSmmCodeAccessCheckLock;
 extern SPIN_LOCK                           *mMemoryMappedLock;
@@ -484,6 +496,19 @@ IsSyncTimerTimeout (
   IN      UINT64                    Timer
   );
 
+/**
+  Get the number of performance counter ticks elapsed since a timer started.
+
+  @param Timer  The start timer from the begin.
+
+  @return The elapsed ticks, with one roll-over of the counter handled.
+
+**/
+UINT64
+GetSyncTimerElapsed (
+  IN      UINT64                    Timer
+  );
+
 /**
   Initialize IDT for SMM Stack Guard.
 
@@ -651,6 +676,19 @@ InitializeMpSyncData (
   VOID
   );
 
+/**
+  Get the arrival semaphore of the package a processor belongs to.
+
+  @param  CpuIndex  The index of the processor.
+
+  @return The arrival semaphore the processor signals the BSP through.
+
+**/
+volatile UINT32 *
+GetArrivalSemaphore (
+  IN UINTN  CpuIndex
+  );
+
 /**
 
   Find out SMRAM information including SMRR base and SMRR size.
@@ -928,6 +928,7 @@ InitSmmProfileInternal (
   mSmmProfileBase->TsegSize       = mCpuHotPlugData.SmrrSize;
   mSmmProfileBase->NumSmis        = 0;
   mSmmProfileBase->NumCpus        = gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
+  mSmmProfileBase->TimerFrequency = GetPerformanceCounterProperties (NULL, NULL);
 
   if (mBtsSupported) {
     mMsrDsArea = (MSR_DS_AREA_STRUCT **)AllocateZeroPool (sizeof (MSR_DS_AREA_STRUCT *) * mMaxNumberOfCpus);
@@ -1119,6 +1120,35 @@ SmmProfileRecordSmiNum (
   }
 }
 
+/**
+  Account the time spent in one phase of the current SMI.
+
+  @param[in]      Phase       The SMI phase that just completed.
+  @param[in, out] PhaseStart  On input, the performance counter value when the
+                              phase started. On output, the current performance
+                              counter value, which starts the next phase.
+
+**/
+VOID
+SmmProfileRecordSmiPhase (
+  IN     SMM_PROFILE_SMI_PHASE  Phase,
+  IN OUT UINT64                 *PhaseStart
+  )
+{
+  UINT64  Ticks;
+
+  ASSERT (Phase < SmmProfileSmiPhaseMax);
+
+  Ticks       = GetSyncTimerElapsed (*PhaseStart);
+  *PhaseStart = GetPerformanceCounter ();
+  if (mSmmProfileStart) {
+    mSmmProfileBase->SmiPhaseTicks[Phase] += Ticks;
+    if (Ticks > mSmmProfileBase->SmiPhaseMaxTicks[Phase]) {
+      mSmmProfileBase->SmiPhaseMaxTicks[Phase] = Ticks;
+    }
+  }
+}
+
 /**
   Initialize processor environment for SMM profile.
 
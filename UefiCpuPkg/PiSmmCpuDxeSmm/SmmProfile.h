@@ -52,6 +52,21 @@ SmmProfileRecordSmiNum (
   VOID
   );
 
+/**
+  Account the time spent in one phase of the current SMI.
+
+  @param[in]      Phase       The SMI phase that just completed.
+  @param[in, out] PhaseStart  On input, the performance counter value when the
+                              phase started. On output, the current performance
+                              counter value, which starts the next phase.
+
+**/
+VOID
+SmmProfileRecordSmiPhase (
+  IN     SMM_PROFILE_SMI_PHASE  Phase,
+  IN OUT UINT64                 *PhaseStart
+  );
+
 /**
   The Page fault handler to save SMM profile data.
 
@@ -75,6 +75,17 @@ typedef struct {
   BOOLEAN        Nx;
 } MEMORY_PROTECTION_RANGE;
 
+//
+// Phases of an SMI timed by the BSP when SMM profile is enabled
+//
+typedef enum {
+  SmmProfileSmiPhaseArrival,
+  SmmProfileSmiPhaseMtrr,
+  SmmProfileSmiPhaseDispatch,
+  SmmProfileSmiPhaseExit,
+  SmmProfileSmiPhaseMax
+} SMM_PROFILE_SMI_PHASE;
+
 typedef struct {
   UINT64  HeaderSize;
   UINT64  MaxDataEntries;
@@ -85,6 +96,9 @@ typedef struct {
   UINT64  TsegSize;
   UINT64  NumSmis;
   UINT64  NumCpus;
+  UINT64  TimerFrequency;
+  UINT64  SmiPhaseTicks[SmmProfileSmiPhaseMax];
+  UINT64  SmiPhaseMaxTicks[SmmProfileSmiPhaseMax];
 } SMM_PROFILE_HEADER;
 
 typedef struct {
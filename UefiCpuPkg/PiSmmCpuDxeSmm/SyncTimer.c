@@ -66,14 +66,15 @@ StartSyncTimer (
 
 
 /**
-  Check if the SMM AP Sync timer is timeout.
+  Get the number of performance counter ticks elapsed since a timer started.
 
   @param Timer  The start timer from the begin.
 
+  @return The elapsed ticks, with one roll-over of the counter handled.
+
 **/
-BOOLEAN
-EFIAPI
-IsSyncTimerTimeout (
+UINT64
+GetSyncTimerElapsed (
   IN      UINT64                    Timer
   )
 {
@@ -112,5 +113,20 @@ IsSyncTimerTimeout (
     }
   }
 
-  return (BOOLEAN) (Delta >= mTimeoutTicker);
+  return Delta;
+}
+
+/**
+  Check if the SMM AP Sync timer is timeout.
+
+  @param Timer  The start timer from the begin.
+
+**/
+BOOLEAN
+EFIAPI
+IsSyncTimerTimeout (
+  IN      UINT64                    Timer
+  )
+{
+  return (BOOLEAN) (GetSyncTimerElapsed (Timer) >= mTimeoutTicker);
 }